@@ -0,0 +1,173 @@
+//
+//Copyright (C) 2015 LunarG, Inc.
+//
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions
+//are met:
+//
+//    Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//    Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//    Neither the name of 3Dlabs Inc. Ltd. nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+//INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//POSSIBILITY OF SUCH DAMAGE.
+//
+
+// this only applies to the standalone wrapper, not the front end in general
+#define _CRT_SECURE_NO_WARNINGS
+
+//
+// Build-time generator of the built-in symbol tables for the glslang library.
+//
+// Sets up the built-ins of every version/profile, as glslang::SaveBuiltins()
+// writes them, and writes the snapshot out as a C++ source file defining the
+// objects declared in glslang's BuiltInImage.h.  Compiled into the library,
+// that snapshot is loaded by InitializeProcess(), so no built-in declarations,
+// including the lazily parsed texturing and imaging prototypes, get generated,
+// scanned, or parsed at run time.
+//
+// The snapshot only loads into the same build of glslang that wrote it, which
+// the build ensures by linking this against the same objects, without a
+// snapshot of their own.
+//
+// Usage:  glslangBuiltInImageGen <output.cpp>
+//
+
+#include "./../glslang/Public/ShaderLang.h"
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+const struct {
+    int version;
+    EProfile profile;
+} BuiltInVersions[] = {
+    { 100, ENoProfile },
+    { 110, ENoProfile },
+    { 120, ENoProfile },
+    { 130, ENoProfile },
+    { 140, ENoProfile },
+    { 150, ECoreProfile },
+    { 150, ECompatibilityProfile },
+    { 300, EEsProfile },
+    { 310, EEsProfile },
+    { 330, ECoreProfile },
+    { 330, ECompatibilityProfile },
+    { 400, ECoreProfile },
+    { 400, ECompatibilityProfile },
+    { 410, ECoreProfile },
+    { 410, ECompatibilityProfile },
+    { 420, ECoreProfile },
+    { 420, ECompatibilityProfile },
+    { 430, ECoreProfile },
+    { 430, ECompatibilityProfile },
+    { 440, ECoreProfile },
+    { 440, ECompatibilityProfile },
+    { 450, ECoreProfile },
+    { 450, ECompatibilityProfile },
+};
+
+bool ReadFile(const char* fileName, std::vector<char>& contents)
+{
+    FILE* file = fopen(fileName, "rb");
+    if (file == 0)
+        return false;
+
+    char buffer[64 * 1024];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        contents.insert(contents.end(), buffer, buffer + count);
+    bool success = ferror(file) == 0;
+    fclose(file);
+
+    return success;
+}
+
+//
+// Write the image as 64-bit words, rather than bytes:  it keeps the image
+// aligned, and compilers get through a few megabytes of it much faster.  The
+// words are written in this machine's byte order, like the image itself.
+//
+bool WriteSource(const char* fileName, std::vector<char>& image)
+{
+    FILE* file = fopen(fileName, "w");
+    if (file == 0)
+        return false;
+
+    size_t size = image.size();
+    image.resize((size + 7) / 8 * 8, 0);
+
+    fprintf(file, "// Generated by glslangBuiltInImageGen; do not edit.\n\n");
+    fprintf(file, "#include \"BuiltInImage.h\"\n\n");
+    fprintf(file, "const unsigned long long GeneratedBuiltInImage[] = {\n");
+    for (size_t offset = 0; offset < image.size(); offset += 8) {
+        unsigned long long word;
+        memcpy(&word, &image[offset], 8);
+        fprintf(file, "0x%llxull,%s", word, offset % 32 == 24 ? "\n" : "");
+    }
+    if (image.empty())
+        fprintf(file, "0");
+    fprintf(file, "\n};\n\n");
+    fprintf(file, "const size_t GeneratedBuiltInImageSize = %lu;\n", (unsigned long)size);
+
+    return fclose(file) == 0;
+}
+
+} // end anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2) {
+        printf("Usage: glslangBuiltInImageGen <output.cpp>\n");
+        return 1;
+    }
+
+    std::vector<int> versions;
+    std::vector<EProfile> profiles;
+    for (size_t v = 0; v < sizeof(BuiltInVersions) / sizeof(BuiltInVersions[0]); ++v) {
+        versions.push_back(BuiltInVersions[v].version);
+        profiles.push_back(BuiltInVersions[v].profile);
+    }
+
+    std::string imageFileName = std::string(argv[1]) + ".bin";
+    glslang::InitializeProcess();
+    bool saved = glslang::SaveBuiltins(imageFileName.c_str(), &versions[0], &profiles[0], (int)versions.size());
+    glslang::FinalizeProcess();
+
+    std::vector<char> image;
+    if (! saved || ! ReadFile(imageFileName.c_str(), image)) {
+        printf("glslangBuiltInImageGen: unable to save the built-ins\n");
+        return 1;
+    }
+    remove(imageFileName.c_str());
+
+    if (! WriteSource(argv[1], image)) {
+        printf("glslangBuiltInImageGen: unable to write %s\n", argv[1]);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,581 @@
+//
+//Copyright (C) 2015 LunarG, Inc.
+//
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions
+//are met:
+//
+//    Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//    Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//    Neither the name of 3Dlabs Inc. Ltd. nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+//INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//POSSIBILITY OF SUCH DAMAGE.
+//
+
+//
+// Implement the content-addressed compile cache in CompileCache.h.
+//
+
+#include "CompileCache.h"
+#include "../SPIRV/GlslangToSpv.h"
+#include "osinclude.h"
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+    #define NOMINMAX
+    #include <windows.h>
+    #include <direct.h>
+    #include <process.h>
+    #include <sys/utime.h>
+    #include <errno.h>
+#else
+    #include <sys/stat.h>
+    #include <sys/types.h>
+    #include <dirent.h>
+    #include <unistd.h>
+    #include <utime.h>
+    #include <errno.h>
+#endif
+
+namespace glslang {
+
+namespace {
+
+// Bump when the entry layout or anything else about what gets keyed changes.
+const int CacheFormatVersion = 2;
+const unsigned int CacheMagic = 0x43534c47;  // "GLSC"
+const size_t DigestLength = 64;              // hex characters of SHA-256
+
+//
+// SHA-256 round constants (FIPS 180-4).
+//
+const unsigned int RoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+inline unsigned int RotateRight(unsigned int x, int n)
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+struct TCacheFile {
+    std::string name;
+    long long size;
+    long long time;     // last use, in the file system's units
+};
+
+bool operator<(const TCacheFile& left, const TCacheFile& right)
+{
+    return left.time < right.time;
+}
+
+//
+// OS-specific file system access.
+//
+
+#ifdef _WIN32
+
+bool MakeDirectory(const std::string& path)
+{
+    return _mkdir(path.c_str()) == 0 || errno == EEXIST;
+}
+
+bool ListDirectory(const std::string& path, std::vector<TCacheFile>& files)
+{
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA((path + "\\*").c_str(), &data);
+    if (find == INVALID_HANDLE_VALUE)
+        return false;
+
+    do {
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            continue;
+        TCacheFile file;
+        file.name = data.cFileName;
+        file.size = ((long long)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+        file.time = ((long long)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+        files.push_back(file);
+    } while (FindNextFileA(find, &data));
+    FindClose(find);
+
+    return true;
+}
+
+bool MoveIntoPlace(const std::string& from, const std::string& to)
+{
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+}
+
+void TouchFile(const std::string& path)
+{
+    _utime(path.c_str(), nullptr);
+}
+
+int ProcessNumber()
+{
+    return _getpid();
+}
+
+#else
+
+bool MakeDirectory(const std::string& path)
+{
+    return mkdir(path.c_str(), 0777) == 0 || errno == EEXIST;
+}
+
+bool ListDirectory(const std::string& path, std::vector<TCacheFile>& files)
+{
+    DIR* dir = opendir(path.c_str());
+    if (! dir)
+        return false;
+
+    while (dirent* entry = readdir(dir)) {
+        struct stat status;
+        if (stat((path + "/" + entry->d_name).c_str(), &status) != 0 || ! S_ISREG(status.st_mode))
+            continue;
+        TCacheFile file;
+        file.name = entry->d_name;
+        file.size = status.st_size;
+        file.time = status.st_mtime;
+        files.push_back(file);
+    }
+    closedir(dir);
+
+    return true;
+}
+
+bool MoveIntoPlace(const std::string& from, const std::string& to)
+{
+    return rename(from.c_str(), to.c_str()) == 0;
+}
+
+void TouchFile(const std::string& path)
+{
+    utime(path.c_str(), nullptr);
+}
+
+int ProcessNumber()
+{
+    return (int)getpid();
+}
+
+#endif
+
+//
+// Entry serialization.  The file is the magic number, format version, payload
+// size, and hex digest of the payload, followed by the payload.
+//
+
+void PutWord(std::vector<char>& out, unsigned int word)
+{
+    out.insert(out.end(), (const char*)&word, (const char*)&word + sizeof(word));
+}
+
+void PutString(std::vector<char>& out, const std::string& string)
+{
+    PutWord(out, (unsigned int)string.size());
+    out.insert(out.end(), string.begin(), string.end());
+}
+
+class TEntryReader {
+public:
+    TEntryReader(const char* data, size_t size) : data(data), size(size), failed(false) { }
+
+    unsigned int getWord()
+    {
+        unsigned int word = 0;
+        get(&word, sizeof(word));
+
+        return word;
+    }
+
+    void getString(std::string& string)
+    {
+        string.resize(getWord());
+        if (string.size() > 0)
+            get(&string[0], string.size());
+    }
+
+    void get(void* out, size_t count)
+    {
+        if (failed || count > size) {
+            failed = true;
+            return;
+        }
+        memcpy(out, data, count);
+        data += count;
+        size -= count;
+    }
+
+    bool ok() const { return ! failed && size == 0; }
+
+protected:
+    const char* data;
+    size_t size;
+    bool failed;
+};
+
+//
+// Hash of the running executable, which the compiler is linked into, so that
+// any rebuild gives different keys, not just a new version string.  Read a word
+// at a time, as SHA-256 over the whole executable would cost more than a small
+// compile; each step is invertible, so no single changed word can go unseen.
+// Zero if the executable can't be read.
+//
+unsigned long long ExecutableHash()
+{
+    const char* data;
+    size_t size;
+    void* mapping = OS_MapFile(OS_GetExecutablePath().c_str(), data, size);
+    if (mapping == 0)
+        return 0;
+
+    unsigned long long hash = 14695981039346656037ULL ^ size;
+    size_t words = size / sizeof(hash);
+    for (size_t w = 0; w < words; ++w) {
+        unsigned long long word;
+        memcpy(&word, data + w * sizeof(word), sizeof(word));
+        hash = (hash ^ word) * 1099511628211ULL;
+    }
+    for (size_t b = words * sizeof(hash); b < size; ++b)
+        hash = (hash ^ (unsigned char)data[b]) * 1099511628211ULL;
+    OS_UnmapFile(mapping);
+
+    return hash;
+}
+
+} // end anonymous namespace
+
+//
+// TCompileCacheKey is SHA-256.
+//
+
+TCompileCacheKey::TCompileCacheKey() : length(0)
+{
+    static const unsigned int initialState[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+    memcpy(state, initialState, sizeof(state));
+}
+
+void TCompileCacheKey::add(const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    while (size > 0) {
+        size_t used = length % 64;
+        size_t count = std::min(size, 64 - used);
+        memcpy(buffer + used, bytes, count);
+        length += count;
+        bytes += count;
+        size -= count;
+        if (length % 64 == 0)
+            transform(buffer);
+    }
+}
+
+void TCompileCacheKey::addString(const char* string, int size)
+{
+    add(size);
+    add(string, (size_t)size);
+}
+
+std::string TCompileCacheKey::getDigest()
+{
+    unsigned long long bits = length * 8;
+    unsigned char pad = 0x80;
+    add(&pad, 1);
+    pad = 0;
+    while (length % 64 != 56)
+        add(&pad, 1);
+    unsigned char bigEndianBits[8];
+    for (int b = 0; b < 8; ++b)
+        bigEndianBits[b] = (unsigned char)(bits >> (56 - 8 * b));
+    add(bigEndianBits, 8);
+
+    static const char hexDigits[] = "0123456789abcdef";
+    std::string digest;
+    for (int s = 0; s < 8; ++s) {
+        for (int shift = 28; shift >= 0; shift -= 4)
+            digest += hexDigits[(state[s] >> shift) & 0xf];
+    }
+
+    return digest;
+}
+
+void TCompileCacheKey::transform(const unsigned char* block)
+{
+    unsigned int w[64];
+    for (int i = 0; i < 16; ++i)
+        w[i] = (block[4 * i] << 24) | (block[4 * i + 1] << 16) | (block[4 * i + 2] << 8) | block[4 * i + 3];
+    for (int i = 16; i < 64; ++i) {
+        unsigned int s0 = RotateRight(w[i - 15], 7) ^ RotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        unsigned int s1 = RotateRight(w[i - 2], 17) ^ RotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    unsigned int a = state[0], b = state[1], c = state[2], d = state[3];
+    unsigned int e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; ++i) {
+        unsigned int s1 = RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+        unsigned int choice = (e & f) ^ (~e & g);
+        unsigned int temp1 = h + s1 + choice + RoundConstants[i] + w[i];
+        unsigned int s0 = RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+        unsigned int majority = (a & b) ^ (a & c) ^ (b & c);
+        unsigned int temp2 = s0 + majority;
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp1;
+        d = c;
+        c = b;
+        b = a;
+        a = temp1 + temp2;
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+//
+// TCompileCache
+//
+
+TCompileCache::TCompileCache(const std::string& directory, size_t maxBytes) :
+    directory(directory), maxBytes(maxBytes), approximateBytes(0), tempCounter(0)
+{
+}
+
+bool TCompileCache::open()
+{
+    if (! MakeDirectory(directory))
+        return false;
+
+    std::vector<TCacheFile> files;
+    if (! ListDirectory(directory, files))
+        return false;
+
+    size_t total = 0;
+    for (size_t f = 0; f < files.size(); ++f)
+        total += (size_t)files[f].size;
+    approximateBytes = total;
+    if (total > maxBytes)
+        evict();
+
+    return true;
+}
+
+bool TCompileCache::lookup(const std::string& key, TCompileCacheEntry& entry)
+{
+    std::string path = directory + "/" + key;
+    FILE* in = fopen(path.c_str(), "rb");
+    if (! in)
+        return false;
+
+    std::vector<char> contents;
+    char block[16 * 1024];
+    size_t count;
+    while ((count = fread(block, 1, sizeof(block), in)) > 0)
+        contents.insert(contents.end(), block, block + count);
+    fclose(in);
+
+    // check the header, then that the payload is what the writer digested
+    const size_t headerSize = 3 * sizeof(unsigned int) + DigestLength;
+    if (contents.size() < headerSize)
+        return false;
+    TEntryReader header(&contents[0], headerSize);
+    if (header.getWord() != CacheMagic || header.getWord() != (unsigned int)CacheFormatVersion ||
+        header.getWord() != contents.size() - headerSize)
+        return false;
+    std::string digest(DigestLength, '\0');
+    header.get(&digest[0], DigestLength);
+
+    TCompileCacheKey payloadDigest;
+    payloadDigest.add(&contents[headerSize], contents.size() - headerSize);
+    if (payloadDigest.getDigest() != digest)
+        return false;
+
+    TEntryReader payload(&contents[headerSize], contents.size() - headerSize);
+    entry.compiled = payload.getWord() != 0;
+    entry.linked = payload.getWord() != 0;
+    entry.shaderInfoLogs.resize(payload.getWord());
+    entry.shaderDebugLogs.resize(entry.shaderInfoLogs.size());
+    for (size_t s = 0; s < entry.shaderInfoLogs.size(); ++s) {
+        payload.getString(entry.shaderInfoLogs[s]);
+        payload.getString(entry.shaderDebugLogs[s]);
+    }
+    payload.getString(entry.programInfoLog);
+    payload.getString(entry.programDebugLog);
+    payload.getString(entry.reflection);
+    for (int stage = 0; stage < EShLangCount; ++stage) {
+        entry.spirv[stage].resize(payload.getWord());
+        if (entry.spirv[stage].size() > 0)
+            payload.get(&entry.spirv[stage][0], entry.spirv[stage].size() * sizeof(unsigned int));
+    }
+    if (! payload.ok())
+        return false;
+
+    // keeps it from being evicted ahead of entries used less recently
+    TouchFile(path);
+
+    return true;
+}
+
+void TCompileCache::store(const std::string& key, const TCompileCacheEntry& entry)
+{
+    std::vector<char> payload;
+    PutWord(payload, entry.compiled ? 1 : 0);
+    PutWord(payload, entry.linked ? 1 : 0);
+    PutWord(payload, (unsigned int)entry.shaderInfoLogs.size());
+    for (size_t s = 0; s < entry.shaderInfoLogs.size(); ++s) {
+        PutString(payload, entry.shaderInfoLogs[s]);
+        PutString(payload, entry.shaderDebugLogs[s]);
+    }
+    PutString(payload, entry.programInfoLog);
+    PutString(payload, entry.programDebugLog);
+    PutString(payload, entry.reflection);
+    for (int stage = 0; stage < EShLangCount; ++stage) {
+        PutWord(payload, (unsigned int)entry.spirv[stage].size());
+        if (entry.spirv[stage].size() > 0)
+            payload.insert(payload.end(), (const char*)&entry.spirv[stage][0],
+                           (const char*)(&entry.spirv[stage][0] + entry.spirv[stage].size()));
+    }
+
+    TCompileCacheKey payloadDigest;
+    payloadDigest.add(payload.data(), payload.size());
+    std::vector<char> contents;
+    PutWord(contents, CacheMagic);
+    PutWord(contents, (unsigned int)CacheFormatVersion);
+    PutWord(contents, (unsigned int)payload.size());
+    std::string digest = payloadDigest.getDigest();
+    contents.insert(contents.end(), digest.begin(), digest.end());
+    contents.insert(contents.end(), payload.begin(), payload.end());
+
+    // write privately, then publish whole
+    char tempName[64];
+    snprintf(tempName, sizeof(tempName), "/tmp-%d-%u-%u", ProcessNumber(),
+             (unsigned int)std::hash<std::thread::id>()(std::this_thread::get_id()), tempCounter++);
+    std::string tempPath = directory + tempName;
+    FILE* out = fopen(tempPath.c_str(), "wb");
+    if (! out)
+        return;
+    bool written = fwrite(contents.data(), 1, contents.size(), out) == contents.size();
+    written = fclose(out) == 0 && written;
+    if (! written || ! MoveIntoPlace(tempPath, directory + "/" + key)) {
+        remove(tempPath.c_str());
+        return;
+    }
+
+    if ((approximateBytes += contents.size()) > maxBytes)
+        evict();
+}
+
+//
+// Delete least-recently-used entries until the directory is under 3/4 of its
+// limit, so the next eviction isn't right behind this one.  Other processes
+// may be adding entries at the same time, so this works from what is actually
+// on disk rather than from this process's accounting.
+//
+void TCompileCache::evict()
+{
+    std::unique_lock<std::mutex> lock(evictLock, std::try_to_lock);
+    if (! lock.owns_lock())
+        return;
+
+    std::vector<TCacheFile> files;
+    if (! ListDirectory(directory, files))
+        return;
+    size_t total = 0;
+    for (size_t f = 0; f < files.size(); ++f)
+        total += (size_t)files[f].size;
+
+    std::stable_sort(files.begin(), files.end());
+    size_t target = maxBytes / 4 * 3;
+    for (size_t f = 0; f < files.size() && total > target; ++f) {
+        if (remove((directory + "/" + files[f].name).c_str()) == 0)
+            total -= (size_t)files[f].size;
+    }
+
+    approximateBytes = total;
+}
+
+void AddCompilerVersion(TCompileCacheKey& key)
+{
+    // read once per process, on first use
+    static const unsigned long long buildHash = ExecutableHash();
+
+    key.add(CacheFormatVersion);
+    key.add(&buildHash, sizeof(buildHash));
+    key.addString(GetEsslVersionString());
+    key.addString(GetGlslVersionString());
+    std::string spirvVersion;
+    GetSpirvVersion(spirvVersion);
+    key.addString(spirvVersion);
+}
+
+void AddShaderSource(TCompileCacheKey& key, EShLanguage stage, const char* const* strings, const int* lengths,
+                     int numStrings, const char* preamble)
+{
+    key.add((int)stage);
+    key.add(numStrings);
+    for (int s = 0; s < numStrings; ++s)
+        key.addString(strings[s], lengths ? lengths[s] : (int)strlen(strings[s]));
+    key.addString(preamble ? preamble : "");
+}
+
+// TBuiltInResource is all ints up to its limits, which are digested one at a
+// time, so the padding after them (which can come from a client) never is.
+void AddCompileOptions(TCompileCacheKey& key, int defaultVersion, EProfile profile, bool forwardCompatible,
+                       const TBuiltInResource& resources, EShMessages messages, int results)
+{
+    key.add(defaultVersion);
+    key.add((int)profile);
+    key.add(forwardCompatible ? 1 : 0);
+    key.add(&resources, offsetof(TBuiltInResource, limits));
+    const TLimits& limits = resources.limits;
+    key.add(limits.nonInductiveForLoops ? 1 : 0);
+    key.add(limits.whileLoops ? 1 : 0);
+    key.add(limits.doWhileLoops ? 1 : 0);
+    key.add(limits.generalUniformIndexing ? 1 : 0);
+    key.add(limits.generalAttributeMatrixVectorIndexing ? 1 : 0);
+    key.add(limits.generalVaryingIndexing ? 1 : 0);
+    key.add(limits.generalSamplerIndexing ? 1 : 0);
+    key.add(limits.generalVariableIndexing ? 1 : 0);
+    key.add(limits.generalConstantMatrixVectorIndexing ? 1 : 0);
+    key.add((int)messages);
+    key.add(results);
+}
+
+} // end namespace glslang
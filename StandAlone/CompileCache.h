@@ -0,0 +1,146 @@
+//
+//Copyright (C) 2015 LunarG, Inc.
+//
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions
+//are met:
+//
+//    Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//    Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//    Neither the name of 3Dlabs Inc. Ltd. nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+//INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef COMPILECACHE_H_INCLUDED
+#define COMPILECACHE_H_INCLUDED
+
+//
+// Content-addressed on-disk cache of compile results, for glslangValidator --cache.
+//
+// A key is a SHA-256 digest of everything that determines the results: the
+// compiler's version strings, the source strings and preamble, stage, default
+// version and profile, resource limits, EShMessages, and what was asked for
+// (SPIR-V, reflection).  Whatever the key was built from, a hit stands in for
+// the whole parse, link, reflection, and SPIR-V generation.
+//
+// Each entry is a file named by its key, holding its own payload digest, so a
+// torn or corrupted entry reads as a miss.  Entries are written to a temporary
+// file and renamed into place, so concurrent writers (threads or processes)
+// never expose a partial entry; the last one to finish wins, with identical
+// contents.  Once the directory grows past its size limit, the least recently
+// used entries are deleted until it is back under 3/4 of the limit.
+//
+
+#include "./../glslang/Public/ShaderLang.h"
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+namespace glslang {
+
+// Results beyond the logs, which not every compile asks for.
+enum TCompileCacheResults {
+    ECacheResultSpv        = 0x0001,
+    ECacheResultReflection = 0x0002,
+};
+
+//
+// Accumulates the inputs of a compile into a key.
+//
+class TCompileCacheKey {
+public:
+    TCompileCacheKey();
+
+    void add(const void* data, size_t size);
+    void add(int value) { add(&value, sizeof(value)); }
+    void addString(const char* string, int length);  // length-prefixed, so adjacent strings can't run together
+    void addString(const std::string& string) { addString(string.data(), (int)string.size()); }
+
+    // Hex digest of everything added; ends the key.
+    std::string getDigest();
+
+protected:
+    void transform(const unsigned char* block);
+
+    unsigned int state[8];
+    unsigned char buffer[64];
+    unsigned long long length;  // bytes added so far
+};
+
+//
+// The results of compiling and linking a set of shaders into one program.
+//
+struct TCompileCacheEntry {
+    TCompileCacheEntry() : compiled(true), linked(true) { }
+
+    bool compiled;
+    bool linked;
+    std::vector<std::string> shaderInfoLogs;    // for each shader, in the order they were added
+    std::vector<std::string> shaderDebugLogs;
+    std::string programInfoLog;
+    std::string programDebugLog;
+    std::string reflection;                     // as printed by TProgram::dumpReflection(), if asked for
+    std::vector<unsigned int> spirv[EShLangCount];  // per stage, if asked for
+};
+
+class TCompileCache {
+public:
+    TCompileCache(const std::string& directory, size_t maxBytes);
+
+    // Creates the directory if needed; false if it can't be used.
+    bool open();
+
+    // These can be called from any number of threads or processes at once.
+    bool lookup(const std::string& key, TCompileCacheEntry&);
+    void store(const std::string& key, const TCompileCacheEntry&);
+
+protected:
+    void evict();
+
+    std::string directory;
+    size_t maxBytes;
+    std::atomic<size_t> approximateBytes;  // size of the directory, as last seen plus what this process has added
+    std::atomic<unsigned int> tempCounter;
+    std::mutex evictLock;
+};
+
+// Starts a key with the compiler's version and a hash of its build.
+void AddCompilerVersion(TCompileCacheKey&);
+
+// Adds one shader's stage and source, as given to TShader::setStringsWithLengths()
+// and TShader::setPreamble().
+void AddShaderSource(TCompileCacheKey&, EShLanguage, const char* const* strings, const int* lengths, int numStrings,
+                     const char* preamble);
+
+// Adds the remaining arguments of TShader::parse() and TProgram::link(), with
+// which TCompileCacheResults are wanted.
+void AddCompileOptions(TCompileCacheKey&, int defaultVersion, EProfile, bool forwardCompatible,
+                       const TBuiltInResource&, EShMessages, int results);
+
+} // end namespace glslang
+
+#endif // COMPILECACHE_H_INCLUDED
@@ -0,0 +1,374 @@
+//
+//Copyright (C) 2015 LunarG, Inc.
+//
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions
+//are met:
+//
+//    Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//    Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//    Neither the name of 3Dlabs Inc. Ltd. nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+//INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//POSSIBILITY OF SUCH DAMAGE.
+//
+
+//
+// Long-running compile server, for glslangValidator --server.
+//
+// The built-in symbol tables and keyword maps are process-wide, so once a
+// version/profile has been compiled by any request, later requests for it
+// skip all built-in setup.  See CompileServer.h for the protocol.
+//
+
+#include "CompileServer.h"
+#include "CompileCache.h"
+#include "FileIncluder.h"
+#include "./../glslang/Include/ShHandle.h"
+#include "./../glslang/Public/ShaderLang.h"
+#include "../SPIRV/GlslangToSpv.h"
+#include "../OGLCompilersDLL/InitializeDll.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <stdio.h>
+
+#include "osinclude.h"
+
+#ifndef _WIN32
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <sys/stat.h>
+    #include <poll.h>
+    #include <fcntl.h>
+    #include <signal.h>
+    #include <string.h>
+#endif
+
+namespace glslang {
+
+#ifdef _WIN32
+
+bool RunCompileServer(const char*, int, const TBuiltInResource&, TCompileCache*)
+{
+    printf("Compile server mode is not supported on this platform\n");
+
+    return false;
+}
+
+#else
+
+namespace {
+
+int ServerSocket = -1;
+const TBuiltInResource* ServerResources = nullptr;
+TCompileCache* ServerCache = nullptr;
+
+// Connections move between the polling thread, which owns the idle ones, and
+// the compile threads, each of which serves one request on one connection at
+// a time.  A connection is in exactly one of:  the polling thread's idle set,
+// ReadyConnections (a request is waiting to be read), a compile thread, or
+// DoneConnections (the response was sent; waiting to go back to idle).
+std::mutex ConnectionLock;
+std::condition_variable ConnectionReady;
+std::deque<int> ReadyConnections;
+std::vector<int> DoneConnections;
+int WakePipe[2] = { -1, -1 };          // written to make the polling thread look at DoneConnections
+std::atomic<int> LiveThreads(0);
+
+void WakePolling()
+{
+    char byte = 0;
+    while (write(WakePipe[1], &byte, 1) < 0 && errno == EINTR)
+        ;
+}
+
+//
+// Compile and link one request's shader, as a single-shader program.
+//
+void CompileRequest(const TCompileRequestHeader& request, const std::string& name, const std::vector<char>& source,
+                    TCompileCacheEntry& entry)
+{
+    EShLanguage stage = (EShLanguage)request.stage;
+    const TBuiltInResource* resources = (request.flags & ECompileRequestServerResources) ? ServerResources : &request.resources;
+    EShMessages messages = (EShMessages)request.messages;
+
+    const char* strings = source.size() > 0 ? &source[0] : "";
+    int length = (int)source.size();
+
+    std::string key;
+    if (ServerCache) {
+        int results = ((request.flags & ECompileRequestSpv) ? ECacheResultSpv : 0) |
+                      ((request.flags & ECompileRequestReflection) ? ECacheResultReflection : 0);
+        TCompileCacheKey cacheKey;
+        AddCompilerVersion(cacheKey);
+        AddShaderSource(cacheKey, stage, &strings, &length, 1, nullptr);
+        AddCompileOptions(cacheKey, request.defaultVersion, ENoProfile, false, *resources, messages, results);
+        key = cacheKey.getDigest();
+        if (ServerCache->lookup(key, entry))
+            return;
+    }
+
+    // the program has to go before the shader, see CompileAndLinkShaders()
+    TShader shader(stage);
+    TProgram program;
+    TFileIncluder includer(name);
+
+    shader.setStringsWithLengths(&strings, &length, 1);
+    if (name.size() > 0)
+        shader.setIncluder(&includer);
+    entry.compiled = shader.parse(resources, request.defaultVersion, false, messages);
+    entry.shaderInfoLogs.push_back(shader.getInfoLog());
+    entry.shaderDebugLogs.push_back(shader.getInfoDebugLog());
+
+    program.addShader(&shader);
+    entry.linked = program.link(messages);
+    entry.programInfoLog = program.getInfoLog();
+    entry.programDebugLog = program.getInfoDebugLog();
+
+    bool success = entry.compiled && entry.linked;
+    if (success && (request.flags & ECompileRequestSpv))
+        GlslangToSpv(*program.getIntermediate(stage), entry.spirv[stage]);
+
+    if (success && (request.flags & ECompileRequestReflection) && program.buildReflection())
+        program.dumpReflection(entry.reflection);
+
+    // the key doesn't cover included files, or whether an #include could be found
+    if (ServerCache && shader.getNumIncludeDirectives() == 0)
+        ServerCache->store(key, entry);
+}
+
+//
+// Read, compile, and answer the one request waiting on a connection.
+// Returns false if the connection should be closed: the client closed it, or
+// sent a malformed request, or the response couldn't be sent.
+//
+bool ServeRequest(int connection)
+{
+    TCompileRequestHeader request;
+    if (! ReadFully(connection, &request, sizeof(request)))
+        return false;
+    if (request.magic != CompileServerMagic || request.version != CompileServerVersion ||
+        request.stage < 0 || request.stage >= EShLangCount ||
+        request.nameLength > MaxCompileRequestName || request.sourceLength > MaxCompileRequestSource)
+        return false;
+
+    std::string name(request.nameLength, '\0');
+    std::vector<char> source(request.sourceLength);
+    if ((request.nameLength > 0 && ! ReadFully(connection, &name[0], name.size())) ||
+        (request.sourceLength > 0 && ! ReadFully(connection, &source[0], source.size())))
+        return false;
+
+    // Each request leaves its (by then deleted) pool as the thread's pool,
+    // so put back the thread's own after each.
+    TPoolAllocator& threadAllocator = GetThreadPoolAllocator();
+    TCompileCacheEntry entry;
+    CompileRequest(request, name, source, entry);
+    SetThreadPoolAllocator(threadAllocator);
+
+    std::string infoLog;
+    for (size_t s = 0; s < entry.shaderInfoLogs.size(); ++s)
+        infoLog += entry.shaderInfoLogs[s] + entry.shaderDebugLogs[s];
+    infoLog += entry.programInfoLog + entry.programDebugLog;
+    const std::vector<unsigned int>& spirv = entry.spirv[request.stage];
+    const std::string& reflection = entry.reflection;
+    TCompileResponseHeader response;
+    response.magic = CompileServerMagic;
+    response.success = entry.compiled && entry.linked ? 1 : 0;
+    response.infoLogLength = (unsigned int)infoLog.size();
+    response.spirvWords = (unsigned int)spirv.size();
+    response.reflectionLength = (unsigned int)reflection.size();
+
+    return WriteFully(connection, &response, sizeof(response)) &&
+           WriteFully(connection, infoLog.data(), infoLog.size()) &&
+           (spirv.size() == 0 || WriteFully(connection, &spirv[0], spirv.size() * sizeof(unsigned int))) &&
+           WriteFully(connection, reflection.data(), reflection.size());
+}
+
+//
+// Compile thread entry point; each thread serves one request at a time, from
+// whichever connection has one waiting, then hands the connection back to the
+// polling thread to wait for the client's next request.
+//
+unsigned int ServeRequests(void*)
+{
+    if (InitThread()) {
+        for (;;) {
+            int connection;
+            {
+                std::unique_lock<std::mutex> guard(ConnectionLock);
+                while (ReadyConnections.empty())
+                    ConnectionReady.wait(guard);
+                connection = ReadyConnections.front();
+                ReadyConnections.pop_front();
+            }
+
+            if (ServeRequest(connection)) {
+                std::lock_guard<std::mutex> guard(ConnectionLock);
+                DoneConnections.push_back(connection);
+            } else
+                close(connection);
+            WakePolling();
+        }
+    }
+
+    // let the polling thread notice if there is no one left to serve requests
+    --LiveThreads;
+    WakePolling();
+
+    return 0;
+}
+
+//
+// Accept connections, and wait on the idle ones for requests, passing each
+// connection with a request waiting to the compile threads.  Idle connections
+// don't hold a thread, so any number of clients can keep one open.
+// Returns only on failure, false.
+//
+bool PollConnections()
+{
+    std::vector<int> idle;
+    std::vector<pollfd> polled;
+    for (;;) {
+        if (LiveThreads == 0) {
+            printf("No compile threads left to serve requests\n");
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(ConnectionLock);
+            idle.insert(idle.end(), DoneConnections.begin(), DoneConnections.end());
+            DoneConnections.clear();
+        }
+
+        polled.resize(idle.size() + 2);
+        polled[0].fd = ServerSocket;
+        polled[1].fd = WakePipe[0];
+        for (size_t c = 0; c < idle.size(); ++c)
+            polled[c + 2].fd = idle[c];
+        for (size_t p = 0; p < polled.size(); ++p) {
+            polled[p].events = POLLIN;
+            polled[p].revents = 0;
+        }
+
+        if (poll(&polled[0], polled.size(), -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("poll");
+            return false;
+        }
+
+        if (polled[1].revents & POLLIN) {
+            char bytes[64];
+            while (read(WakePipe[0], bytes, sizeof(bytes)) > 0)
+                ;
+        }
+
+        // a closed or failed connection is passed on too, for its thread to close
+        size_t stillIdle = 0;
+        for (size_t c = 0; c < idle.size(); ++c) {
+            if (polled[c + 2].revents != 0) {
+                std::lock_guard<std::mutex> guard(ConnectionLock);
+                ReadyConnections.push_back(idle[c]);
+                ConnectionReady.notify_one();
+            } else
+                idle[stillIdle++] = idle[c];
+        }
+        idle.resize(stillIdle);
+
+        if (polled[0].revents & POLLIN) {
+            int connection = accept(ServerSocket, 0, 0);
+            if (connection >= 0)
+                idle.push_back(connection);
+            else if (errno != EINTR && errno != ECONNABORTED && errno != EAGAIN && errno != EWOULDBLOCK) {
+                perror("accept");
+                return false;
+            }
+        }
+    }
+}
+
+} // end anonymous namespace
+
+bool RunCompileServer(const char* socketPath, int numThreads, const TBuiltInResource& resources, TCompileCache* cache)
+{
+    ServerResources = &resources;
+    ServerCache = cache;
+
+    // The socket is made under a temporary name and renamed into place once it
+    // is listening, so a client that finds it can connect.
+    std::string boundPath = std::string(socketPath) + ".new";
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (boundPath.size() >= sizeof(address.sun_path)) {
+        printf("Socket path is too long: %s\n", socketPath);
+        return false;
+    }
+    strcpy(address.sun_path, boundPath.c_str());
+
+    // a client hanging up early must not take down the server
+    signal(SIGPIPE, SIG_IGN);
+
+    // replace the sockets of an earlier server, but nothing that isn't a socket
+    struct stat status;
+    if (lstat(socketPath, &status) == 0 && ! S_ISSOCK(status.st_mode)) {
+        printf("Not a socket, not replacing it: %s\n", socketPath);
+        return false;
+    }
+    if (lstat(boundPath.c_str(), &status) == 0 && S_ISSOCK(status.st_mode))
+        unlink(boundPath.c_str());
+
+    // Neither the listening socket nor the wake pipe may block the polling
+    // thread; a client can go away between poll() and accept().  Accepted
+    // connections don't inherit this, and the compile threads block on them.
+    ServerSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (ServerSocket < 0 ||
+        fcntl(ServerSocket, F_SETFL, O_NONBLOCK) != 0 ||
+        bind(ServerSocket, (sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(ServerSocket, SOMAXCONN) != 0 ||
+        rename(boundPath.c_str(), socketPath) != 0) {
+        perror(socketPath);
+        return false;
+    }
+    if (pipe(WakePipe) != 0 ||
+        fcntl(WakePipe[0], F_SETFL, O_NONBLOCK) != 0) {
+        perror("pipe");
+        return false;
+    }
+
+    LiveThreads = numThreads;
+    for (int t = 0; t < numThreads; ++t) {
+        if (! OS_CreateThread(&ServeRequests))
+            --LiveThreads;
+    }
+
+    return PollConnections();
+}
+
+#endif
+
+} // end namespace glslang
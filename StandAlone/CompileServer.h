@@ -0,0 +1,151 @@
+//
+//Copyright (C) 2015 LunarG, Inc.
+//
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions
+//are met:
+//
+//    Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//    Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//    Neither the name of 3Dlabs Inc. Ltd. nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+//INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef COMPILESERVER_H_INCLUDED
+#define COMPILESERVER_H_INCLUDED
+
+//
+// Wire protocol between a long-running compile server (glslangValidator --server)
+// and its clients, over a local (Unix domain) stream socket.
+//
+// A client sends any number of requests on one connection, each one answered
+// by one response before the next request is read.  A connection only takes
+// up a compile thread while one of its requests is being served, so clients
+// may keep theirs open between requests:
+//
+//     request:   TCompileRequestHeader, then nameLength bytes of the shader's
+//                absolute path, then sourceLength bytes of shader source
+//     response:  TCompileResponseHeader, then infoLogLength bytes of info log,
+//                spirvWords 32-bit words of SPIR-V, and reflectionLength bytes
+//                of reflection text
+//
+// All fields are in the host's byte order and layout; client and server are
+// expected to be built together and run on the same machine.  The server reads
+// #include files itself, relative to the shader's path; a request without one
+// can't use #include.
+//
+
+#include "./../glslang/Include/ResourceLimits.h"
+
+#include <stddef.h>
+#ifndef _WIN32
+    #include <unistd.h>
+    #include <errno.h>
+#endif
+
+namespace glslang {
+
+const unsigned int CompileServerMagic = 0x6c736c67;   // "glsl"
+const unsigned int CompileServerVersion = 2;
+
+// Longest path and source the server will read; it closes the connection on longer ones.
+const unsigned int MaxCompileRequestName = 4096;
+const unsigned int MaxCompileRequestSource = 64 * 1024 * 1024;
+
+enum TCompileRequestFlags {
+    ECompileRequestSpv             = 0x0001,  // generate SPIR-V
+    ECompileRequestReflection      = 0x0002,  // build and return the reflection database
+    ECompileRequestServerResources = 0x0004,  // ignore 'resources', use the server's configuration
+};
+
+struct TCompileRequestHeader {
+    unsigned int magic;
+    unsigned int version;
+    int stage;                      // EShLanguage
+    int defaultVersion;             // as for TShader::parse()
+    int messages;                   // EShMessages
+    int flags;                      // TCompileRequestFlags
+    TBuiltInResource resources;
+    unsigned int nameLength;
+    unsigned int sourceLength;
+};
+
+struct TCompileResponseHeader {
+    unsigned int magic;
+    int success;                    // non-zero if the shader compiled and linked
+    unsigned int infoLogLength;
+    unsigned int spirvWords;
+    unsigned int reflectionLength;
+};
+
+#ifndef _WIN32
+
+// Transfer exactly 'size' bytes; false if the connection closed or failed first.
+inline bool ReadFully(int socket, void* buffer, size_t size)
+{
+    char* bytes = static_cast<char*>(buffer);
+    while (size > 0) {
+        ssize_t count = read(socket, bytes, size);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            return false;
+        bytes += count;
+        size -= count;
+    }
+
+    return true;
+}
+
+inline bool WriteFully(int socket, const void* buffer, size_t size)
+{
+    const char* bytes = static_cast<const char*>(buffer);
+    while (size > 0) {
+        ssize_t count = write(socket, bytes, size);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            return false;
+        bytes += count;
+        size -= count;
+    }
+
+    return true;
+}
+
+#endif
+
+class TCompileCache;
+
+// Serve compile requests on the given socket path until killed, compiling on
+// 'numThreads' threads and using 'resources' for ECompileRequestServerResources,
+// and looking results up in 'cache' first, if not null.
+// Returns only on failure, false:  to set up the socket, to poll or accept on
+// it, or to keep any compile thread running.
+bool RunCompileServer(const char* socketPath, int numThreads, const TBuiltInResource& resources, TCompileCache* cache);
+
+} // end namespace glslang
+
+#endif // COMPILESERVER_H_INCLUDED
@@ -0,0 +1,91 @@
+//
+//Copyright (C) 2015 LunarG, Inc.
+//
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions
+//are met:
+//
+//    Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//    Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//    Neither the name of 3Dlabs Inc. Ltd. nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+//INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//POSSIBILITY OF SUCH DAMAGE.
+//
+#ifndef FILEINCLUDER_H_INCLUDED
+#define FILEINCLUDER_H_INCLUDED
+
+#include "./../glslang/Public/ShaderLang.h"
+
+#include <string>
+#include <stdio.h>
+
+namespace glslang {
+
+//
+// Resolves #include relative to the directory of the file containing it,
+// which for the shader's own #include is the shader's directory.
+// Used by every glslangValidator mode that compiles through TShader.
+//
+class TFileIncluder : public TShader::Includer {
+public:
+    explicit TFileIncluder(const std::string& shaderName) : directory(DirectoryOf(shaderName)) { }
+
+    virtual bool include(const char* name, const char* includerPath, std::string& path, std::string& contents)
+    {
+        if (name[0] == '/')
+            path = name;
+        else if (includerPath[0] != '\0')
+            path = DirectoryOf(includerPath) + name;
+        else
+            path = directory + name;
+
+        FILE* in = fopen(path.c_str(), "rb");
+        if (! in)
+            return false;
+
+        contents.clear();
+        char buffer[4096];
+        size_t count;
+        while ((count = fread(buffer, 1, sizeof(buffer), in)) > 0)
+            contents.append(buffer, count);
+        fclose(in);
+
+        return true;
+    }
+
+protected:
+    // Everything up to and including the last slash, or "" if there is none.
+    static std::string DirectoryOf(const std::string& fileName)
+    {
+        size_t slash = fileName.find_last_of("/\\");
+
+        return slash == std::string::npos ? std::string() : fileName.substr(0, slash + 1);
+    }
+
+    std::string directory;
+};
+
+} // end namespace glslang
+
+#endif // FILEINCLUDER_H_INCLUDED
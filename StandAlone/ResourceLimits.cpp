@@ -0,0 +1,353 @@
+//
+//Copyright (C) 2002-2005  3Dlabs Inc. Ltd.
+//Copyright (C) 2013 LunarG, Inc.
+//
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions
+//are met:
+//
+//    Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//    Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//    Neither the name of 3Dlabs Inc. Ltd. nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+//INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "ResourceLimits.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace glslang {
+
+//
+// These are the default resources for TBuiltInResources, used for both
+//  - parsing this string for the case where the user didn't supply one
+//  - dumping out a template for user construction of a config file
+//
+const char* const DefaultConfig =
+    "MaxLights 32\n"
+    "MaxClipPlanes 6\n"
+    "MaxTextureUnits 32\n"
+    "MaxTextureCoords 32\n"
+    "MaxVertexAttribs 64\n"
+    "MaxVertexUniformComponents 4096\n"
+    "MaxVaryingFloats 64\n"
+    "MaxVertexTextureImageUnits 32\n"
+    "MaxCombinedTextureImageUnits 80\n"
+    "MaxTextureImageUnits 32\n"
+    "MaxFragmentUniformComponents 4096\n"
+    "MaxDrawBuffers 32\n"
+    "MaxVertexUniformVectors 128\n"
+    "MaxVaryingVectors 8\n"
+    "MaxFragmentUniformVectors 16\n"
+    "MaxVertexOutputVectors 16\n"
+    "MaxFragmentInputVectors 15\n"
+    "MinProgramTexelOffset -8\n"
+    "MaxProgramTexelOffset 7\n"
+    "MaxClipDistances 8\n"
+    "MaxComputeWorkGroupCountX 65535\n"
+    "MaxComputeWorkGroupCountY 65535\n"
+    "MaxComputeWorkGroupCountZ 65535\n"
+    "MaxComputeWorkGroupSizeX 1024\n"
+    "MaxComputeWorkGroupSizeY 1024\n"
+    "MaxComputeWorkGroupSizeZ 64\n"
+    "MaxComputeUniformComponents 1024\n"
+    "MaxComputeTextureImageUnits 16\n"
+    "MaxComputeImageUniforms 8\n"
+    "MaxComputeAtomicCounters 8\n"
+    "MaxComputeAtomicCounterBuffers 1\n"
+    "MaxVaryingComponents 60\n" 
+    "MaxVertexOutputComponents 64\n"
+    "MaxGeometryInputComponents 64\n"
+    "MaxGeometryOutputComponents 128\n"
+    "MaxFragmentInputComponents 128\n"
+    "MaxImageUnits 8\n"
+    "MaxCombinedImageUnitsAndFragmentOutputs 8\n"
+    "MaxCombinedShaderOutputResources 8\n"
+    "MaxImageSamples 0\n"
+    "MaxVertexImageUniforms 0\n"
+    "MaxTessControlImageUniforms 0\n"
+    "MaxTessEvaluationImageUniforms 0\n"
+    "MaxGeometryImageUniforms 0\n"
+    "MaxFragmentImageUniforms 8\n"
+    "MaxCombinedImageUniforms 8\n"
+    "MaxGeometryTextureImageUnits 16\n"
+    "MaxGeometryOutputVertices 256\n"
+    "MaxGeometryTotalOutputComponents 1024\n"
+    "MaxGeometryUniformComponents 1024\n"
+    "MaxGeometryVaryingComponents 64\n"
+    "MaxTessControlInputComponents 128\n"
+    "MaxTessControlOutputComponents 128\n"
+    "MaxTessControlTextureImageUnits 16\n"
+    "MaxTessControlUniformComponents 1024\n"
+    "MaxTessControlTotalOutputComponents 4096\n"
+    "MaxTessEvaluationInputComponents 128\n"
+    "MaxTessEvaluationOutputComponents 128\n"
+    "MaxTessEvaluationTextureImageUnits 16\n"
+    "MaxTessEvaluationUniformComponents 1024\n"
+    "MaxTessPatchComponents 120\n"
+    "MaxPatchVertices 32\n"
+    "MaxTessGenLevel 64\n"
+    "MaxViewports 16\n"
+    "MaxVertexAtomicCounters 0\n"
+    "MaxTessControlAtomicCounters 0\n"
+    "MaxTessEvaluationAtomicCounters 0\n"
+    "MaxGeometryAtomicCounters 0\n"
+    "MaxFragmentAtomicCounters 8\n"
+    "MaxCombinedAtomicCounters 8\n"
+    "MaxAtomicCounterBindings 1\n"
+    "MaxVertexAtomicCounterBuffers 0\n"
+    "MaxTessControlAtomicCounterBuffers 0\n"
+    "MaxTessEvaluationAtomicCounterBuffers 0\n"
+    "MaxGeometryAtomicCounterBuffers 0\n"
+    "MaxFragmentAtomicCounterBuffers 1\n"
+    "MaxCombinedAtomicCounterBuffers 1\n"
+    "MaxAtomicCounterBufferSize 16384\n"
+    "MaxTransformFeedbackBuffers 4\n"
+    "MaxTransformFeedbackInterleavedComponents 64\n"
+    "MaxCullDistances 8\n"
+    "MaxCombinedClipAndCullDistances 8\n"
+    "MaxSamples 4\n"
+
+    "nonInductiveForLoops 1\n"
+    "whileLoops 1\n"
+    "doWhileLoops 1\n"
+    "generalUniformIndexing 1\n"
+    "generalAttributeMatrixVectorIndexing 1\n"
+    "generalVaryingIndexing 1\n"
+    "generalSamplerIndexing 1\n"
+    "generalVariableIndexing 1\n"
+    "generalConstantMatrixVectorIndexing 1\n"
+    ;
+
+//
+// Parse 'config', the contents of a .conf file, into the given resources.
+//
+void DecodeResourceLimits(TBuiltInResource& resources, char* config)
+{
+    const char* delims = " \t\n\r";
+    const char* token = strtok(config, delims);
+    while (token) {
+        const char* valueStr = strtok(0, delims);
+        if (valueStr == 0 || ! (valueStr[0] == '-' || (valueStr[0] >= '0' && valueStr[0] <= '9'))) {
+            printf("Error: '%s' bad .conf file.  Each name must be followed by one number.\n", valueStr ? valueStr : "");
+            return;
+        }
+        int value = atoi(valueStr);
+
+        if (strcmp(token, "MaxLights") == 0)
+            resources.maxLights = value;
+        else if (strcmp(token, "MaxClipPlanes") == 0)
+            resources.maxClipPlanes = value;
+        else if (strcmp(token, "MaxTextureUnits") == 0)
+            resources.maxTextureUnits = value;
+        else if (strcmp(token, "MaxTextureCoords") == 0)
+            resources.maxTextureCoords = value;
+        else if (strcmp(token, "MaxVertexAttribs") == 0)
+            resources.maxVertexAttribs = value;
+        else if (strcmp(token, "MaxVertexUniformComponents") == 0)
+            resources.maxVertexUniformComponents = value;
+        else if (strcmp(token, "MaxVaryingFloats") == 0)
+            resources.maxVaryingFloats = value;
+        else if (strcmp(token, "MaxVertexTextureImageUnits") == 0)
+            resources.maxVertexTextureImageUnits = value;
+        else if (strcmp(token, "MaxCombinedTextureImageUnits") == 0)
+            resources.maxCombinedTextureImageUnits = value;
+        else if (strcmp(token, "MaxTextureImageUnits") == 0)
+            resources.maxTextureImageUnits = value;
+        else if (strcmp(token, "MaxFragmentUniformComponents") == 0)
+            resources.maxFragmentUniformComponents = value;
+        else if (strcmp(token, "MaxDrawBuffers") == 0)
+            resources.maxDrawBuffers = value;
+        else if (strcmp(token, "MaxVertexUniformVectors") == 0)
+            resources.maxVertexUniformVectors = value;
+        else if (strcmp(token, "MaxVaryingVectors") == 0)
+            resources.maxVaryingVectors = value;
+        else if (strcmp(token, "MaxFragmentUniformVectors") == 0)
+            resources.maxFragmentUniformVectors = value;
+        else if (strcmp(token, "MaxVertexOutputVectors") == 0)
+            resources.maxVertexOutputVectors = value;
+        else if (strcmp(token, "MaxFragmentInputVectors") == 0)
+            resources.maxFragmentInputVectors = value;
+        else if (strcmp(token, "MinProgramTexelOffset") == 0)
+            resources.minProgramTexelOffset = value;
+        else if (strcmp(token, "MaxProgramTexelOffset") == 0)
+            resources.maxProgramTexelOffset = value;
+        else if (strcmp(token, "MaxClipDistances") == 0)
+            resources.maxClipDistances = value;
+        else if (strcmp(token, "MaxComputeWorkGroupCountX") == 0)
+            resources.maxComputeWorkGroupCountX = value;
+        else if (strcmp(token, "MaxComputeWorkGroupCountY") == 0)
+            resources.maxComputeWorkGroupCountY = value;
+        else if (strcmp(token, "MaxComputeWorkGroupCountZ") == 0)
+            resources.maxComputeWorkGroupCountZ = value;
+        else if (strcmp(token, "MaxComputeWorkGroupSizeX") == 0)
+            resources.maxComputeWorkGroupSizeX = value;
+        else if (strcmp(token, "MaxComputeWorkGroupSizeY") == 0)
+            resources.maxComputeWorkGroupSizeY = value;
+        else if (strcmp(token, "MaxComputeWorkGroupSizeZ") == 0)
+            resources.maxComputeWorkGroupSizeZ = value;
+        else if (strcmp(token, "MaxComputeUniformComponents") == 0)
+            resources.maxComputeUniformComponents = value;
+        else if (strcmp(token, "MaxComputeTextureImageUnits") == 0)
+            resources.maxComputeTextureImageUnits = value;
+        else if (strcmp(token, "MaxComputeImageUniforms") == 0)
+            resources.maxComputeImageUniforms = value;
+        else if (strcmp(token, "MaxComputeAtomicCounters") == 0)
+            resources.maxComputeAtomicCounters = value;
+        else if (strcmp(token, "MaxComputeAtomicCounterBuffers") == 0)
+            resources.maxComputeAtomicCounterBuffers = value;
+        else if (strcmp(token, "MaxVaryingComponents") == 0)
+            resources.maxVaryingComponents = value;
+        else if (strcmp(token, "MaxVertexOutputComponents") == 0)
+            resources.maxVertexOutputComponents = value;
+        else if (strcmp(token, "MaxGeometryInputComponents") == 0)
+            resources.maxGeometryInputComponents = value;
+        else if (strcmp(token, "MaxGeometryOutputComponents") == 0)
+            resources.maxGeometryOutputComponents = value;
+        else if (strcmp(token, "MaxFragmentInputComponents") == 0)
+            resources.maxFragmentInputComponents = value;
+        else if (strcmp(token, "MaxImageUnits") == 0)
+            resources.maxImageUnits = value;
+        else if (strcmp(token, "MaxCombinedImageUnitsAndFragmentOutputs") == 0)
+            resources.maxCombinedImageUnitsAndFragmentOutputs = value;
+        else if (strcmp(token, "MaxCombinedShaderOutputResources") == 0)
+            resources.maxCombinedShaderOutputResources = value;
+        else if (strcmp(token, "MaxImageSamples") == 0)
+            resources.maxImageSamples = value;
+        else if (strcmp(token, "MaxVertexImageUniforms") == 0)
+            resources.maxVertexImageUniforms = value;
+        else if (strcmp(token, "MaxTessControlImageUniforms") == 0)
+            resources.maxTessControlImageUniforms = value;
+        else if (strcmp(token, "MaxTessEvaluationImageUniforms") == 0)
+            resources.maxTessEvaluationImageUniforms = value;
+        else if (strcmp(token, "MaxGeometryImageUniforms") == 0)
+            resources.maxGeometryImageUniforms = value;
+        else if (strcmp(token, "MaxFragmentImageUniforms") == 0)
+            resources.maxFragmentImageUniforms = value;
+        else if (strcmp(token, "MaxCombinedImageUniforms") == 0)
+            resources.maxCombinedImageUniforms = value;
+        else if (strcmp(token, "MaxGeometryTextureImageUnits") == 0)
+            resources.maxGeometryTextureImageUnits = value;
+        else if (strcmp(token, "MaxGeometryOutputVertices") == 0)
+            resources.maxGeometryOutputVertices = value;
+        else if (strcmp(token, "MaxGeometryTotalOutputComponents") == 0)
+            resources.maxGeometryTotalOutputComponents = value;
+        else if (strcmp(token, "MaxGeometryUniformComponents") == 0)
+            resources.maxGeometryUniformComponents = value;
+        else if (strcmp(token, "MaxGeometryVaryingComponents") == 0)
+            resources.maxGeometryVaryingComponents = value;
+        else if (strcmp(token, "MaxTessControlInputComponents") == 0)
+            resources.maxTessControlInputComponents = value;
+        else if (strcmp(token, "MaxTessControlOutputComponents") == 0)
+            resources.maxTessControlOutputComponents = value;
+        else if (strcmp(token, "MaxTessControlTextureImageUnits") == 0)
+            resources.maxTessControlTextureImageUnits = value;
+        else if (strcmp(token, "MaxTessControlUniformComponents") == 0)
+            resources.maxTessControlUniformComponents = value;
+        else if (strcmp(token, "MaxTessControlTotalOutputComponents") == 0)
+            resources.maxTessControlTotalOutputComponents = value;
+        else if (strcmp(token, "MaxTessEvaluationInputComponents") == 0)
+            resources.maxTessEvaluationInputComponents = value;
+        else if (strcmp(token, "MaxTessEvaluationOutputComponents") == 0)
+            resources.maxTessEvaluationOutputComponents = value;
+        else if (strcmp(token, "MaxTessEvaluationTextureImageUnits") == 0)
+            resources.maxTessEvaluationTextureImageUnits = value;
+        else if (strcmp(token, "MaxTessEvaluationUniformComponents") == 0)
+            resources.maxTessEvaluationUniformComponents = value;
+        else if (strcmp(token, "MaxTessPatchComponents") == 0)
+            resources.maxTessPatchComponents = value;
+        else if (strcmp(token, "MaxPatchVertices") == 0)
+            resources.maxPatchVertices = value;
+        else if (strcmp(token, "MaxTessGenLevel") == 0)
+            resources.maxTessGenLevel = value;
+        else if (strcmp(token, "MaxViewports") == 0)
+            resources.maxViewports = value;
+        else if (strcmp(token, "MaxVertexAtomicCounters") == 0)
+            resources.maxVertexAtomicCounters = value;
+        else if (strcmp(token, "MaxTessControlAtomicCounters") == 0)
+            resources.maxTessControlAtomicCounters = value;
+        else if (strcmp(token, "MaxTessEvaluationAtomicCounters") == 0)
+            resources.maxTessEvaluationAtomicCounters = value;
+        else if (strcmp(token, "MaxGeometryAtomicCounters") == 0)
+            resources.maxGeometryAtomicCounters = value;
+        else if (strcmp(token, "MaxFragmentAtomicCounters") == 0)
+            resources.maxFragmentAtomicCounters = value;
+        else if (strcmp(token, "MaxCombinedAtomicCounters") == 0)
+            resources.maxCombinedAtomicCounters = value;
+        else if (strcmp(token, "MaxAtomicCounterBindings") == 0)
+            resources.maxAtomicCounterBindings = value;
+        else if (strcmp(token, "MaxVertexAtomicCounterBuffers") == 0)
+            resources.maxVertexAtomicCounterBuffers = value;
+        else if (strcmp(token, "MaxTessControlAtomicCounterBuffers") == 0)
+            resources.maxTessControlAtomicCounterBuffers = value;
+        else if (strcmp(token, "MaxTessEvaluationAtomicCounterBuffers") == 0)
+            resources.maxTessEvaluationAtomicCounterBuffers = value;
+        else if (strcmp(token, "MaxGeometryAtomicCounterBuffers") == 0)
+            resources.maxGeometryAtomicCounterBuffers = value;
+        else if (strcmp(token, "MaxFragmentAtomicCounterBuffers") == 0)
+            resources.maxFragmentAtomicCounterBuffers = value;
+        else if (strcmp(token, "MaxCombinedAtomicCounterBuffers") == 0)
+            resources.maxCombinedAtomicCounterBuffers = value;
+        else if (strcmp(token, "MaxAtomicCounterBufferSize") == 0)
+            resources.maxAtomicCounterBufferSize = value;
+        else if (strcmp(token, "MaxTransformFeedbackBuffers") == 0)
+            resources.maxTransformFeedbackBuffers = value;
+        else if (strcmp(token, "MaxTransformFeedbackInterleavedComponents") == 0)
+            resources.maxTransformFeedbackInterleavedComponents = value;
+        else if (strcmp(token, "MaxCullDistances") == 0)
+            resources.maxCullDistances = value;
+        else if (strcmp(token, "MaxCombinedClipAndCullDistances") == 0)
+            resources.maxCombinedClipAndCullDistances = value;
+        else if (strcmp(token, "MaxSamples") == 0)
+            resources.maxSamples = value;
+
+        else if (strcmp(token, "nonInductiveForLoops") == 0)
+            resources.limits.nonInductiveForLoops = (value != 0);
+        else if (strcmp(token, "whileLoops") == 0)
+            resources.limits.whileLoops = (value != 0);
+        else if (strcmp(token, "doWhileLoops") == 0)
+            resources.limits.doWhileLoops = (value != 0);
+        else if (strcmp(token, "generalUniformIndexing") == 0)
+            resources.limits.generalUniformIndexing = (value != 0);
+        else if (strcmp(token, "generalAttributeMatrixVectorIndexing") == 0)
+            resources.limits.generalAttributeMatrixVectorIndexing = (value != 0);
+        else if (strcmp(token, "generalVaryingIndexing") == 0)
+            resources.limits.generalVaryingIndexing = (value != 0);
+        else if (strcmp(token, "generalSamplerIndexing") == 0)
+            resources.limits.generalSamplerIndexing = (value != 0);
+        else if (strcmp(token, "generalVariableIndexing") == 0)
+            resources.limits.generalVariableIndexing = (value != 0);
+        else if (strcmp(token, "generalConstantMatrixVectorIndexing") == 0)
+            resources.limits.generalConstantMatrixVectorIndexing = (value != 0);
+        else
+            printf("Warning: unrecognized limit (%s) in configuration file.\n", token);
+
+        token = strtok(0, delims);
+    }
+}
+
+} // end namespace glslang
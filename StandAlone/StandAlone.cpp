@@ -38,18 +38,39 @@
 #define _CRT_SECURE_NO_WARNINGS
 
 #include "Worklist.h"
+#include "CompileServer.h"
+#include "CompileCache.h"
+#include "FileIncluder.h"
+#include "ResourceLimits.h"
 #include "./../glslang/Include/ShHandle.h"
 #include "./../glslang/Public/ShaderLang.h"
 #include "../SPIRV/GlslangToSpv.h"
 #include "../SPIRV/GLSL450Lib.h"
 #include "../SPIRV/doc.h"
 #include "../SPIRV/disassemble.h"
+#include "../SPIRV/SPVRemapper.h"
+#include "../OGLCompilersDLL/InitializeDll.h"
 #include <string.h>
 #include <stdlib.h>
+#include <limits.h>
 #include <math.h>
+#include <thread>
+#include <chrono>
+#include <map>
+#include <sstream>
 
 #include "osinclude.h"
 
+#ifdef _WIN32
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
 extern "C" {
     SH_IMPORT_EXPORT void ShOutputHtml();
 }
@@ -88,352 +109,60 @@ enum TFailCode {
     EFailLinkerCreate
 };
 
+//
+// The contents of a source file, mapped into memory rather than copied.
+// The data is not null terminated; use the length.
+//
+struct TFileData {
+    TFileData() : data(""), length(0), mapping(nullptr) { }
+    const char* data;
+    int length;
+    void* mapping;     // platform-specific handle for unmapping, if anything got mapped
+};
+
 //
 // Forward declarations.
 //
 EShLanguage FindLanguage(const std::string& name);
 void CompileFile(const char* fileName, ShHandle);
 void usage();
-void FreeFileData(char** data);
-char** ReadFileData(const char* fileName);
+void FreeFileData(TFileData& file);
+bool ReadFileData(const char* fileName, TFileData& file);
+long FileSize(const char* fileName);
 void InfoLogMsg(const char* msg, const char* name, const int num);
 
 // Globally track if any compile or link failure.
 bool CompileFailed = false;
 bool LinkFailed = false;
 
-// Use to test breaking up a single shader file into multiple strings.
-// Set in ReadFileData().
-int NumShaderStrings;
-
 TBuiltInResource Resources;
 std::string ConfigFile;
 
 //
-// These are the default resources for TBuiltInResources, used for both
-//  - parsing this string for the case where the user didn't supply one
-//  - dumping out a template for user construction of a config file
-//
-const char* DefaultConfig =
-    "MaxLights 32\n"
-    "MaxClipPlanes 6\n"
-    "MaxTextureUnits 32\n"
-    "MaxTextureCoords 32\n"
-    "MaxVertexAttribs 64\n"
-    "MaxVertexUniformComponents 4096\n"
-    "MaxVaryingFloats 64\n"
-    "MaxVertexTextureImageUnits 32\n"
-    "MaxCombinedTextureImageUnits 80\n"
-    "MaxTextureImageUnits 32\n"
-    "MaxFragmentUniformComponents 4096\n"
-    "MaxDrawBuffers 32\n"
-    "MaxVertexUniformVectors 128\n"
-    "MaxVaryingVectors 8\n"
-    "MaxFragmentUniformVectors 16\n"
-    "MaxVertexOutputVectors 16\n"
-    "MaxFragmentInputVectors 15\n"
-    "MinProgramTexelOffset -8\n"
-    "MaxProgramTexelOffset 7\n"
-    "MaxClipDistances 8\n"
-    "MaxComputeWorkGroupCountX 65535\n"
-    "MaxComputeWorkGroupCountY 65535\n"
-    "MaxComputeWorkGroupCountZ 65535\n"
-    "MaxComputeWorkGroupSizeX 1024\n"
-    "MaxComputeWorkGroupSizeY 1024\n"
-    "MaxComputeWorkGroupSizeZ 64\n"
-    "MaxComputeUniformComponents 1024\n"
-    "MaxComputeTextureImageUnits 16\n"
-    "MaxComputeImageUniforms 8\n"
-    "MaxComputeAtomicCounters 8\n"
-    "MaxComputeAtomicCounterBuffers 1\n"
-    "MaxVaryingComponents 60\n" 
-    "MaxVertexOutputComponents 64\n"
-    "MaxGeometryInputComponents 64\n"
-    "MaxGeometryOutputComponents 128\n"
-    "MaxFragmentInputComponents 128\n"
-    "MaxImageUnits 8\n"
-    "MaxCombinedImageUnitsAndFragmentOutputs 8\n"
-    "MaxCombinedShaderOutputResources 8\n"
-    "MaxImageSamples 0\n"
-    "MaxVertexImageUniforms 0\n"
-    "MaxTessControlImageUniforms 0\n"
-    "MaxTessEvaluationImageUniforms 0\n"
-    "MaxGeometryImageUniforms 0\n"
-    "MaxFragmentImageUniforms 8\n"
-    "MaxCombinedImageUniforms 8\n"
-    "MaxGeometryTextureImageUnits 16\n"
-    "MaxGeometryOutputVertices 256\n"
-    "MaxGeometryTotalOutputComponents 1024\n"
-    "MaxGeometryUniformComponents 1024\n"
-    "MaxGeometryVaryingComponents 64\n"
-    "MaxTessControlInputComponents 128\n"
-    "MaxTessControlOutputComponents 128\n"
-    "MaxTessControlTextureImageUnits 16\n"
-    "MaxTessControlUniformComponents 1024\n"
-    "MaxTessControlTotalOutputComponents 4096\n"
-    "MaxTessEvaluationInputComponents 128\n"
-    "MaxTessEvaluationOutputComponents 128\n"
-    "MaxTessEvaluationTextureImageUnits 16\n"
-    "MaxTessEvaluationUniformComponents 1024\n"
-    "MaxTessPatchComponents 120\n"
-    "MaxPatchVertices 32\n"
-    "MaxTessGenLevel 64\n"
-    "MaxViewports 16\n"
-    "MaxVertexAtomicCounters 0\n"
-    "MaxTessControlAtomicCounters 0\n"
-    "MaxTessEvaluationAtomicCounters 0\n"
-    "MaxGeometryAtomicCounters 0\n"
-    "MaxFragmentAtomicCounters 8\n"
-    "MaxCombinedAtomicCounters 8\n"
-    "MaxAtomicCounterBindings 1\n"
-    "MaxVertexAtomicCounterBuffers 0\n"
-    "MaxTessControlAtomicCounterBuffers 0\n"
-    "MaxTessEvaluationAtomicCounterBuffers 0\n"
-    "MaxGeometryAtomicCounterBuffers 0\n"
-    "MaxFragmentAtomicCounterBuffers 1\n"
-    "MaxCombinedAtomicCounterBuffers 1\n"
-    "MaxAtomicCounterBufferSize 16384\n"
-    "MaxTransformFeedbackBuffers 4\n"
-    "MaxTransformFeedbackInterleavedComponents 64\n"
-    "MaxCullDistances 8\n"
-    "MaxCombinedClipAndCullDistances 8\n"
-    "MaxSamples 4\n"
-
-    "nonInductiveForLoops 1\n"
-    "whileLoops 1\n"
-    "doWhileLoops 1\n"
-    "generalUniformIndexing 1\n"
-    "generalAttributeMatrixVectorIndexing 1\n"
-    "generalVaryingIndexing 1\n"
-    "generalSamplerIndexing 1\n"
-    "generalVariableIndexing 1\n"
-    "generalConstantMatrixVectorIndexing 1\n"
-    ;
-
-//
-// Parse either a .conf file provided by the user or the default string above.
-//
-void ProcessConfigFile()
+// Parse either a .conf file provided by the user or the default string above,
+// into the given resources.
+//
+void ProcessConfigFile(const std::string& configFileName, TBuiltInResource& resources)
 {
-    char** configStrings = 0;
-    char* config = 0;
-    if (ConfigFile.size() > 0) {
-        configStrings = ReadFileData(ConfigFile.c_str());
-        if (configStrings)
-            config = *configStrings;
-        else {
+    // strtok() needs a modifiable, null-terminated copy
+    std::string configString;
+    if (configFileName.size() > 0) {
+        TFileData configFile;
+        if (ReadFileData(configFileName.c_str(), configFile)) {
+            configString.assign(configFile.data, configFile.length);
+            FreeFileData(configFile);
+        } else {
             printf("Error opening configuration file; will instead use the default configuration\n");
             usage();
         }
     }
 
-    if (config == 0) {
-        config = new char[strlen(DefaultConfig) + 1];
-        strcpy(config, DefaultConfig);
-    }
-
-    const char* delims = " \t\n\r";
-    const char* token = strtok(config, delims);
-    while (token) {
-        const char* valueStr = strtok(0, delims);
-        if (valueStr == 0 || ! (valueStr[0] == '-' || (valueStr[0] >= '0' && valueStr[0] <= '9'))) {
-            printf("Error: '%s' bad .conf file.  Each name must be followed by one number.\n", valueStr ? valueStr : "");
-            return;
-        }
-        int value = atoi(valueStr);
-
-        if (strcmp(token, "MaxLights") == 0)
-            Resources.maxLights = value;
-        else if (strcmp(token, "MaxClipPlanes") == 0)
-            Resources.maxClipPlanes = value;
-        else if (strcmp(token, "MaxTextureUnits") == 0)
-            Resources.maxTextureUnits = value;
-        else if (strcmp(token, "MaxTextureCoords") == 0)
-            Resources.maxTextureCoords = value;
-        else if (strcmp(token, "MaxVertexAttribs") == 0)
-            Resources.maxVertexAttribs = value;
-        else if (strcmp(token, "MaxVertexUniformComponents") == 0)
-            Resources.maxVertexUniformComponents = value;
-        else if (strcmp(token, "MaxVaryingFloats") == 0)
-            Resources.maxVaryingFloats = value;
-        else if (strcmp(token, "MaxVertexTextureImageUnits") == 0)
-            Resources.maxVertexTextureImageUnits = value;
-        else if (strcmp(token, "MaxCombinedTextureImageUnits") == 0)
-            Resources.maxCombinedTextureImageUnits = value;
-        else if (strcmp(token, "MaxTextureImageUnits") == 0)
-            Resources.maxTextureImageUnits = value;
-        else if (strcmp(token, "MaxFragmentUniformComponents") == 0)
-            Resources.maxFragmentUniformComponents = value;
-        else if (strcmp(token, "MaxDrawBuffers") == 0)
-            Resources.maxDrawBuffers = value;
-        else if (strcmp(token, "MaxVertexUniformVectors") == 0)
-            Resources.maxVertexUniformVectors = value;
-        else if (strcmp(token, "MaxVaryingVectors") == 0)
-            Resources.maxVaryingVectors = value;
-        else if (strcmp(token, "MaxFragmentUniformVectors") == 0)
-            Resources.maxFragmentUniformVectors = value;
-        else if (strcmp(token, "MaxVertexOutputVectors") == 0)
-            Resources.maxVertexOutputVectors = value;
-        else if (strcmp(token, "MaxFragmentInputVectors") == 0)
-            Resources.maxFragmentInputVectors = value;
-        else if (strcmp(token, "MinProgramTexelOffset") == 0)
-            Resources.minProgramTexelOffset = value;
-        else if (strcmp(token, "MaxProgramTexelOffset") == 0)
-            Resources.maxProgramTexelOffset = value;
-        else if (strcmp(token, "MaxClipDistances") == 0)
-            Resources.maxClipDistances = value;
-        else if (strcmp(token, "MaxComputeWorkGroupCountX") == 0)
-            Resources.maxComputeWorkGroupCountX = value;
-        else if (strcmp(token, "MaxComputeWorkGroupCountY") == 0)
-            Resources.maxComputeWorkGroupCountY = value;
-        else if (strcmp(token, "MaxComputeWorkGroupCountZ") == 0)
-            Resources.maxComputeWorkGroupCountZ = value;
-        else if (strcmp(token, "MaxComputeWorkGroupSizeX") == 0)
-            Resources.maxComputeWorkGroupSizeX = value;
-        else if (strcmp(token, "MaxComputeWorkGroupSizeY") == 0)
-            Resources.maxComputeWorkGroupSizeY = value;
-        else if (strcmp(token, "MaxComputeWorkGroupSizeZ") == 0)
-            Resources.maxComputeWorkGroupSizeZ = value;
-        else if (strcmp(token, "MaxComputeUniformComponents") == 0)
-            Resources.maxComputeUniformComponents = value;
-        else if (strcmp(token, "MaxComputeTextureImageUnits") == 0)
-            Resources.maxComputeTextureImageUnits = value;
-        else if (strcmp(token, "MaxComputeImageUniforms") == 0)
-            Resources.maxComputeImageUniforms = value;
-        else if (strcmp(token, "MaxComputeAtomicCounters") == 0)
-            Resources.maxComputeAtomicCounters = value;
-        else if (strcmp(token, "MaxComputeAtomicCounterBuffers") == 0)
-            Resources.maxComputeAtomicCounterBuffers = value;
-        else if (strcmp(token, "MaxVaryingComponents") == 0)
-            Resources.maxVaryingComponents = value;
-        else if (strcmp(token, "MaxVertexOutputComponents") == 0)
-            Resources.maxVertexOutputComponents = value;
-        else if (strcmp(token, "MaxGeometryInputComponents") == 0)
-            Resources.maxGeometryInputComponents = value;
-        else if (strcmp(token, "MaxGeometryOutputComponents") == 0)
-            Resources.maxGeometryOutputComponents = value;
-        else if (strcmp(token, "MaxFragmentInputComponents") == 0)
-            Resources.maxFragmentInputComponents = value;
-        else if (strcmp(token, "MaxImageUnits") == 0)
-            Resources.maxImageUnits = value;
-        else if (strcmp(token, "MaxCombinedImageUnitsAndFragmentOutputs") == 0)
-            Resources.maxCombinedImageUnitsAndFragmentOutputs = value;
-        else if (strcmp(token, "MaxCombinedShaderOutputResources") == 0)
-            Resources.maxCombinedShaderOutputResources = value;
-        else if (strcmp(token, "MaxImageSamples") == 0)
-            Resources.maxImageSamples = value;
-        else if (strcmp(token, "MaxVertexImageUniforms") == 0)
-            Resources.maxVertexImageUniforms = value;
-        else if (strcmp(token, "MaxTessControlImageUniforms") == 0)
-            Resources.maxTessControlImageUniforms = value;
-        else if (strcmp(token, "MaxTessEvaluationImageUniforms") == 0)
-            Resources.maxTessEvaluationImageUniforms = value;
-        else if (strcmp(token, "MaxGeometryImageUniforms") == 0)
-            Resources.maxGeometryImageUniforms = value;
-        else if (strcmp(token, "MaxFragmentImageUniforms") == 0)
-            Resources.maxFragmentImageUniforms = value;
-        else if (strcmp(token, "MaxCombinedImageUniforms") == 0)
-            Resources.maxCombinedImageUniforms = value;
-        else if (strcmp(token, "MaxGeometryTextureImageUnits") == 0)
-            Resources.maxGeometryTextureImageUnits = value;
-        else if (strcmp(token, "MaxGeometryOutputVertices") == 0)
-            Resources.maxGeometryOutputVertices = value;
-        else if (strcmp(token, "MaxGeometryTotalOutputComponents") == 0)
-            Resources.maxGeometryTotalOutputComponents = value;
-        else if (strcmp(token, "MaxGeometryUniformComponents") == 0)
-            Resources.maxGeometryUniformComponents = value;
-        else if (strcmp(token, "MaxGeometryVaryingComponents") == 0)
-            Resources.maxGeometryVaryingComponents = value;
-        else if (strcmp(token, "MaxTessControlInputComponents") == 0)
-            Resources.maxTessControlInputComponents = value;
-        else if (strcmp(token, "MaxTessControlOutputComponents") == 0)
-            Resources.maxTessControlOutputComponents = value;
-        else if (strcmp(token, "MaxTessControlTextureImageUnits") == 0)
-            Resources.maxTessControlTextureImageUnits = value;
-        else if (strcmp(token, "MaxTessControlUniformComponents") == 0)
-            Resources.maxTessControlUniformComponents = value;
-        else if (strcmp(token, "MaxTessControlTotalOutputComponents") == 0)
-            Resources.maxTessControlTotalOutputComponents = value;
-        else if (strcmp(token, "MaxTessEvaluationInputComponents") == 0)
-            Resources.maxTessEvaluationInputComponents = value;
-        else if (strcmp(token, "MaxTessEvaluationOutputComponents") == 0)
-            Resources.maxTessEvaluationOutputComponents = value;
-        else if (strcmp(token, "MaxTessEvaluationTextureImageUnits") == 0)
-            Resources.maxTessEvaluationTextureImageUnits = value;
-        else if (strcmp(token, "MaxTessEvaluationUniformComponents") == 0)
-            Resources.maxTessEvaluationUniformComponents = value;
-        else if (strcmp(token, "MaxTessPatchComponents") == 0)
-            Resources.maxTessPatchComponents = value;
-        else if (strcmp(token, "MaxPatchVertices") == 0)
-            Resources.maxPatchVertices = value;
-        else if (strcmp(token, "MaxTessGenLevel") == 0)
-            Resources.maxTessGenLevel = value;
-        else if (strcmp(token, "MaxViewports") == 0)
-            Resources.maxViewports = value;
-        else if (strcmp(token, "MaxVertexAtomicCounters") == 0)
-            Resources.maxVertexAtomicCounters = value;
-        else if (strcmp(token, "MaxTessControlAtomicCounters") == 0)
-            Resources.maxTessControlAtomicCounters = value;
-        else if (strcmp(token, "MaxTessEvaluationAtomicCounters") == 0)
-            Resources.maxTessEvaluationAtomicCounters = value;
-        else if (strcmp(token, "MaxGeometryAtomicCounters") == 0)
-            Resources.maxGeometryAtomicCounters = value;
-        else if (strcmp(token, "MaxFragmentAtomicCounters") == 0)
-            Resources.maxFragmentAtomicCounters = value;
-        else if (strcmp(token, "MaxCombinedAtomicCounters") == 0)
-            Resources.maxCombinedAtomicCounters = value;
-        else if (strcmp(token, "MaxAtomicCounterBindings") == 0)
-            Resources.maxAtomicCounterBindings = value;
-        else if (strcmp(token, "MaxVertexAtomicCounterBuffers") == 0)
-            Resources.maxVertexAtomicCounterBuffers = value;
-        else if (strcmp(token, "MaxTessControlAtomicCounterBuffers") == 0)
-            Resources.maxTessControlAtomicCounterBuffers = value;
-        else if (strcmp(token, "MaxTessEvaluationAtomicCounterBuffers") == 0)
-            Resources.maxTessEvaluationAtomicCounterBuffers = value;
-        else if (strcmp(token, "MaxGeometryAtomicCounterBuffers") == 0)
-            Resources.maxGeometryAtomicCounterBuffers = value;
-        else if (strcmp(token, "MaxFragmentAtomicCounterBuffers") == 0)
-            Resources.maxFragmentAtomicCounterBuffers = value;
-        else if (strcmp(token, "MaxCombinedAtomicCounterBuffers") == 0)
-            Resources.maxCombinedAtomicCounterBuffers = value;
-        else if (strcmp(token, "MaxAtomicCounterBufferSize") == 0)
-            Resources.maxAtomicCounterBufferSize = value;
-        else if (strcmp(token, "MaxTransformFeedbackBuffers") == 0)
-            Resources.maxTransformFeedbackBuffers = value;
-        else if (strcmp(token, "MaxTransformFeedbackInterleavedComponents") == 0)
-            Resources.maxTransformFeedbackInterleavedComponents = value;
-        else if (strcmp(token, "MaxCullDistances") == 0)
-            Resources.maxCullDistances = value;
-        else if (strcmp(token, "MaxCombinedClipAndCullDistances") == 0)
-            Resources.maxCombinedClipAndCullDistances = value;
-        else if (strcmp(token, "MaxSamples") == 0)
-            Resources.maxSamples = value;
-
-        else if (strcmp(token, "nonInductiveForLoops") == 0)
-            Resources.limits.nonInductiveForLoops = (value != 0);
-        else if (strcmp(token, "whileLoops") == 0)
-            Resources.limits.whileLoops = (value != 0);
-        else if (strcmp(token, "doWhileLoops") == 0)
-            Resources.limits.doWhileLoops = (value != 0);
-        else if (strcmp(token, "generalUniformIndexing") == 0)
-            Resources.limits.generalUniformIndexing = (value != 0);
-        else if (strcmp(token, "generalAttributeMatrixVectorIndexing") == 0)
-            Resources.limits.generalAttributeMatrixVectorIndexing = (value != 0);
-        else if (strcmp(token, "generalVaryingIndexing") == 0)
-            Resources.limits.generalVaryingIndexing = (value != 0);
-        else if (strcmp(token, "generalSamplerIndexing") == 0)
-            Resources.limits.generalSamplerIndexing = (value != 0);
-        else if (strcmp(token, "generalVariableIndexing") == 0)
-            Resources.limits.generalVariableIndexing = (value != 0);
-        else if (strcmp(token, "generalConstantMatrixVectorIndexing") == 0)
-            Resources.limits.generalConstantMatrixVectorIndexing = (value != 0);
-        else
-            printf("Warning: unrecognized limit (%s) in configuration file.\n", token);
+    if (configString.size() == 0)
+        configString = glslang::DefaultConfig;
+    std::vector<char> config(configString.begin(), configString.end());
+    config.push_back('\0');
 
-        token = strtok(0, delims);
-    }
-    if (configStrings)
-        FreeFileData(configStrings);
+    glslang::DecodeResourceLimits(resources, &config[0]);
 }
 
 // thread-safe list of shaders to asynchronously grab and compile
@@ -444,6 +173,18 @@ glslang::TWorkItem** Work = 0;
 int NumWorkItems = 0;
 
 int Options = 0;
+int NumThreads = 0;  // 0 means one per hardware thread
+const char* ManifestFileName = nullptr;
+int BenchRuns = 0;
+const char* ServerSocketName = nullptr;
+const char* WarmVersions = nullptr;
+const char* SaveBuiltinsFileName = nullptr;
+const char* LoadBuiltinsFileName = nullptr;
+bool ParseBuiltins = false;
+bool PrintDependencies = false;
+const char* CacheDirectory = nullptr;
+int CacheMegabytes = 256;
+glslang::TCompileCache* Cache = nullptr;
 const char* ExecutableName = nullptr;
 const char* binaryFileName = nullptr;
 
@@ -528,6 +269,84 @@ void ProcessArguments(int argc, char* argv[])
             case 'E':
                 Options |= EOptionOutputPreprocessed;
                 break;
+            case '-':
+                if (strcmp(argv[0], "--threads") == 0) {
+                    if (argc > 1) {
+                        NumThreads = atoi(argv[1]);
+                        argc--;
+                        argv++;
+                    } else
+                        Error("no <count> provided for --threads");
+                    if (NumThreads < 1)
+                        Error("--threads requires a positive <count>");
+                    Options |= EOptionMultiThreaded;
+                } else if (strcmp(argv[0], "--bench") == 0) {
+                    if (argc > 1) {
+                        BenchRuns = atoi(argv[1]);
+                        argc--;
+                        argv++;
+                    } else
+                        Error("no <count> provided for --bench");
+                    if (BenchRuns < 1)
+                        Error("--bench requires a positive <count>");
+                } else if (strcmp(argv[0], "--manifest") == 0) {
+                    if (argc > 1) {
+                        ManifestFileName = argv[1];
+                        argc--;
+                        argv++;
+                    } else
+                        Error("no <file> provided for --manifest");
+                } else if (strcmp(argv[0], "--warm") == 0) {
+                    if (argc > 1) {
+                        WarmVersions = argv[1];
+                        argc--;
+                        argv++;
+                    } else
+                        Error("no <versions> provided for --warm");
+                } else if (strcmp(argv[0], "--save-builtins") == 0) {
+                    if (argc > 1) {
+                        SaveBuiltinsFileName = argv[1];
+                        argc--;
+                        argv++;
+                    } else
+                        Error("no <file> provided for --save-builtins");
+                } else if (strcmp(argv[0], "--load-builtins") == 0) {
+                    if (argc > 1) {
+                        LoadBuiltinsFileName = argv[1];
+                        argc--;
+                        argv++;
+                    } else
+                        Error("no <file> provided for --load-builtins");
+                } else if (strcmp(argv[0], "--parse-builtins") == 0) {
+                    ParseBuiltins = true;
+                } else if (strcmp(argv[0], "--dependencies") == 0) {
+                    PrintDependencies = true;
+                } else if (strcmp(argv[0], "--cache") == 0) {
+                    if (argc > 1) {
+                        CacheDirectory = argv[1];
+                        argc--;
+                        argv++;
+                    } else
+                        Error("no <directory> provided for --cache");
+                } else if (strcmp(argv[0], "--cache-size") == 0) {
+                    if (argc > 1) {
+                        CacheMegabytes = atoi(argv[1]);
+                        argc--;
+                        argv++;
+                    } else
+                        Error("no <megabytes> provided for --cache-size");
+                    if (CacheMegabytes < 1)
+                        Error("--cache-size requires a positive <megabytes>");
+                } else if (strcmp(argv[0], "--server") == 0) {
+                    if (argc > 1) {
+                        ServerSocketName = argv[1];
+                        argc--;
+                        argv++;
+                    } else
+                        Error("no <socket> provided for --server");
+                } else
+                    usage();
+                break;
             case 'c':
                 Options |= EOptionDumpConfig;
                 break;
@@ -564,9 +383,7 @@ void ProcessArguments(int argc, char* argv[])
                 Options |= EOptionSuppressInfolog;
                 break;
             case 't':
-                #ifdef _WIN32
-                    Options |= EOptionMultiThreaded;
-                #endif
+                Options |= EOptionMultiThreaded;
                 break;
             case 'v':
                 Options |= EOptionDumpVersions;
@@ -594,6 +411,96 @@ void ProcessArguments(int argc, char* argv[])
     // -o makes no sense if there is no target binary
     if (binaryFileName && (Options & EOptionSpv) == 0)
         Error("no binary generation requested (e.g., -V)");
+
+    // the manifest says what to compile and where to put it
+    if (ManifestFileName && (! Worklist.empty() || binaryFileName))
+        Error("can't give shader files or -o with --manifest");
+    if (ManifestFileName && (Options & EOptionOutputPreprocessed))
+        Error("can't use -E with --manifest");
+
+    // benchmarking runs every phase itself
+    if (BenchRuns > 0 && (ManifestFileName || (Options & EOptionOutputPreprocessed)))
+        Error("can't use --bench with -E or --manifest");
+
+    // clients send the shaders to the server
+    if (ServerSocketName && (! Worklist.empty() || binaryFileName || ManifestFileName || BenchRuns > 0))
+        Error("can't give shader files, -o, --manifest, or --bench with --server");
+
+    // only worth it ahead of many compiles
+    if (WarmVersions && ! ServerSocketName && ! ManifestFileName && ! SaveBuiltinsFileName)
+        Error("--warm requires --server, --manifest, or --save-builtins");
+
+    // saving the built-ins compiles nothing
+    if (ParseBuiltins && LoadBuiltinsFileName)
+        Error("can't give --parse-builtins with --load-builtins");
+
+    if (SaveBuiltinsFileName && (! Worklist.empty() || ManifestFileName || ServerSocketName || BenchRuns > 0 || LoadBuiltinsFileName))
+        Error("can't give shader files, --manifest, --server, --bench, or --load-builtins with --save-builtins");
+
+    // benchmarking is of the compiler, not the cache
+    if (CacheDirectory && BenchRuns > 0)
+        Error("can't use --cache with --bench");
+}
+
+//
+// Every version/profile having built-ins, for --save-builtins without --warm.
+//
+const char* AllBuiltInVersions = "100,110,120,130,140,150core,150compatibility,300es,310es,"
+                                 "330core,330compatibility,400core,400compatibility,410core,410compatibility,"
+                                 "420core,420compatibility,430core,430compatibility,440core,440compatibility,"
+                                 "450core,450compatibility";
+
+//
+// Parse a comma-separated list of versions, each optionally followed by a
+// profile, e.g., "100,300es,330,450core".
+//
+void ParseVersions(const char* versionList, std::vector<int>& versions, std::vector<EProfile>& profiles)
+{
+    std::istringstream list(versionList);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        char* profile;
+        versions.push_back((int)strtol(item.c_str(), &profile, 10));
+        if (strcmp(profile, "es") == 0)
+            profiles.push_back(EEsProfile);
+        else if (strcmp(profile, "core") == 0)
+            profiles.push_back(ECoreProfile);
+        else if (strcmp(profile, "compatibility") == 0)
+            profiles.push_back(ECompatibilityProfile);
+        else if (profile[0] == 0)
+            profiles.push_back(ENoProfile);
+        else
+            Error("unknown profile in --warm");
+    }
+}
+
+//
+// For --warm: set up the built-in symbol tables for its list of versions.
+//
+void WarmBuiltins()
+{
+    std::vector<int> versions;
+    std::vector<EProfile> profiles;
+    ParseVersions(WarmVersions, versions, profiles);
+
+    if (NumThreads == 0)
+        NumThreads = std::max((int)std::thread::hardware_concurrency(), 1);
+    if (! glslang::WarmBuiltins(versions.data(), profiles.data(), (int)versions.size(), NumThreads))
+        Error("unsupported version/profile in --warm");
+}
+
+//
+// For --save-builtins: write a snapshot of the built-in symbol tables of the
+// --warm versions, or of all of them.
+//
+void SaveBuiltins()
+{
+    std::vector<int> versions;
+    std::vector<EProfile> profiles;
+    ParseVersions(WarmVersions ? WarmVersions : AllBuiltInVersions, versions, profiles);
+
+    if (! glslang::SaveBuiltins(SaveBuiltinsFileName, versions.data(), profiles.data(), (int)versions.size()))
+        Error("unable to save the built-ins of each version in --save-builtins");
 }
 
 //
@@ -626,8 +533,9 @@ unsigned int
 #endif
 CompileShaders(void*)
 {
+    int queue = Worklist.claimQueue();
     glslang::TWorkItem* workItem;
-    while (Worklist.remove(workItem)) {
+    while (Worklist.remove(workItem, queue)) {
         ShHandle compiler = ShConstructCompiler(FindLanguage(workItem->name), Options);
         if (compiler == 0)
             return 0;
@@ -663,6 +571,18 @@ void StderrIfNonEmpty(const char* str)
     }
 }
 
+//
+// Print the files a shader brought in through #include, make style.
+//
+void PrintIncludedFiles(const std::string& name, const glslang::TShader& shader)
+{
+    printf("%s:", name.c_str());
+    const std::vector<std::string>& includedFiles = shader.getIncludedFiles();
+    for (size_t f = 0; f < includedFiles.size(); ++f)
+        printf(" %s", includedFiles[f].c_str());
+    printf("\n");
+}
+
 //
 // For linking mode: Will independently parse each item in the worklist, but then put them
 // in the same program and link them together.
@@ -676,11 +596,23 @@ void CompileAndLinkShaders()
     
     EShMessages messages = EShMsgDefault;
     SetMessageOptions(messages);
+    const int defaultVersion = Options & EOptionDefaultDesktop? 110: 100;
 
     //
     // Per-shader processing...
     //
 
+    // with -t, parse all the stages concurrently after reading them all in
+    bool parallelParse = (Options & EOptionMultiThreaded) && ! (Options & EOptionOutputPreprocessed);
+
+    // source files stay mapped until all parsing is done
+    std::list<TFileData> files;
+    std::list<std::string> names;
+    std::list<glslang::TFileIncluder> includers;
+
+    glslang::TCompileCacheKey cacheKey;
+    glslang::AddCompilerVersion(cacheKey);
+
     glslang::TProgram& program = *new glslang::TProgram;
     glslang::TWorkItem* workItem;
     while (Worklist.remove(workItem)) {
@@ -688,16 +620,14 @@ void CompileAndLinkShaders()
         glslang::TShader* shader = new glslang::TShader(stage);
         shaders.push_back(shader);
     
-        char** shaderStrings = ReadFileData(workItem->name.c_str());
-        if (! shaderStrings) {
-            usage();
-            delete &program;
-
-            return;
-        }
-        const int defaultVersion = Options & EOptionDefaultDesktop? 110: 100;
-
-        shader->setStrings(shaderStrings, 1);
+        files.push_back(TFileData());
+        TFileData& file = files.back();
+        if (! ReadFileData(workItem->name.c_str(), file))
+            Error("unable to open input file");
+
+        shader->setStringsWithLengths(&file.data, &file.length, 1);
+        includers.push_back(glslang::TFileIncluder(workItem->name));
+        shader->setIncluder(&includers.back());
         if (Options & EOptionOutputPreprocessed) {
             std::string str;
             if (shader->preprocess(&Resources, defaultVersion, ENoProfile,
@@ -708,38 +638,88 @@ void CompileAndLinkShaders()
             }
             StderrIfNonEmpty(shader->getInfoLog());
             StderrIfNonEmpty(shader->getInfoDebugLog());
-            FreeFileData(shaderStrings);
+            if (PrintDependencies)
+                PrintIncludedFiles(workItem->name, *shader);
             continue;
         }
-        if (! shader->parse(&Resources, defaultVersion, false, messages))
-            CompileFailed = true;
-
         program.addShader(shader);
+        names.push_back(workItem->name);
+        glslang::AddShaderSource(cacheKey, stage, &file.data, &file.length, 1, nullptr);
+    }
+
+    // The results, as they are reported, are what gets cached; a hit
+    // skips straight to reporting them.
+    glslang::TCompileCacheEntry results;
+    std::string key;
+    bool cached = false;
+    if (Cache && ! (Options & EOptionOutputPreprocessed)) {
+        int wanted = ((Options & EOptionSpv) ? glslang::ECacheResultSpv : 0) |
+                     ((Options & EOptionDumpReflection) ? glslang::ECacheResultReflection : 0);
+        glslang::AddCompileOptions(cacheKey, defaultVersion, ENoProfile, false, Resources, messages, wanted);
+        key = cacheKey.getDigest();
+        cached = Cache->lookup(key, results);
+    }
+
+    if (parallelParse && ! cached) {
+        if (! program.parseShaders(&Resources, defaultVersion, ENoProfile, false, false, messages))
+            results.compiled = false;
+    }
+
+    // report in the same order, whether parsed serially, concurrently, or not at all
+    bool includesUsed = false;
+    std::list<glslang::TShader*>::const_iterator shader = shaders.begin();
+    std::list<std::string>::const_iterator name = names.begin();
+    for (int s = 0; name != names.end(); ++shader, ++name, ++s) {
+        if (! cached) {
+            if (! parallelParse && ! (*shader)->parse(&Resources, defaultVersion, false, messages))
+                results.compiled = false;
+            results.shaderInfoLogs.push_back((*shader)->getInfoLog());
+            results.shaderDebugLogs.push_back((*shader)->getInfoDebugLog());
+        }
 
         if (! (Options & EOptionSuppressInfolog)) {
-            PutsIfNonEmpty(workItem->name.c_str());
-            PutsIfNonEmpty(shader->getInfoLog());
-            PutsIfNonEmpty(shader->getInfoDebugLog());
+            PutsIfNonEmpty(name->c_str());
+            PutsIfNonEmpty(results.shaderInfoLogs[s].c_str());
+            PutsIfNonEmpty(results.shaderDebugLogs[s].c_str());
         }
+        if (PrintDependencies)
+            PrintIncludedFiles(*name, **shader);
+        if ((*shader)->getNumIncludeDirectives() > 0)
+            includesUsed = true;
+    }
+    if (! results.compiled)
+        CompileFailed = true;
 
-        FreeFileData(shaderStrings);
+    while (files.size() > 0) {
+        FreeFileData(files.back());
+        files.pop_back();
     }
 
     //
     // Program-level processing...
     //
 
-    if (! (Options & EOptionOutputPreprocessed) && ! program.link(messages))
-        LinkFailed = true;
+    if (! (Options & EOptionOutputPreprocessed)) {
+        if (! cached) {
+            results.linked = program.link(messages);
+            results.programInfoLog = program.getInfoLog();
+            results.programDebugLog = program.getInfoDebugLog();
+        }
+        if (! results.linked)
+            LinkFailed = true;
 
-    if (! (Options & EOptionSuppressInfolog)) {
-        PutsIfNonEmpty(program.getInfoLog());
-        PutsIfNonEmpty(program.getInfoDebugLog());
-    }
+        if (! (Options & EOptionSuppressInfolog)) {
+            PutsIfNonEmpty(results.programInfoLog.c_str());
+            PutsIfNonEmpty(results.programDebugLog.c_str());
+        }
 
-    if (Options & EOptionDumpReflection) {
-        program.buildReflection();
-        program.dumpReflection();
+        if ((Options & EOptionDumpReflection) && results.linked) {
+            if (! cached) {
+                program.buildReflection();
+                program.dumpReflection(results.reflection);
+            }
+            fputs(results.reflection.c_str(), stdout);
+        }
     }
 
     if (Options & EOptionSpv) {
@@ -747,20 +727,25 @@ void CompileAndLinkShaders()
             printf("SPIR-V is not generated for failed compile or link\n");
         else {
             for (int stage = 0; stage < EShLangCount; ++stage) {
-                if (program.getIntermediate((EShLanguage)stage)) {
-                    std::vector<unsigned int> spirv;
-                    glslang::GlslangToSpv(*program.getIntermediate((EShLanguage)stage), spirv);
-                    glslang::OutputSpv(spirv, GetBinaryName((EShLanguage)stage));
+                if (! cached && program.getIntermediate((EShLanguage)stage))
+                    glslang::GlslangToSpv(*program.getIntermediate((EShLanguage)stage), results.spirv[stage]);
+                if (results.spirv[stage].size() > 0) {
+                    glslang::OutputSpv(results.spirv[stage], GetBinaryName((EShLanguage)stage));
                     if (Options & EOptionHumanReadableSpv) {
                         spv::Parameterize();
                         GLSL_STD_450::GetDebugNames(GlslStd450DebugNames);
-                        spv::Disassemble(std::cout, spirv);
+                        spv::Disassemble(std::cout, results.spirv[stage]);
                     }
                 }
             }
         }
     }
 
+    // The key only covers the top-level sources, so results depending on any
+    // #include, even one that failed, can't be cached.
+    if (Cache && ! cached && ! includesUsed && ! (Options & EOptionOutputPreprocessed))
+        Cache->store(key, results);
+
     // Free everything up, program has to go before the shaders
     // because it might have merged stuff from the shaders, and
     // the stuff from the shaders has to have its destructors called
@@ -772,12 +757,442 @@ void CompileAndLinkShaders()
     }
 }
 
+//
+// Manifest (batch) mode.
+//
+// A manifest lists one shader per line, as whitespace-separated fields:
+//
+//     <shader file> <stage> <config file> <default version> <output file>
+//
+// Any field after the shader file can be "-" for its default: the stage from
+// the file's extension, the configuration from the command line, the usual
+// default version (100, or 110 with -d), and no output.  If an output file is
+// given, SPIR-V is generated into it.  Blank lines and lines starting with '#'
+// are skipped.
+//
+// All entries are compiled in one process, by a pool of threads sharing the
+// built-in symbol tables, and a JSON report of each entry's status, info log,
+// and per-phase times is written to stdout.
+//
+
+enum TManifestPhase {
+    EPhaseRead,
+    EPhaseParse,
+    EPhaseLink,
+    EPhaseSpv,
+    EPhaseOutput,
+    EPhaseCount
+};
+
+const char* ManifestPhaseNames[EPhaseCount] = { "read", "parse", "link", "spirv", "output" };
+
+class TManifestEntry : public glslang::TWorkItem {
+public:
+    TManifestEntry(const std::string& name, EShLanguage stage, const TBuiltInResource* resources,
+                   int defaultVersion, const std::string& outputName) :
+        TWorkItem(name), stage(stage), resources(resources), defaultVersion(defaultVersion),
+        outputName(outputName), status("success"), cached(false)
+    {
+        for (int phase = 0; phase < EPhaseCount; ++phase)
+            milliseconds[phase] = 0.0;
+    }
+
+    EShLanguage stage;
+    const TBuiltInResource* resources;
+    int defaultVersion;
+    std::string outputName;     // empty for no output
+    const char* status;
+    bool cached;                // results came from the --cache
+    double milliseconds[EPhaseCount];
+};
+
+typedef std::chrono::steady_clock TClock;
+
+double Milliseconds(TClock::time_point start, TClock::time_point end)
+{
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+//
+// Compile one manifest entry, recording how long each phase took.
+//
+void CompileManifestEntry(TManifestEntry& entry)
+{
+    EShMessages messages = EShMsgDefault;
+    SetMessageOptions(messages);
+
+    TClock::time_point start = TClock::now();
+    TFileData file;
+    if (! ReadFileData(entry.name.c_str(), file)) {
+        entry.status = "unreadable";
+        return;
+    }
+    TClock::time_point end = TClock::now();
+    entry.milliseconds[EPhaseRead] = Milliseconds(start, end);
+
+    glslang::TCompileCacheEntry results;
+    std::string key;
+    if (Cache) {
+        glslang::TCompileCacheKey cacheKey;
+        glslang::AddCompilerVersion(cacheKey);
+        glslang::AddShaderSource(cacheKey, entry.stage, &file.data, &file.length, 1, nullptr);
+        glslang::AddCompileOptions(cacheKey, entry.defaultVersion, ENoProfile, false, *entry.resources, messages,
+                                   entry.outputName.size() > 0 ? glslang::ECacheResultSpv : 0);
+        key = cacheKey.getDigest();
+        entry.cached = Cache->lookup(key, results);
+    }
+
+    if (! entry.cached) {
+        // the program has to go before the shader, see CompileAndLinkShaders()
+        glslang::TShader shader(entry.stage);
+        glslang::TProgram program;
+        glslang::TFileIncluder includer(entry.name);
+
+        start = TClock::now();
+        shader.setStringsWithLengths(&file.data, &file.length, 1);
+        shader.setIncluder(&includer);
+        results.compiled = shader.parse(entry.resources, entry.defaultVersion, false, messages);
+        end = TClock::now();
+        entry.milliseconds[EPhaseParse] = Milliseconds(start, end);
+        results.shaderInfoLogs.push_back(shader.getInfoLog());
+        results.shaderDebugLogs.push_back(shader.getInfoDebugLog());
+
+        start = end;
+        program.addShader(&shader);
+        results.linked = program.link(messages);
+        end = TClock::now();
+        entry.milliseconds[EPhaseLink] = Milliseconds(start, end);
+        results.programInfoLog = program.getInfoLog();
+        results.programDebugLog = program.getInfoDebugLog();
+
+        if (entry.outputName.size() > 0 && results.compiled && results.linked) {
+            start = end;
+            glslang::GlslangToSpv(*program.getIntermediate(entry.stage), results.spirv[entry.stage]);
+            end = TClock::now();
+            entry.milliseconds[EPhaseSpv] = Milliseconds(start, end);
+        }
+
+        // as for CompileAndLinkShaders(), the key doesn't cover included files
+        if (Cache && shader.getNumIncludeDirectives() == 0)
+            Cache->store(key, results);
+    }
+
+    if (! results.compiled)
+        entry.status = "compile-failed";
+    else if (! results.linked)
+        entry.status = "link-failed";
+    for (size_t s = 0; s < results.shaderInfoLogs.size(); ++s)
+        entry.results += results.shaderInfoLogs[s] + results.shaderDebugLogs[s];
+    entry.results += results.programInfoLog + results.programDebugLog;
+
+    if (results.spirv[entry.stage].size() > 0) {
+        start = TClock::now();
+        glslang::OutputSpv(results.spirv[entry.stage], entry.outputName.c_str());
+        end = TClock::now();
+        entry.milliseconds[EPhaseOutput] = Milliseconds(start, end);
+    }
+
+    FreeFileData(file);
+}
+
+//
+// Thread entry point, for manifest mode.
+//
+unsigned int
+#ifdef _WIN32
+    __stdcall
+#endif
+CompileManifestEntries(void*)
+{
+    if (! glslang::InitThread())
+        return 0;
+
+    // Each compile leaves its (soon deleted) pool as the thread's pool,
+    // so put back the thread's own between entries.
+    glslang::TPoolAllocator& threadAllocator = glslang::GetThreadPoolAllocator();
+
+    int queue = Worklist.claimQueue();
+    glslang::TWorkItem* workItem;
+    while (Worklist.remove(workItem, queue)) {
+        CompileManifestEntry(*static_cast<TManifestEntry*>(workItem));
+        glslang::SetThreadPoolAllocator(threadAllocator);
+    }
+
+    return 0;
+}
+
+//
+// Write a string as a JSON string literal.
+//
+void PutJsonString(const std::string& str)
+{
+    putchar('"');
+    for (size_t c = 0; c < str.size(); ++c) {
+        switch (str[c]) {
+        case '"':  printf("\\\"");  break;
+        case '\\': printf("\\\\");  break;
+        case '\n': printf("\\n");   break;
+        case '\r': printf("\\r");   break;
+        case '\t': printf("\\t");   break;
+        default:
+            if ((unsigned char)str[c] < 0x20)
+                printf("\\u%04x", (unsigned char)str[c]);
+            else
+                putchar(str[c]);
+            break;
+        }
+    }
+    putchar('"');
+}
+
+//
+// Read the manifest, compile everything in it, and report on it.
+//
+void CompileManifest()
+{
+    TClock::time_point start = TClock::now();
+
+    TFileData manifestFile;
+    if (! ReadFileData(ManifestFileName, manifestFile))
+        Error("unable to open manifest file");
+    std::istringstream manifest(std::string(manifestFile.data, manifestFile.length));
+    FreeFileData(manifestFile);
+
+    // each distinct config file is only processed once
+    std::map<std::string, TBuiltInResource> configs;
+
+    std::vector<TManifestEntry*> entries;
+    std::string line;
+    while (std::getline(manifest, line)) {
+        std::istringstream fields(line);
+        std::string name, stage, config, version, output;
+        if (! (fields >> name) || name[0] == '#')
+            continue;
+        if (! (fields >> stage >> config >> version >> output))
+            Error("each manifest line needs: <shader file> <stage> <config file> <default version> <output file>");
+
+        const TBuiltInResource* resources = &Resources;
+        if (config != "-") {
+            if (configs.find(config) == configs.end())
+                ProcessConfigFile(config, configs[config]);
+            resources = &configs[config];
+        }
+
+        TManifestEntry* entry = new TManifestEntry(name, FindLanguage(stage == "-" ? name : "." + stage), resources,
+                                                   version == "-" ? (Options & EOptionDefaultDesktop ? 110 : 100) : atoi(version.c_str()),
+                                                   output == "-" ? "" : output);
+        entry->cost = FileSize(name.c_str());
+        entries.push_back(entry);
+        Worklist.add(entry);
+    }
+
+    if (NumThreads == 0)
+        NumThreads = std::max((int)std::thread::hardware_concurrency(), 1);
+    Worklist.distribute(NumThreads);
+
+    std::vector<void*> threads(NumThreads);
+    for (int t = 0; t < NumThreads; ++t) {
+        threads[t] = glslang::OS_CreateThread(&CompileManifestEntries);
+        if (! threads[t]) {
+            printf("Failed to create thread\n");
+            exit(EFailThreadCreate);
+        }
+    }
+    glslang::OS_WaitForAllThreads(threads.data(), NumThreads);
+
+    // Report, in manifest order
+    printf("{\n  \"entries\": [\n");
+    for (size_t e = 0; e < entries.size(); ++e) {
+        TManifestEntry& entry = *entries[e];
+        if (entry.status == std::string("compile-failed") || entry.status == std::string("unreadable"))
+            CompileFailed = true;
+        else if (entry.status == std::string("link-failed"))
+            LinkFailed = true;
+
+        printf("    {\n      \"shader\": ");
+        PutJsonString(entry.name);
+        printf(",\n      \"stage\": \"%s\",\n      \"status\": \"%s\",\n      \"infoLog\": ", glslang::StageName(entry.stage), entry.status);
+        PutJsonString(entry.results);
+        printf(",\n      \"cached\": %s,\n      \"milliseconds\": {", entry.cached ? "true" : "false");
+        for (int phase = 0; phase < EPhaseCount; ++phase)
+            printf("%s \"%s\": %.3f", phase > 0 ? "," : "", ManifestPhaseNames[phase], entry.milliseconds[phase]);
+        printf(" }\n    }%s\n", e + 1 < entries.size() ? "," : "");
+
+        delete entries[e];
+    }
+    printf("  ],\n  \"threads\": %d,\n  \"milliseconds\": %.3f\n}\n", NumThreads, Milliseconds(start, TClock::now()));
+}
+
+//
+// Benchmark mode.
+//
+// Each file is taken through every phase, as its own single-shader program,
+// --bench <count> times.  The wall time of each phase is reported as the min,
+// median, 95th percentile and max over the runs, along with the most pool
+// memory the phase allocated in any one run.
+//
+
+enum TBenchPhase {
+    EBenchPreprocess,
+    EBenchParse,
+    EBenchLink,
+    EBenchReflection,
+    EBenchSpv,
+    EBenchRemap,
+    EBenchPhaseCount
+};
+
+const char* BenchPhaseNames[EBenchPhaseCount] = { "preprocess", "parse", "link", "buildReflection", "GlslangToSpv", "remap" };
+
+struct TBenchResults {
+    TBenchResults() : poolBytes(0) { }
+    std::vector<double> milliseconds;
+    size_t poolBytes;
+};
+
+//
+// Measures one phase of one run.  A phase that switches the thread to a new
+// pool (parsing, linking) is charged for everything in that new pool.
+//
+class TBenchTimer {
+public:
+    explicit TBenchTimer(TBenchResults& results) :
+        results(results), pool(&glslang::GetThreadPoolAllocator()), poolBytes(pool->getTotalBytes()), start(TClock::now()) { }
+
+    void stop()
+    {
+        results.milliseconds.push_back(Milliseconds(start, TClock::now()));
+
+        glslang::TPoolAllocator& current = glslang::GetThreadPoolAllocator();
+        size_t bytes = &current == pool ? current.getTotalBytes() - poolBytes : current.getTotalBytes();
+        results.poolBytes = std::max(results.poolBytes, bytes);
+    }
+
+protected:
+    TBenchResults& results;
+    glslang::TPoolAllocator* pool;
+    size_t poolBytes;
+    TClock::time_point start;
+};
+
+//
+// Returns the given percentile of the sorted samples.
+//
+double Percentile(const std::vector<double>& sorted, double percentile)
+{
+    size_t index = (size_t)ceil(percentile * sorted.size());
+
+    return sorted[index > 0 ? index - 1 : 0];
+}
+
+//
+// Run one file through all phases, BenchRuns times.
+//
+// Returns false if it doesn't compile and link, in which case there is nothing to time.
+//
+bool BenchmarkFile(const std::string& name, TBenchResults results[EBenchPhaseCount])
+{
+    TFileData file;
+    if (! ReadFileData(name.c_str(), file))
+        Error("unable to open input file");
+
+    EShLanguage stage = FindLanguage(name);
+    EShMessages messages = EShMsgDefault;
+    SetMessageOptions(messages);
+    const int defaultVersion = Options & EOptionDefaultDesktop? 110: 100;
+    glslang::TFileIncluder includer(name);
+
+    // Each run leaves its (by then deleted) pool as the thread's pool,
+    // so put back the thread's own after each.
+    glslang::TPoolAllocator& threadAllocator = glslang::GetThreadPoolAllocator();
+
+    bool success = true;
+    for (int run = 0; run < BenchRuns && success; ++run) {
+        {
+            glslang::TShader shader(stage);
+            shader.setStringsWithLengths(&file.data, &file.length, 1);
+            shader.setIncluder(&includer);
+            std::string preprocessed;
+            TBenchTimer timer(results[EBenchPreprocess]);
+            shader.preprocess(&Resources, defaultVersion, ENoProfile, false, false, messages, &preprocessed);
+            timer.stop();
+        }
+        glslang::SetThreadPoolAllocator(threadAllocator);
+
+        {
+            // the program has to go before the shader, see CompileAndLinkShaders()
+            glslang::TShader shader(stage);
+            glslang::TProgram program;
+            shader.setStringsWithLengths(&file.data, &file.length, 1);
+            shader.setIncluder(&includer);
+
+            TBenchTimer parseTimer(results[EBenchParse]);
+            success = shader.parse(&Resources, defaultVersion, false, messages);
+            parseTimer.stop();
+
+            program.addShader(&shader);
+            TBenchTimer linkTimer(results[EBenchLink]);
+            success = program.link(messages) && success;
+            linkTimer.stop();
+
+            if (success) {
+                TBenchTimer reflectionTimer(results[EBenchReflection]);
+                program.buildReflection();
+                reflectionTimer.stop();
+
+                std::vector<unsigned int> spirv;
+                TBenchTimer spvTimer(results[EBenchSpv]);
+                glslang::GlslangToSpv(*program.getIntermediate(stage), spirv);
+                spvTimer.stop();
+
+                TBenchTimer remapTimer(results[EBenchRemap]);
+                spv::spirvbin_t().remap(spirv);
+                remapTimer.stop();
+            } else if (! (Options & EOptionSuppressInfolog)) {
+                PutsIfNonEmpty(shader.getInfoLog());
+                PutsIfNonEmpty(program.getInfoLog());
+            }
+        }
+        glslang::SetThreadPoolAllocator(threadAllocator);
+    }
+
+    FreeFileData(file);
+
+    return success;
+}
+
+//
+// For benchmark mode: time each item in the worklist, and report on it.
+//
+void BenchmarkShaders()
+{
+    glslang::TWorkItem* workItem;
+    while (Worklist.remove(workItem)) {
+        TBenchResults results[EBenchPhaseCount];
+        if (! BenchmarkFile(workItem->name, results)) {
+            printf("%s: failed to compile and link; not benchmarked\n", workItem->name.c_str());
+            CompileFailed = true;
+            continue;
+        }
+
+        printf("%s: %d runs\n", workItem->name.c_str(), BenchRuns);
+        printf("    %-16s %10s %10s %10s %10s %12s\n", "phase (ms)", "min", "median", "p95", "max", "pool bytes");
+        for (int phase = 0; phase < EBenchPhaseCount; ++phase) {
+            std::vector<double>& times = results[phase].milliseconds;
+            std::sort(times.begin(), times.end());
+            printf("    %-16s %10.3f %10.3f %10.3f %10.3f %12lu\n", BenchPhaseNames[phase],
+                   times.front(), Percentile(times, 0.5), Percentile(times, 0.95), times.back(),
+                   (unsigned long)results[phase].poolBytes);
+        }
+    }
+}
+
 int C_DECL main(int argc, char* argv[])
 {
     ProcessArguments(argc, argv);
 
     if (Options & EOptionDumpConfig) {
-        printf("%s", DefaultConfig);
+        printf("%s", glslang::DefaultConfig);
         if (Worklist.empty())
             return ESuccess;
     }
@@ -792,18 +1207,60 @@ int C_DECL main(int argc, char* argv[])
             return ESuccess;
     }
 
-    if (Worklist.empty()) {
+    if (SaveBuiltinsFileName) {
+        glslang::InitializeProcess();
+        SaveBuiltins();
+        glslang::FinalizeProcess();
+        return ESuccess;
+    }
+
+    if (Worklist.empty() && ! ManifestFileName && ! ServerSocketName) {
         usage();
     }
 
-    ProcessConfigFile();
+    ProcessConfigFile(ConfigFile, Resources);
+
+    if (CacheDirectory) {
+        Cache = new glslang::TCompileCache(CacheDirectory, (size_t)CacheMegabytes << 20);
+        if (! Cache->open())
+            Error("unable to use the --cache directory");
+    }
+
+    if (LoadBuiltinsFileName) {
+        if (! glslang::LoadBuiltins(LoadBuiltinsFileName))
+            Error("unable to use the --load-builtins file");
+    }
+    else if (ParseBuiltins)
+        glslang::UnloadBuiltins();
 
     //
-    // Two modes:
+    // Five modes:
     // 1) linking all arguments together, single-threaded, new C++ interface
     // 2) independent arguments, can be tackled by multiple asynchronous threads, for testing thread safety, using the old handle interface
+    // 3) independent shaders listed in a manifest, tackled by multiple asynchronous threads, using the new C++ interface
+    // 4) independent arguments, each repeatedly taken through all phases for timing, single-threaded, new C++ interface
+    // 5) shaders sent over a socket by clients, served by multiple asynchronous threads until killed, new C++ interface
     //
-    if (Options & EOptionLinkProgram ||
+    if (ServerSocketName) {
+        glslang::InitializeProcess();
+        if (WarmVersions)
+            WarmBuiltins();
+        if (NumThreads == 0)
+            NumThreads = std::max((int)std::thread::hardware_concurrency(), 1);
+        if (! glslang::RunCompileServer(ServerSocketName, NumThreads, Resources, Cache))
+            CompileFailed = true;
+        glslang::FinalizeProcess();
+    } else if (ManifestFileName) {
+        glslang::InitializeProcess();
+        if (WarmVersions)
+            WarmBuiltins();
+        CompileManifest();
+        glslang::FinalizeProcess();
+    } else if (BenchRuns > 0) {
+        glslang::InitializeProcess();
+        BenchmarkShaders();
+        glslang::FinalizeProcess();
+    } else if (Options & EOptionLinkProgram ||
         Options & EOptionOutputPreprocessed) {
         glslang::InitializeProcess();
         CompileAndLinkShaders();
@@ -814,8 +1271,17 @@ int C_DECL main(int argc, char* argv[])
         bool printShaderNames = Worklist.size() > 1;
 
         if (Options & EOptionMultiThreaded) {
-            const int NumThreads = 16;
-            void* threads[NumThreads];
+            if (NumThreads == 0)
+                NumThreads = std::max((int)std::thread::hardware_concurrency(), 1);
+
+            // schedule the largest shaders first, so the tail of the run is the short ones
+            for (int w = 0; w < NumWorkItems; ++w) {
+                if (Work[w])
+                    Work[w]->cost = FileSize(Work[w]->name.c_str());
+            }
+            Worklist.distribute(NumThreads);
+
+            std::vector<void*> threads(NumThreads);
             for (int t = 0; t < NumThreads; ++t) {
                 threads[t] = glslang::OS_CreateThread(&CompileShaders);
                 if (! threads[t]) {
@@ -823,7 +1289,7 @@ int C_DECL main(int argc, char* argv[])
                     return EFailThreadCreate;
                 }
             }
-            glslang::OS_WaitForAllThreads(threads, NumThreads);
+            glslang::OS_WaitForAllThreads(threads.data(), NumThreads);
         } else
             CompileShaders(0);
 
@@ -840,6 +1306,8 @@ int C_DECL main(int argc, char* argv[])
         ShFinalize();
     }
 
+    delete Cache;
+
     if (CompileFailed)
         return EFailCompile;
     if (LinkFailed)
@@ -892,29 +1360,17 @@ EShLanguage FindLanguage(const std::string& name)
 void CompileFile(const char* fileName, ShHandle compiler)
 {
     int ret = 0;
-    char** shaderStrings = ReadFileData(fileName);
-    if (! shaderStrings) {
-        usage();
-    }
-
-    int* lengths = new int[NumShaderStrings];
-
-    // move to length-based strings, rather than null-terminated strings
-    for (int s = 0; s < NumShaderStrings; ++s)
-        lengths[s] = (int)strlen(shaderStrings[s]);
-
-    if (! shaderStrings) {
-        CompileFailed = true;
-        return;
-    }
+    TFileData file;
+    if (! ReadFileData(fileName, file))
+        Error("unable to open input file");
+    const int numStrings = file.length > 0 ? 1 : 0;
 
     EShMessages messages = EShMsgDefault;
     SetMessageOptions(messages);
     
     for (int i = 0; i < ((Options & EOptionMemoryLeakMode) ? 100 : 1); ++i) {
         for (int j = 0; j < ((Options & EOptionMemoryLeakMode) ? 100 : 1); ++j) {
-            //ret = ShCompile(compiler, shaderStrings, NumShaderStrings, lengths, EShOptNone, &Resources, Options, (Options & EOptionDefaultDesktop) ? 110 : 100, false, messages);
-            ret = ShCompile(compiler, shaderStrings, NumShaderStrings, nullptr, EShOptNone, &Resources, Options, (Options & EOptionDefaultDesktop) ? 110 : 100, false, messages);
+            ret = ShCompile(compiler, &file.data, numStrings, &file.length, EShOptNone, &Resources, Options, (Options & EOptionDefaultDesktop) ? 110 : 100, false, messages);
             //const char* multi[12] = { "# ve", "rsion", " 300 e", "s", "\n#err", 
             //                         "or should be l", "ine 1", "string 5\n", "float glo", "bal", 
             //                         ";\n#error should be line 2\n void main() {", "global = 2.3;}" };
@@ -926,8 +1382,7 @@ void CompileFile(const char* fileName, ShHandle compiler)
             glslang::OS_DumpMemoryCounters();
     }
 
-    delete [] lengths;
-    FreeFileData(shaderStrings);
+    FreeFileData(file);
 
     if (ret == 0)
         CompileFailed = true;
@@ -952,6 +1407,10 @@ void usage()
            "\n"
            "Compilation warnings and errors will be printed to stdout.\n"
            "\n"
+           "#include \"file\" is found relative to the file containing it.  It is an\n"
+           "error when files are compiled separately with the old interface, i.e.,\n"
+           "without -l, -E, -V, -G, --bench, --manifest, or --server.\n"
+           "\n"
            "To get other information, use one of the following options:\n"
            "Each option must be specified separately.\n"
            "  -V          create SPIR-V binary, under Vulkan semantics; turns on -l;\n"
@@ -974,7 +1433,45 @@ void usage()
            "  -q          dump reflection query database\n"
            "  -r          relaxed semantic error-checking mode\n"
            "  -s          silent mode\n"
-           "  -t          multi-threaded mode\n"
+           "  -t          multi-threaded mode, one thread per hardware thread;\n"
+           "              with -l, parses all the stages concurrently before linking\n"
+           "  --threads <count>\n"
+           "              multi-threaded mode, using <count> threads\n"
+           "  --bench <count>\n"
+           "              run each file through all phases <count> times, and print\n"
+           "              the min, median, 95th percentile and max time of each phase\n"
+           "  --manifest <file>\n"
+           "              compile each shader listed in <file>, one per line as\n"
+           "              <shader file> <stage> <config file> <default version> <output file>\n"
+           "              ('-' for a default), on a pool of threads, printing a JSON report\n"
+           "  --warm <versions>\n"
+           "              with --server or --manifest, first set up the built-ins of each\n"
+           "              of a comma-separated list of versions, concurrently, where each\n"
+           "              version can have a profile suffix (e.g., 100,300es,330,450core);\n"
+           "              with --save-builtins, the versions to save\n"
+           "  --save-builtins <file>\n"
+           "              write the built-ins of the --warm versions (default all) to\n"
+           "              <file>, for --load-builtins, and compile nothing\n"
+           "  --load-builtins <file>\n"
+           "              read the built-ins from a --save-builtins <file> of this same\n"
+           "              build, rather than parsing them\n"
+           "  --parse-builtins\n"
+           "              parse the built-ins, rather than reading those generated by the\n"
+           "              build (if it did)\n"
+           "  --dependencies\n"
+           "              with -l or -E, print the files each shader brought in through\n"
+           "              #include, as '<shader>: <file> ...'\n"
+           "  --cache <directory>\n"
+           "              keep compile results in <directory>, keyed by the sources and\n"
+           "              everything else that affects them, and reuse them instead of\n"
+           "              recompiling; for -l, -V, --manifest, and --server\n"
+           "  --cache-size <megabytes>\n"
+           "              evict least recently used --cache entries beyond <megabytes>\n"
+           "              (default is 256)\n"
+           "  --server <socket>\n"
+           "              serve compile requests from glslangClient on the local socket\n"
+           "              <socket>, one thread per hardware thread (or --threads <count>),\n"
+           "              until killed; a .conf file sets the default configuration\n"
            "  -v          print version strings\n"
            "  -w          suppress warnings (except as required by #extension : warn)\n"
            );
@@ -1012,79 +1509,110 @@ int fopen_s(
 #endif
 
 //
-//   Malloc a string of sufficient size and read a string into it.
+//   Map a file into memory, read-only, for handing straight to the compiler with
+//   an explicit length.  Nothing is copied; the pages are read in as the scanner
+//   touches them.
 //
-char** ReadFileData(const char* fileName) 
+//   Returns false if the file can't be opened or mapped, or is longer than
+//   the compiler's int string lengths can describe.
+//
+bool ReadFileData(const char* fileName, TFileData& file)
 {
-    FILE *in = nullptr;
-    int errorCode = fopen_s(&in, fileName, "r");
+    file = TFileData();
 
-    int count = 0;
-    const int maxSourceStrings = 5;  // for testing splitting shader/tokens across multiple strings
-    char** return_data = (char**)malloc(sizeof(char *) * (maxSourceStrings+1)); // freed in FreeFileData()
+#ifdef _WIN32
+    HANDLE in = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if (in == INVALID_HANDLE_VALUE)
+        return false;
 
-    if (errorCode || in == nullptr)
-        Error("unable to open input file");
-    
-    while (fgetc(in) != EOF)
-        count++;
+    LARGE_INTEGER size;
+    if (! GetFileSizeEx(in, &size)) {
+        CloseHandle(in);
+        return false;
+    }
+    if (size.QuadPart == 0) {
+        // recover from empty file; there is nothing to map
+        CloseHandle(in);
+        return true;
+    }
+    if (size.QuadPart > INT_MAX) {
+        CloseHandle(in);
+        return false;
+    }
 
-    fseek(in, 0, SEEK_SET);
+    HANDLE mapping = CreateFileMappingA(in, 0, PAGE_READONLY, 0, 0, 0);
+    CloseHandle(in);
+    if (mapping == 0)
+        return false;
 
-    char *fdata = (char*)malloc(count+2); // freed before return of this function
-    if (! fdata)
-        Error("can't allocate memory");
+    const char* data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == 0)
+        return false;
+
+    file.data = data;
+    file.length = (int)size.QuadPart;
+    file.mapping = (void*)data;
+#else
+    int in = open(fileName, O_RDONLY);
+    if (in < 0)
+        return false;
 
-    if ((int)fread(fdata, 1, count, in) != count) {
-        free(fdata);
-        Error("can't read input file");
+    struct stat status;
+    if (fstat(in, &status) != 0) {
+        close(in);
+        return false;
+    }
+    if (status.st_size == 0) {
+        // recover from empty file; there is nothing to map
+        close(in);
+        return true;
+    }
+    if (status.st_size > INT_MAX) {
+        close(in);
+        return false;
     }
 
-    fdata[count] = '\0';
-    fclose(in);
+    void* data = mmap(0, status.st_size, PROT_READ, MAP_PRIVATE, in, 0);
+    close(in);
+    if (data == MAP_FAILED)
+        return false;
 
-    if (count == 0) {
-        // recover from empty file
-        return_data[0] = (char*)malloc(count+2);  // freed in FreeFileData()
-        return_data[0][0]='\0';
-        NumShaderStrings = 0;
-        free(fdata);
+    file.data = (const char*)data;
+    file.length = (int)status.st_size;
+    file.mapping = data;
+#endif
 
-        return return_data;
-    } else
-        NumShaderStrings = 1;  // Set to larger than 1 for testing multiple strings
-
-    // compute how to split up the file into multiple strings, for testing multiple strings
-    int len = (int)(ceil)((float)count/(float)NumShaderStrings);
-    int ptr_len = 0;
-    int i = 0;
-    while (count > 0) {
-        return_data[i] = (char*)malloc(len + 2);  // freed in FreeFileData()
-        memcpy(return_data[i], fdata + ptr_len, len);
-        return_data[i][len] = '\0';
-        count -= len;
-        ptr_len += len;
-        if (count < len) {
-            if (count == 0) {
-               NumShaderStrings = i + 1;
-               break;
-            }
-            len = count;
-        }  
-        ++i;
-    }
+    return true;
+}
 
-    free(fdata);
+void FreeFileData(TFileData& file)
+{
+    if (file.mapping) {
+#ifdef _WIN32
+        UnmapViewOfFile(file.mapping);
+#else
+        munmap(file.mapping, file.length);
+#endif
+    }
 
-    return return_data;
+    file = TFileData();
 }
 
-void FreeFileData(char** data)
+//
+//   Size of a file in bytes, or 0 if it can't be opened.
+//
+long FileSize(const char* fileName)
 {
-    for(int i = 0; i < NumShaderStrings; i++)
-        free(data[i]);
+    FILE *in = nullptr;
+    if (fopen_s(&in, fileName, "rb") || in == nullptr)
+        return 0;
+
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in);
+    fclose(in);
 
-    free(data);
+    return size;
 }
 
 void InfoLogMsg(const char* msg, const char* name, const int num)
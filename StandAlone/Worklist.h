@@ -38,59 +38,137 @@
 #include "osinclude.h"
 #include <string>
 #include <list>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
 
 namespace glslang {
 
     class TWorkItem {
     public:
-        TWorkItem() { }
+        TWorkItem() : cost(0) { }
         explicit TWorkItem(const std::string& s) :
-            name(s) { }
+            name(s), cost(0) { }
         std::string name;
         std::string results;
         std::string resultsIndex;
+        long cost;              // estimated work (e.g., source size), used to schedule largest-first
     };
 
+    //
+    // Thread-safe set of work items.
+    //
+    // Items are added to a single queue and, without distribute(), are removed in
+    // the order they were added.
+    //
+    // For multi-threaded processing, distribute() sorts the items largest-cost first
+    // and deals them out round-robin over one deque per thread.  Each thread then
+    // takes from the front of its own deque, and when that runs dry, steals from
+    // the back of another thread's deque.  Each deque has its own lock, so threads
+    // only contend with each other when stealing.
+    //
     class TWorklist {
     public:
-        TWorklist() { }
+        TWorklist() : queues(1), nextQueue(0) { }
         virtual ~TWorklist() { }
 
         void add(TWorkItem* item)
         {
-            GetGlobalLock();
-            
-            worklist.push_back(item);
-            
-            ReleaseGlobalLock();
+            std::lock_guard<std::mutex> guard(queues[0].lock);
+
+            queues[0].items.push_back(item);
+        }
+
+        // Not thread safe; call before any threads start removing items.
+        void distribute(int numThreads)
+        {
+            std::vector<TWorkItem*> items;
+            for (size_t q = 0; q < queues.size(); ++q)
+                items.insert(items.end(), queues[q].items.begin(), queues[q].items.end());
+            std::stable_sort(items.begin(), items.end(),
+                             [](const TWorkItem* a, const TWorkItem* b) { return a->cost > b->cost; });
+
+            queues = std::vector<TQueue>(std::max(numThreads, 1));
+            for (size_t i = 0; i < items.size(); ++i)
+                queues[i % queues.size()].items.push_back(items[i]);
+            nextQueue = 0;
         }
-    
+
+        // Each calling thread gets its own queue, until there are no more.
+        int claimQueue()
+        {
+            return nextQueue++ % (int)queues.size();
+        }
+
+        // Take from the front of the first queue; for single-threaded use.
         bool remove(TWorkItem*& item)
         {
-            GetGlobalLock();
-            
-            if (worklist.empty())
-                return false;
-            item = worklist.front();
-            worklist.pop_front();
-            
-            ReleaseGlobalLock();
-
-            return true;
+            return remove(item, 0);
+        }
+
+        // Take from the front of the given queue, or failing that, steal from the back
+        // of another queue.  Returns false only when all queues are empty.
+        bool remove(TWorkItem*& item, int queue)
+        {
+            if (queues[queue].popFront(item))
+                return true;
+
+            for (size_t victim = 1; victim < queues.size(); ++victim) {
+                if (queues[(queue + victim) % queues.size()].popBack(item))
+                    return true;
+            }
+
+            return false;
         }
 
         int size()
         {
-            return (int)worklist.size();
+            int count = 0;
+            for (size_t q = 0; q < queues.size(); ++q) {
+                std::lock_guard<std::mutex> guard(queues[q].lock);
+                count += (int)queues[q].items.size();
+            }
+
+            return count;
         }
 
         bool empty()
         {
-            return worklist.empty();
+            return size() == 0;
         }
 
     protected:
-        std::list<TWorkItem*> worklist;
+        struct TQueue {
+            bool popFront(TWorkItem*& item)
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                if (items.empty())
+                    return false;
+                item = items.front();
+                items.pop_front();
+
+                return true;
+            }
+
+            bool popBack(TWorkItem*& item)
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                if (items.empty())
+                    return false;
+                item = items.back();
+                items.pop_back();
+
+                return true;
+            }
+
+            std::deque<TWorkItem*> items;
+            std::mutex lock;
+        };
+
+        std::vector<TQueue> queues;
+        std::atomic<int> nextQueue;
     };
 
 } // end namespace glslang
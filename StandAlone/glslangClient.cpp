@@ -0,0 +1,285 @@
+//
+//Copyright (C) 2015 LunarG, Inc.
+//
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions
+//are met:
+//
+//    Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//    Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//    Neither the name of 3Dlabs Inc. Ltd. nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+//INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//POSSIBILITY OF SUCH DAMAGE.
+//
+
+//
+// Thin client for glslangValidator --server: sends one shader to the server
+// and reports the results as glslangValidator would, without paying for any
+// compiler startup itself.
+//
+// Only uses the protocol in CompileServer.h; doesn't link with glslang.
+//
+
+#include "CompileServer.h"
+#include "ResourceLimits.h"
+#include "./../glslang/Public/ShaderLang.h"
+
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+namespace {
+
+// Same exit codes as glslangValidator.
+enum TFailCode {
+    ESuccess = 0,
+    EFailUsage,
+    EFailCompile,
+    EFailLink,
+    EFailCompilerCreate,
+    EFailThreadCreate,
+    EFailLinkerCreate
+};
+
+const char* StageNames[EShLangCount] = { "vert", "tesc", "tese", "geom", "frag", "comp" };
+
+void usage()
+{
+    printf("Usage: glslangClient <socket> [option]... [<config>] <file>\n"
+           "\n"
+           "Compiles <file> on the glslangValidator --server listening on <socket>.\n"
+           "'file' ends in .<stage>, as for glslangValidator.  'config' is a .conf\n"
+           "file to compile with, as for glslangValidator; without one, the server's\n"
+           "configuration is used.\n"
+           "\n"
+           "  -V          create SPIR-V binary, under Vulkan semantics\n"
+           "  -G          create SPIR-V binary, under OpenGL semantics\n"
+           "  -o  <file>  save binary into <file>, requires -V or -G;\n"
+           "              default file name is <stage>.spv\n"
+           "  -d          default to desktop (#version 110) when there is no shader #version\n"
+           "  -q          dump reflection query database\n"
+           "  -r          relaxed semantic error-checking mode\n"
+           "  -s          silent mode\n"
+           "  -w          suppress warnings\n"
+           );
+
+    exit(EFailUsage);
+}
+
+void Error(const char* message)
+{
+    printf("glslangClient: Error %s\n", message);
+    exit(EFailUsage);
+}
+
+int FindStage(const std::string& name)
+{
+    size_t ext = name.rfind('.');
+    if (ext == std::string::npos)
+        return -1;
+
+    for (int stage = 0; stage < EShLangCount; ++stage) {
+        if (name.compare(ext + 1, std::string::npos, StageNames[stage]) == 0)
+            return stage;
+    }
+
+    return -1;
+}
+
+bool ReadFile(const char* fileName, std::vector<char>& contents)
+{
+    FILE* in = fopen(fileName, "rb");
+    if (! in)
+        return false;
+
+    char buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), in)) > 0)
+        contents.insert(contents.end(), buffer, buffer + count);
+    fclose(in);
+
+    return true;
+}
+
+} // end anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+        usage();
+
+    const char* socketName = argv[1];
+    const char* fileName = nullptr;
+    const char* configFileName = nullptr;
+    const char* binaryFileName = nullptr;
+    bool silent = false;
+    bool spv = false;
+
+    glslang::TCompileRequestHeader request;
+    memset(&request, 0, sizeof(request));
+    request.magic = glslang::CompileServerMagic;
+    request.version = glslang::CompileServerVersion;
+    request.defaultVersion = 100;
+    request.messages = EShMsgDefault;
+    request.flags = glslang::ECompileRequestServerResources;
+
+    for (argc -= 2, argv += 2; argc > 0; argc--, argv++) {
+        if (argv[0][0] != '-') {
+            size_t length = strlen(argv[0]);
+            if (length > 5 && strcmp(argv[0] + length - 5, ".conf") == 0) {
+                configFileName = argv[0];
+                continue;
+            }
+            if (fileName)
+                Error("only one file can be compiled per request");
+            fileName = argv[0];
+            continue;
+        }
+
+        switch (argv[0][1]) {
+        case 'V':
+            spv = true;
+            request.messages |= EShMsgSpvRules | EShMsgVulkanRules;
+            break;
+        case 'G':
+            spv = true;
+            request.messages |= EShMsgSpvRules;
+            break;
+        case 'o':
+            if (argc < 2)
+                Error("no <file> provided for -o");
+            binaryFileName = argv[1];
+            argc--;
+            argv++;
+            break;
+        case 'd':
+            request.defaultVersion = 110;
+            break;
+        case 'q':
+            request.flags |= glslang::ECompileRequestReflection;
+            break;
+        case 'r':
+            request.messages |= EShMsgRelaxedErrors;
+            break;
+        case 's':
+            silent = true;
+            break;
+        case 'w':
+            request.messages |= EShMsgSuppressWarnings;
+            break;
+        default:
+            usage();
+        }
+    }
+
+    if (! fileName)
+        usage();
+    if (binaryFileName && ! spv)
+        Error("no binary generation requested (e.g., -V)");
+    if (spv)
+        request.flags |= glslang::ECompileRequestSpv;
+
+    if (configFileName) {
+        std::vector<char> config;
+        if (! ReadFile(configFileName, config))
+            Error("unable to open configuration file");
+        config.push_back('\0');
+        glslang::DecodeResourceLimits(request.resources, &config[0]);
+        request.flags &= ~glslang::ECompileRequestServerResources;
+    }
+
+    request.stage = FindStage(fileName);
+    if (request.stage < 0)
+        Error("can't tell the stage from the file extension");
+
+    std::vector<char> source;
+    if (! ReadFile(fileName, source))
+        Error("unable to open input file");
+    if (source.size() > glslang::MaxCompileRequestSource)
+        Error("input file is too large for the server");
+    request.sourceLength = (unsigned int)source.size();
+
+    // the server has its own working directory; it resolves #include against the full path
+    char* resolved = realpath(fileName, nullptr);
+    if (! resolved)
+        Error("unable to find the input file's path");
+    std::string path = resolved;
+    free(resolved);
+    if (path.size() > glslang::MaxCompileRequestName)
+        Error("input file's path is too long for the server");
+    request.nameLength = (unsigned int)path.size();
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socketName) >= sizeof(address.sun_path))
+        Error("socket path is too long");
+    strcpy(address.sun_path, socketName);
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0 || connect(server, (sockaddr*)&address, sizeof(address)) != 0) {
+        perror(socketName);
+        return EFailCompilerCreate;
+    }
+
+    glslang::TCompileResponseHeader response;
+    if (! glslang::WriteFully(server, &request, sizeof(request)) ||
+        ! glslang::WriteFully(server, path.data(), path.size()) ||
+        (source.size() > 0 && ! glslang::WriteFully(server, &source[0], source.size())) ||
+        ! glslang::ReadFully(server, &response, sizeof(response)) ||
+        response.magic != glslang::CompileServerMagic)
+        Error("lost the connection to the server");
+
+    std::string infoLog(response.infoLogLength, '\0');
+    std::vector<unsigned int> spirv(response.spirvWords);
+    std::string reflection(response.reflectionLength, '\0');
+    if ((infoLog.size() > 0 && ! glslang::ReadFully(server, &infoLog[0], infoLog.size())) ||
+        (spirv.size() > 0 && ! glslang::ReadFully(server, &spirv[0], spirv.size() * sizeof(unsigned int))) ||
+        (reflection.size() > 0 && ! glslang::ReadFully(server, &reflection[0], reflection.size())))
+        Error("lost the connection to the server");
+    close(server);
+
+    if (! silent) {
+        fputs(infoLog.c_str(), stdout);
+        fputs(reflection.c_str(), stdout);
+    }
+
+    if (spirv.size() > 0) {
+        std::string outputName = binaryFileName ? binaryFileName : std::string(StageNames[request.stage]) + ".spv";
+        FILE* out = fopen(outputName.c_str(), "wb");
+        if (! out)
+            Error("unable to open output file");
+        fwrite(&spirv[0], sizeof(unsigned int), spirv.size(), out);
+        fclose(out);
+    }
+
+    return response.success ? ESuccess : EFailCompile;
+}
@@ -0,0 +1,10 @@
+#version 450
+
+#include "include.h"
+
+out vec4 color;
+
+void main()
+{
+    color = scaled(vec4(NESTED));
+}
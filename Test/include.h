@@ -0,0 +1,16 @@
+// shared by the #include tests; guarded, so including it twice is harmless
+#ifndef INCLUDE_H
+#define INCLUDE_H
+
+#define SCALE 2.0
+
+uniform vec4 tint;
+
+vec4 scaled(vec4 v)
+{
+    return v * SCALE + tint;
+}
+
+#include "includeNested.h"
+
+#endif
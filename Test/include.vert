@@ -0,0 +1,11 @@
+#version 450
+
+#include "include.h"
+#include "include.h"
+
+in vec4 p;
+
+void main()
+{
+    gl_Position = scaled(p) * nested();
+}
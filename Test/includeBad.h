@@ -0,0 +1,3 @@
+// an error is reported at its line in this file
+
+float bad = undeclared;
@@ -0,0 +1,7 @@
+// reached from includeRelative.frag; its own #include is relative to this directory
+#include "inc2.h"
+
+vec4 inner()
+{
+    return vec4(innermost);
+}
@@ -0,0 +1,2 @@
+// only found relative to includeDir/inc1.h, not to the shader
+const float innermost = 0.5;
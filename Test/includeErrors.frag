@@ -0,0 +1,12 @@
+#version 450
+
+#include "missing.h"
+#include notQuoted.h
+#include "include.h" extra
+#include
+#include "includeRecurse.h"
+#include "includeBad.h"
+
+void main()
+{
+}
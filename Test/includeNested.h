@@ -0,0 +1,5 @@
+#define NESTED 3
+
+#if NESTED > 2
+float nested() { return float(NESTED); }
+#endif
\ No newline at end of file
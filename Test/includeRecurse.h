@@ -0,0 +1 @@
+#include "includeRecurse.h"
@@ -0,0 +1,10 @@
+#version 450
+
+#include "includeDir/inc1.h"
+
+out vec4 color;
+
+void main()
+{
+    color = inner();
+}
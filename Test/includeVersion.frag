@@ -0,0 +1,8 @@
+#version 110
+
+#include "includeVersion.h"
+
+void main()
+{
+    gl_FragColor = vec4(k);
+}
@@ -0,0 +1,3 @@
+// Included from shaders of different versions: the 'f' suffix is
+// only allowed from version 120 on, or 300 es.
+float k = 1.0f;
@@ -0,0 +1,8 @@
+#version 450
+
+#include "includeVersion.h"
+
+void main()
+{
+    gl_Position = vec4(k);
+}
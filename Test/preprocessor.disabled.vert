@@ -0,0 +1,41 @@
+#version 310 es
+
+// What disabled text can hide from the preprocessor, and what it can't
+
+#if 0
+int a = 1; /* a comment hides this
+#endif
+   */ int b;
+  #  define FOO 1
+int c = 0x123456789abcdef 99999999999999999999 1.e; // bad numbers are not looked at
+// a comment hides this line too, by continuation \
+#endif
+/* leading comment */ #ifdef NESTED
+   garbage
+#else
+#endif
+int d; \
+#endif
+   /**/ # /* comment in directive */ else
+int live1 = __LINE__;
+#endif
+
+#ifdef UNDEFINED
+#elif 1
+int live2 = __LINE__;
+#else
+int dead; /* comment over
+two lines */ int more;
+#endif
+int live3 = __LINE__;
+
+#if 1
+int live4 = __LINE__;
+#else
+# if 0
+# endif
+*/ /**/ # endif
+#endif
+int live5 = __LINE__;
+
+void main() {}
@@ -0,0 +1,9 @@
+#version 310 es
+
+#include "include.h"
+
+#ifdef INCLUDE_H
+int main() {
+  gl_Position = scaled(vec4(SCALE)) * NESTED;
+}
+#endif
@@ -67,6 +67,7 @@
 #include <algorithm>
 #include <string>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 
 #include "PoolAlloc.h"
@@ -118,6 +119,28 @@ namespace std {
 
 namespace glslang {
 
+//
+// Hash and compare the characters, not the pointers, so a token's text can be
+// looked up in a process-wide table without first building a string object
+// from it.
+//
+struct TCharStringHash {
+    size_t operator()(const char* s) const
+    {
+        unsigned val = 2166136261U;
+        for (; *s; ++s) {
+            val ^= (unsigned char)*s;
+            val *= 16777619U;
+        }
+
+        return val;
+    }
+};
+
+struct TCharStringEqual {
+    bool operator()(const char* left, const char* right) const { return strcmp(left, right) == 0; }
+};
+
 inline TString* NewPoolTString(const char* s)
 {
     void* memory = GetThreadPoolAllocator().allocate(sizeof(TString));
@@ -152,11 +175,11 @@ template <class T> class TList  : public std::list<T, pool_allocator<T> > {
 };
 
 template <class K, class D, class CMP = std::less<K> > 
-class TMap : public std::map<K, D, CMP, pool_allocator<std::pair<K, D> > > {
+class TMap : public std::map<K, D, CMP, pool_allocator<std::pair<K const, D> > > {
 };
 
 template <class K, class D, class HASH = std::hash<K>, class PRED = std::equal_to<K> >
-class TUnorderedMap : public std::unordered_map<K, D, HASH, PRED, pool_allocator<std::pair<K, D> > > {
+class TUnorderedMap : public std::unordered_map<K, D, HASH, PRED, pool_allocator<std::pair<K const, D> > > {
 };
 
 //
@@ -189,10 +212,11 @@ inline const TString String(const int i, const int base = 10)
 }
 
 struct TSourceLoc {
-    void init() { string = 0; line = 0; column = 0; }
+    void init() { string = 0; line = 0; column = 0; name = 0; }
     int string;
     int line;
     int column;
+    const TString* name;    // file the line is in, when not one of the shader's strings, e.g., from #include
 };
 
 typedef TMap<TString, TString> TPragmaTable;
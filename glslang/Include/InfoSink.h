@@ -84,6 +84,7 @@ public:
     TInfoSinkBase& operator<<(const TString& t)        { append(t); return *this; }
     TInfoSinkBase& operator+(const char* s)            { append(s); return *this; }
     const char* c_str() const { return sink.c_str(); }
+    size_t size() const { return sink.size(); }
     void prefix(TPrefixType message) {
         switch(message) {
         case EPrefixNone:                                      break;
@@ -98,7 +99,11 @@ public:
     void location(TSourceLoc loc) {
 	    const int maxSize = 24;
         char locText[maxSize];
-        snprintf(locText, maxSize, "%d:%d", loc.string, loc.line);
+        if (loc.name) {
+            append(*loc.name);
+            snprintf(locText, maxSize, ":%d", loc.line);
+        } else
+            snprintf(locText, maxSize, "%d:%d", loc.string, loc.line);
         append(locText);
         append(": ");
     }
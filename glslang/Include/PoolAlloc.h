@@ -176,6 +176,12 @@ public:
     //
     void* allocate(size_t numBytes);
 
+    //
+    // Total bytes ever requested through allocate(), including those since
+    // freed by pop().
+    //
+    size_t getTotalBytes() const { return totalBytes; }
+
     //
     // There is no deallocate.  The point of this class is that
     // deallocation can be skipped by the user of it, as the model
@@ -945,28 +945,15 @@ public:
 
     void deepCopy(const TType& copyOf)
     {
-        shallowCopy(copyOf);
-
-        if (copyOf.arraySizes) {
-            arraySizes = new TArraySizes;
-            *arraySizes = *copyOf.arraySizes;
-        }
-
-        if (copyOf.structure) {
-            structure = new TTypeList;
-            for (unsigned int i = 0; i < copyOf.structure->size(); ++i) {
-                TTypeLoc typeLoc;
-                typeLoc.loc = (*copyOf.structure)[i].loc;
-                typeLoc.type = new TType();
-                typeLoc.type->deepCopy(*(*copyOf.structure)[i].type);
-                structure->push_back(typeLoc);
-            }
-        }
+        copyContents(copyOf, true);
+    }
 
-        if (copyOf.fieldName)
-            fieldName = NewPoolTString(copyOf.fieldName->c_str());
-        if (copyOf.typeName)
-            typeName = NewPoolTString(copyOf.typeName->c_str());
+    // Like deepCopy(), but for copying from a read-only type that outlives the
+    // copy, like a shared built-in.  Only the parts an edit can change are copied;
+    // the names are never edited in place, so are still shared with the original.
+    void editableCopy(const TType& copyOf)
+    {
+        copyContents(copyOf, false);
     }
     
     TType* clone()
@@ -1397,12 +1384,43 @@ public:
     }
 
 protected:
+    friend class TSymbolTableWriter;
+    friend class TSymbolTableReader;
+
     // Require consumer to pick between deep copy and shallow copy.
     TType(const TType& type);
     TType& operator=(const TType& type);
 
     void buildMangledName(TString&);
 
+    void copyContents(const TType& copyOf, bool copyNames)
+    {
+        shallowCopy(copyOf);
+
+        if (copyOf.arraySizes) {
+            arraySizes = new TArraySizes;
+            *arraySizes = *copyOf.arraySizes;
+        }
+
+        if (copyOf.structure) {
+            structure = new TTypeList;
+            for (unsigned int i = 0; i < copyOf.structure->size(); ++i) {
+                TTypeLoc typeLoc;
+                typeLoc.loc = (*copyOf.structure)[i].loc;
+                typeLoc.type = new TType();
+                typeLoc.type->copyContents(*(*copyOf.structure)[i].type, copyNames);
+                structure->push_back(typeLoc);
+            }
+        }
+
+        if (copyNames) {
+            if (copyOf.fieldName)
+                fieldName = NewPoolTString(copyOf.fieldName->c_str());
+            if (copyOf.typeName)
+                typeName = NewPoolTString(copyOf.typeName->c_str());
+        }
+    }
+
     TBasicType basicType : 8;
     int vectorSize       : 4;
     int matrixCols       : 4;
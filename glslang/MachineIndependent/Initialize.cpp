@@ -1915,34 +1915,34 @@ void TBuiltIns::addQueryFunctions(TSampler sampler, TString& typeName, int versi
         return;
 
     if (profile == EEsProfile)
-        commonBuiltins.append("highp ");
+        commonFunctions.append("highp ");
     int dims = dimMap[sampler.dim] + (sampler.arrayed ? 1 : 0) - (sampler.dim == EsdCube ? 1 : 0);
     if (dims == 1)
-        commonBuiltins.append("int");
+        commonFunctions.append("int");
     else {
-        commonBuiltins.append("ivec");
-        commonBuiltins.append(postfixes[dims]);
+        commonFunctions.append("ivec");
+        commonFunctions.append(postfixes[dims]);
     }
     if (sampler.image)
-        commonBuiltins.append(" imageSize(readonly writeonly volatile coherent ");
+        commonFunctions.append(" imageSize(readonly writeonly volatile coherent ");
     else
-        commonBuiltins.append(" textureSize(");
-    commonBuiltins.append(typeName);
+        commonFunctions.append(" textureSize(");
+    commonFunctions.append(typeName);
     if (! sampler.image && sampler.dim != EsdRect && sampler.dim != EsdBuffer && ! sampler.ms)
-        commonBuiltins.append(",int);\n");
+        commonFunctions.append(",int);\n");
     else
-        commonBuiltins.append(");\n");
+        commonFunctions.append(");\n");
 
     // GL_ARB_shader_texture_image_samples
     // TODO: spec issue? there are no memory qualifiers; how to query a writeonly/readonly image, etc?
     if (profile != EEsProfile && version >= 430 && sampler.ms) {
-        commonBuiltins.append("int ");
+        commonFunctions.append("int ");
         if (sampler.image)
-            commonBuiltins.append("imageSamples(readonly writeonly volatile coherent ");
+            commonFunctions.append("imageSamples(readonly writeonly volatile coherent ");
         else
-            commonBuiltins.append("textureSamples(");
-        commonBuiltins.append(typeName);
-        commonBuiltins.append(");\n");
+            commonFunctions.append("textureSamples(");
+        commonFunctions.append(typeName);
+        commonFunctions.append(");\n");
     }
 }
 
@@ -1965,16 +1965,16 @@ void TBuiltIns::addImageFunctions(TSampler sampler, TString& typeName, int versi
     if (sampler.ms)
         imageParams.append(", int");
 
-    commonBuiltins.append(prefixes[sampler.type]);
-    commonBuiltins.append("vec4 imageLoad(readonly volatile coherent ");
-    commonBuiltins.append(imageParams);
-    commonBuiltins.append(");\n");
+    commonFunctions.append(prefixes[sampler.type]);
+    commonFunctions.append("vec4 imageLoad(readonly volatile coherent ");
+    commonFunctions.append(imageParams);
+    commonFunctions.append(");\n");
 
-    commonBuiltins.append("void imageStore(writeonly volatile coherent ");
-    commonBuiltins.append(imageParams);
-    commonBuiltins.append(", ");
-    commonBuiltins.append(prefixes[sampler.type]);
-    commonBuiltins.append("vec4);\n");
+    commonFunctions.append("void imageStore(writeonly volatile coherent ");
+    commonFunctions.append(imageParams);
+    commonFunctions.append(", ");
+    commonFunctions.append(prefixes[sampler.type]);
+    commonFunctions.append("vec4);\n");
 
     if (profile != EEsProfile) {
         if (sampler.type == EbtInt || sampler.type == EbtUint) {
@@ -1993,30 +1993,30 @@ void TBuiltIns::addImageFunctions(TSampler sampler, TString& typeName, int versi
             }; 
 
             for (size_t i = 0; i < numBuiltins; ++i) {
-                commonBuiltins.append(dataType);
-                commonBuiltins.append(atomicFunc[i]);
-                commonBuiltins.append(imageParams);
-                commonBuiltins.append(", ");
-                commonBuiltins.append(dataType);
-                commonBuiltins.append(");\n");
+                commonFunctions.append(dataType);
+                commonFunctions.append(atomicFunc[i]);
+                commonFunctions.append(imageParams);
+                commonFunctions.append(", ");
+                commonFunctions.append(dataType);
+                commonFunctions.append(");\n");
             }
 
-            commonBuiltins.append(dataType);
-            commonBuiltins.append(" imageAtomicCompSwap(volatile coherent ");
-            commonBuiltins.append(imageParams);
-            commonBuiltins.append(", ");
-            commonBuiltins.append(dataType);
-            commonBuiltins.append(", ");
-            commonBuiltins.append(dataType);
-            commonBuiltins.append(");\n");
+            commonFunctions.append(dataType);
+            commonFunctions.append(" imageAtomicCompSwap(volatile coherent ");
+            commonFunctions.append(imageParams);
+            commonFunctions.append(", ");
+            commonFunctions.append(dataType);
+            commonFunctions.append(", ");
+            commonFunctions.append(dataType);
+            commonFunctions.append(");\n");
         } else {
             // not int or uint
             // GL_ARB_ES3_1_compatibility
             // TODO: spec issue: are there restrictions on the kind of layout() that can be used?  what about dropping memory qualifiers?
             if (version >= 450) {
-                commonBuiltins.append("float imageAtomicExchange(volatile coherent ");
-                commonBuiltins.append(imageParams);
-                commonBuiltins.append(", float);\n");
+                commonFunctions.append("float imageAtomicExchange(volatile coherent ");
+                commonFunctions.append(imageParams);
+                commonFunctions.append(", float);\n");
             }
         }
     }
@@ -2188,9 +2188,9 @@ void TBuiltIns::addSamplingFunctions(TSampler sampler, TString& typeName, int /*
                                 // Add to the per-language set of built-ins
 
                                 if (bias)
-                                    stageBuiltins[EShLangFragment].append(s);
+                                    stageFunctions[EShLangFragment].append(s);
                                 else
-                                    commonBuiltins.append(s);
+                                    commonFunctions.append(s);
                             }
                         }
                     }
@@ -2277,7 +2277,7 @@ void TBuiltIns::addGatherFunctions(TSampler sampler, TString& typeName, int vers
                 s.append(",int");
 
             s.append(");\n");
-            commonBuiltins.append(s);
+            commonFunctions.append(s);
             //printf("%s", s.c_str());
         }
     }
@@ -2730,7 +2730,8 @@ void TBuiltIns::initialize(const TBuiltInResource &resources, int version, EProf
 // This lets the type of the built-in be declared textually, and then have just its qualifier be
 // updated afterward.
 //
-// Safe to call even if name is not present.
+// Safe to call even if name is not present.  Leaves alone shared (read-only) symbols,
+// which were already identified when they were set up.
 //
 // Only use this for built-in variables that have a special qualifier in TStorageQualifier.
 // New built-in variables should use a generic (textually declarable) qualifier in
@@ -2739,7 +2740,7 @@ void TBuiltIns::initialize(const TBuiltInResource &resources, int version, EProf
 void SpecialQualifier(const char* name, TStorageQualifier qualifier, TBuiltInVariable builtIn, TSymbolTable& symbolTable)
 {
     TSymbol* symbol = symbolTable.find(name);
-    if (symbol) {
+    if (symbol && ! symbol->isReadOnly()) {
         TQualifier& symQualifier = symbol->getWritableType().getQualifier();
         symQualifier.storage = qualifier;
         symQualifier.builtIn = builtIn;
@@ -2759,7 +2760,7 @@ void SpecialQualifier(const char* name, TStorageQualifier qualifier, TBuiltInVar
 void BuiltInVariable(const char* name, TBuiltInVariable builtIn, TSymbolTable& symbolTable)
 {
     TSymbol* symbol = symbolTable.find(name);
-    if (! symbol)
+    if (! symbol || symbol->isReadOnly())
         return;
 
     TQualifier& symQualifier = symbol->getWritableType().getQualifier();
@@ -2776,7 +2777,7 @@ void BuiltInVariable(const char* name, TBuiltInVariable builtIn, TSymbolTable& s
 void BuiltInVariable(const char* blockName, const char* name, TBuiltInVariable builtIn, TSymbolTable& symbolTable)
 {
     TSymbol* symbol = symbolTable.find(blockName);
-    if (! symbol)
+    if (! symbol || symbol->isReadOnly())
         return;
 
     TTypeList& structure = *symbol->getWritableType().getWritableStruct();
@@ -2828,9 +2829,9 @@ void IdentifyBuiltIns(int version, EProfile profile, EShLanguage language, TSymb
         BuiltInVariable("gl_FogCoord",       EbvFogFragCoord,   symbolTable);
 
         if (profile == EEsProfile) {
-            symbolTable.setFunctionExtensions("texture2DGradEXT",     1, &E_GL_EXT_shader_texture_lod);
-            symbolTable.setFunctionExtensions("texture2DProjGradEXT", 1, &E_GL_EXT_shader_texture_lod);
-            symbolTable.setFunctionExtensions("textureCubeGradEXT",   1, &E_GL_EXT_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture2DGradEXT",     E_GL_EXT_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture2DProjGradEXT", E_GL_EXT_shader_texture_lod);
+            symbolTable.setFunctionExtensions("textureCubeGradEXT",   E_GL_EXT_shader_texture_lod);
             symbolTable.setFunctionExtensions("textureGatherOffsets", Num_AEP_gpu_shader5, AEP_gpu_shader5);
             if (version >= 310)
                 symbolTable.setFunctionExtensions("fma", Num_AEP_gpu_shader5, AEP_gpu_shader5);
@@ -2870,7 +2871,7 @@ void IdentifyBuiltIns(int version, EProfile profile, EShLanguage language, TSymb
         BuiltInVariable("gl_TessCoord",       EbvTessCoord,      symbolTable);
 
         if (version < 410)
-            symbolTable.setVariableExtensions("gl_ViewportIndex", 1, &E_GL_ARB_viewport_array);
+            symbolTable.setVariableExtensions("gl_ViewportIndex", E_GL_ARB_viewport_array);
 
         // Compatibility variables
 
@@ -2946,76 +2947,76 @@ void IdentifyBuiltIns(int version, EProfile profile, EShLanguage language, TSymb
         // built-in functions
 
         if (profile == EEsProfile) {
-            symbolTable.setFunctionExtensions("texture2DLodEXT",      1, &E_GL_EXT_shader_texture_lod);
-            symbolTable.setFunctionExtensions("texture2DProjLodEXT",  1, &E_GL_EXT_shader_texture_lod);
-            symbolTable.setFunctionExtensions("textureCubeLodEXT",    1, &E_GL_EXT_shader_texture_lod);
-            symbolTable.setFunctionExtensions("texture2DGradEXT",     1, &E_GL_EXT_shader_texture_lod);
-            symbolTable.setFunctionExtensions("texture2DProjGradEXT", 1, &E_GL_EXT_shader_texture_lod);
-            symbolTable.setFunctionExtensions("textureCubeGradEXT",   1, &E_GL_EXT_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture2DLodEXT",      E_GL_EXT_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture2DProjLodEXT",  E_GL_EXT_shader_texture_lod);
+            symbolTable.setFunctionExtensions("textureCubeLodEXT",    E_GL_EXT_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture2DGradEXT",     E_GL_EXT_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture2DProjGradEXT", E_GL_EXT_shader_texture_lod);
+            symbolTable.setFunctionExtensions("textureCubeGradEXT",   E_GL_EXT_shader_texture_lod);
             symbolTable.setFunctionExtensions("textureGatherOffsets", Num_AEP_gpu_shader5, AEP_gpu_shader5);
             if (version == 100) {
-                symbolTable.setFunctionExtensions("dFdx",   1, &E_GL_OES_standard_derivatives);
-                symbolTable.setFunctionExtensions("dFdy",   1, &E_GL_OES_standard_derivatives);
-                symbolTable.setFunctionExtensions("fwidth", 1, &E_GL_OES_standard_derivatives);
+                symbolTable.setFunctionExtensions("dFdx",   E_GL_OES_standard_derivatives);
+                symbolTable.setFunctionExtensions("dFdy",   E_GL_OES_standard_derivatives);
+                symbolTable.setFunctionExtensions("fwidth", E_GL_OES_standard_derivatives);
             }
             if (version >= 310)
                 symbolTable.setFunctionExtensions("fma", Num_AEP_gpu_shader5, AEP_gpu_shader5);
         } else if (version < 130) {
-            symbolTable.setFunctionExtensions("texture1DLod",        1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("texture2DLod",        1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("texture3DLod",        1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("textureCubeLod",      1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("texture1DProjLod",    1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("texture2DProjLod",    1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("texture3DProjLod",    1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("shadow1DLod",         1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("shadow2DLod",         1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("shadow1DProjLod",     1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("shadow2DProjLod",     1, &E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture1DLod",        E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture2DLod",        E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture3DLod",        E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("textureCubeLod",      E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture1DProjLod",    E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture2DProjLod",    E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture3DProjLod",    E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("shadow1DLod",         E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("shadow2DLod",         E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("shadow1DProjLod",     E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("shadow2DProjLod",     E_GL_ARB_shader_texture_lod);
         }
 
         // E_GL_ARB_shader_texture_lod functions usable only with the extension enabled
         if (profile != EEsProfile) {
-            symbolTable.setFunctionExtensions("texture1DGradARB",         1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("texture1DProjGradARB",     1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("texture2DGradARB",         1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("texture2DProjGradARB",     1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("texture3DGradARB",         1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("texture3DProjGradARB",     1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("textureCubeGradARB",       1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("shadow1DGradARB",          1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("shadow1DProjGradARB",      1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("shadow2DGradARB",          1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("shadow2DProjGradARB",      1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("texture2DRectGradARB",     1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("texture2DRectProjGradARB", 1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("shadow2DRectGradARB",      1, &E_GL_ARB_shader_texture_lod);
-            symbolTable.setFunctionExtensions("shadow2DRectProjGradARB",  1, &E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture1DGradARB",         E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture1DProjGradARB",     E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture2DGradARB",         E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture2DProjGradARB",     E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture3DGradARB",         E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture3DProjGradARB",     E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("textureCubeGradARB",       E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("shadow1DGradARB",          E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("shadow1DProjGradARB",      E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("shadow2DGradARB",          E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("shadow2DProjGradARB",      E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture2DRectGradARB",     E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("texture2DRectProjGradARB", E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("shadow2DRectGradARB",      E_GL_ARB_shader_texture_lod);
+            symbolTable.setFunctionExtensions("shadow2DRectProjGradARB",  E_GL_ARB_shader_texture_lod);
         }
 
         // E_GL_ARB_shader_image_load_store
         if (profile != EEsProfile && version < 420)
-            symbolTable.setFunctionExtensions("memoryBarrier", 1, &E_GL_ARB_shader_image_load_store);
+            symbolTable.setFunctionExtensions("memoryBarrier", E_GL_ARB_shader_image_load_store);
         // All the image access functions are protected by checks on the type of the first argument.
 
         // E_GL_ARB_shader_atomic_counters
         if (profile != EEsProfile && version < 420) {
-            symbolTable.setFunctionExtensions("atomicCounterIncrement", 1, &E_GL_ARB_shader_atomic_counters);
-            symbolTable.setFunctionExtensions("atomicCounterDecrement", 1, &E_GL_ARB_shader_atomic_counters);
-            symbolTable.setFunctionExtensions("atomicCounter"         , 1, &E_GL_ARB_shader_atomic_counters);
+            symbolTable.setFunctionExtensions("atomicCounterIncrement", E_GL_ARB_shader_atomic_counters);
+            symbolTable.setFunctionExtensions("atomicCounterDecrement", E_GL_ARB_shader_atomic_counters);
+            symbolTable.setFunctionExtensions("atomicCounter"         , E_GL_ARB_shader_atomic_counters);
         }
 
         // E_GL_ARB_derivative_control
         if (profile != EEsProfile && version < 450) {
-            symbolTable.setFunctionExtensions("dFdxFine",     1, &E_GL_ARB_derivative_control);
-            symbolTable.setFunctionExtensions("dFdyFine",     1, &E_GL_ARB_derivative_control);
-            symbolTable.setFunctionExtensions("fwidthFine",   1, &E_GL_ARB_derivative_control);
-            symbolTable.setFunctionExtensions("dFdxCoarse",   1, &E_GL_ARB_derivative_control);
-            symbolTable.setFunctionExtensions("dFdyCoarse",   1, &E_GL_ARB_derivative_control);
-            symbolTable.setFunctionExtensions("fwidthCoarse", 1, &E_GL_ARB_derivative_control);
+            symbolTable.setFunctionExtensions("dFdxFine",     E_GL_ARB_derivative_control);
+            symbolTable.setFunctionExtensions("dFdyFine",     E_GL_ARB_derivative_control);
+            symbolTable.setFunctionExtensions("fwidthFine",   E_GL_ARB_derivative_control);
+            symbolTable.setFunctionExtensions("dFdxCoarse",   E_GL_ARB_derivative_control);
+            symbolTable.setFunctionExtensions("dFdyCoarse",   E_GL_ARB_derivative_control);
+            symbolTable.setFunctionExtensions("fwidthCoarse", E_GL_ARB_derivative_control);
         }
 
-        symbolTable.setVariableExtensions("gl_FragDepthEXT", 1, &E_GL_EXT_frag_depth);
+        symbolTable.setVariableExtensions("gl_FragDepthEXT", E_GL_EXT_frag_depth);
         symbolTable.setVariableExtensions("gl_PrimitiveID",  Num_AEP_geometry_shader, AEP_geometry_shader);
         symbolTable.setVariableExtensions("gl_Layer",        Num_AEP_geometry_shader, AEP_geometry_shader);
         break;
@@ -3260,15 +3261,15 @@ void IdentifyBuiltIns(int version, EProfile profile, EShLanguage language, TSymb
 void IdentifyBuiltIns(int version, EProfile profile, EShLanguage language, TSymbolTable& symbolTable, const TBuiltInResource &resources)
 {
     if (profile != EEsProfile && version >= 430 && version < 440) {
-        symbolTable.setVariableExtensions("gl_MaxTransformFeedbackBuffers", 1, &E_GL_ARB_enhanced_layouts);
-        symbolTable.setVariableExtensions("gl_MaxTransformFeedbackInterleavedComponents", 1, &E_GL_ARB_enhanced_layouts);
+        symbolTable.setVariableExtensions("gl_MaxTransformFeedbackBuffers", E_GL_ARB_enhanced_layouts);
+        symbolTable.setVariableExtensions("gl_MaxTransformFeedbackInterleavedComponents", E_GL_ARB_enhanced_layouts);
     }
     if (profile != EEsProfile && version >= 130 && version < 420) {
-        symbolTable.setVariableExtensions("gl_MinProgramTexelOffset", 1, &E_GL_ARB_shading_language_420pack);
-        symbolTable.setVariableExtensions("gl_MaxProgramTexelOffset", 1, &E_GL_ARB_shading_language_420pack);
+        symbolTable.setVariableExtensions("gl_MinProgramTexelOffset", E_GL_ARB_shading_language_420pack);
+        symbolTable.setVariableExtensions("gl_MaxProgramTexelOffset", E_GL_ARB_shading_language_420pack);
     }
     if (profile != EEsProfile && version >= 150 && version < 410)
-        symbolTable.setVariableExtensions("gl_MaxViewports", 1, &E_GL_ARB_viewport_array);
+        symbolTable.setVariableExtensions("gl_MaxViewports", E_GL_ARB_viewport_array);
 
     switch(language) {
     case EShLangFragment:
@@ -54,6 +54,10 @@ namespace glslang {
 //    commonBuiltins:  intersection of all stages' built-ins, processed just once
 //    stageBuiltins[]: anything a stage needs that's not in commonBuiltins
 //
+// The many texturing and imaging function prototypes are kept apart, in
+// commonFunctions and stageFunctions[], one per line, for the symbol table
+// to only parse as they are looked up (see TLazyFunctions).
+//
 class TBuiltIns {
 public:
     POOL_ALLOCATOR_NEW_DELETE(GetThreadPoolAllocator())
@@ -63,6 +67,8 @@ public:
 	void initialize(const TBuiltInResource& resources, int version, EProfile, EShLanguage);
     const TString& getCommonString() const { return commonBuiltins; }
     const TString& getStageString(EShLanguage language) const { return stageBuiltins[language]; }
+    const TString& getCommonFunctions() const { return commonFunctions; }
+    const TString& getStageFunctions(EShLanguage language) const { return stageFunctions[language]; }
 
 protected:
     void add2ndGenerationSamplingImaging(int version, EProfile profile);
@@ -73,6 +79,8 @@ protected:
 
     TString commonBuiltins;
     TString stageBuiltins[EShLangCount];
+    TString commonFunctions;
+    TString stageFunctions[EShLangCount];
 
     // Helpers for making textual representations of the permutations
     // of texturing/imaging functions.
@@ -84,6 +92,9 @@ protected:
 void IdentifyBuiltIns(int version, EProfile profile, EShLanguage, TSymbolTable&);
 void IdentifyBuiltIns(int version, EProfile profile, EShLanguage, TSymbolTable&, const TBuiltInResource &resources);
 
+// Parse built-in function prototypes into a new level of an empty symbol table; used for TLazyFunctions.
+bool ParseBuiltInFunctions(const TString& prototypes, int version, EProfile, EShLanguage, TSymbolTable&);
+
 } // end namespace glslang
 
 #endif // _INITIALIZE_INCLUDED_
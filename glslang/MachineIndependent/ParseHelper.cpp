@@ -55,11 +55,15 @@ TParseContext::TParseContext(TSymbolTable& symt, TIntermediate& interm, bool pb,
             postMainReturn(false),
             tokensBeforeEOF(false), limits(resources.limits), messages(m), currentScanner(0),
             numErrors(0), parsingBuiltins(pb), afterEOF(false),
-            atomicUintOffsets(0), anyIndexLimits(false)
+            atomicUintOffsets(0), anyIndexLimits(false), arrayOfArrayWarned(false)
 {
     // ensure we always have a linkage node, even if empty, to simplify tree topology algorithms
     linkage = new TIntermAggregate;
 
+    // no extensions are known until initializeExtensionBehavior() is called
+    for (int e = 0; e < NumExtensions; ++e)
+        extensionBehavior[e] = EBhMissing;
+
     // set all precision defaults to EpqNone, which is correct for all desktop types
     // and for ES types that don't have defaults (thus getting an error on use)
     for (int type = 0; type < EbtNumTypes; ++type)
@@ -526,7 +530,7 @@ TIntermTyped* TParseContext::handleBracketDereference(TSourceLoc loc, TIntermTyp
                 const char* explanation = "variable indexing sampler array";
                 requireProfile(base->getLoc(), EEsProfile | ECoreProfile | ECompatibilityProfile, explanation);
                 profileRequires(base->getLoc(), EEsProfile, 0, Num_AEP_gpu_shader5, AEP_gpu_shader5, explanation);
-                profileRequires(base->getLoc(), ECoreProfile | ECompatibilityProfile, 400, nullptr, explanation);
+                profileRequires(base->getLoc(), ECoreProfile | ECompatibilityProfile, 400, explanation);
             }
 
             result = intermediate.addIndex(EOpIndexIndirect, base, index, loc);
@@ -598,7 +602,7 @@ void TParseContext::handleIndexLimits(TSourceLoc /*loc*/, TIntermTyped* base, TI
 // effect all nodes sharing it.
 void TParseContext::makeEditable(TSymbol*& symbol)
 {
-    // copyUp() does a deep copy of the type.
+    // copyUp() copies the editable parts of the type.
     symbol = symbolTable.copyUp(symbol);
 
     // Also, see if it's tied to IO resizing
@@ -764,7 +768,7 @@ TIntermTyped* TParseContext::handleDotDereference(TSourceLoc loc, TIntermTyped*
     if (field == "length") {
         if (base->isArray()) {
             profileRequires(loc, ENoProfile, 120, E_GL_3DL_array_objects, ".length");
-            profileRequires(loc, EEsProfile, 300, nullptr, ".length");
+            profileRequires(loc, EEsProfile, 300, ".length");
         } else if (base->isVector() || base->isMatrix()) {
             const char* feature = ".length() on vectors and matrices";
             requireProfile(loc, ~EEsProfile, feature);
@@ -892,7 +896,7 @@ TFunction* TParseContext::handleFunctionDeclarator(TSourceLoc loc, TFunction& fu
     const TFunction* prevDec = symbol ? symbol->getAsFunction() : 0;
     if (prevDec) {
         if (prevDec->isPrototyped() && prototype)
-            profileRequires(loc, EEsProfile, 300, nullptr, "multiple prototypes for same function");
+            profileRequires(loc, EEsProfile, 300, "multiple prototypes for same function");
         if (prevDec->getType() != function.getType())
             error(loc, "overloaded functions must have the same return type", function.getType().getBasicTypeString().c_str(), "");
         for (int i = 0; i < prevDec->getParamCount(); ++i) {
@@ -1341,7 +1345,7 @@ void TParseContext::nonOpBuiltInCheck(TSourceLoc loc, const TFunction& fnCandida
         if (fnCandidate.getName().compare(0, 13, "textureGather") == 0) {
             TString featureString = fnCandidate.getName() + "(...)";
             const char* feature = featureString.c_str();
-            profileRequires(loc, EEsProfile, 310, nullptr, feature);
+            profileRequires(loc, EEsProfile, 310, feature);
 
             int compArg = -1;  // track which argument, if any, is the constant component argument
             if (fnCandidate.getName().compare("textureGatherOffset") == 0) {
@@ -1443,7 +1447,7 @@ TFunction* TParseContext::handleConstructorCall(TSourceLoc loc, const TPublicTyp
 
     if (type.isArray()) {
         profileRequires(loc, ENoProfile, 120, E_GL_3DL_array_objects, "arrayed constructor");
-        profileRequires(loc, EEsProfile, 300, nullptr, "arrayed constructor");
+        profileRequires(loc, EEsProfile, 300, "arrayed constructor");
     }
 
     TOperator op = mapTypeToConstructorOp(type);
@@ -1635,7 +1639,7 @@ void TParseContext::variableCheck(TIntermTyped*& nodePtr)
     } else {
         switch (symbol->getQualifier().storage) {
         case EvqPointCoord:
-            profileRequires(symbol->getLoc(), ENoProfile, 120, nullptr, "gl_PointCoord");
+            profileRequires(symbol->getLoc(), ENoProfile, 120, "gl_PointCoord");
             break;
         default: break; // some compilers want this
         }
@@ -1897,7 +1901,7 @@ bool TParseContext::lineContinuationCheck(TSourceLoc loc, bool endOfComment)
             warn(loc, "not allowed in this version", message, "");
         return true;
     } else {
-        profileRequires(loc, EEsProfile, 300, nullptr, message);
+        profileRequires(loc, EEsProfile, 300, message);
         profileRequires(loc, ~EEsProfile, 420, E_GL_ARB_shading_language_420pack, message);
     }
 
@@ -2007,7 +2011,7 @@ bool TParseContext::constructorError(TSourceLoc loc, TIntermNode* node, TFunctio
     }
 
     if (matrixInMatrix && ! type.isArray()) {
-        profileRequires(loc, ENoProfile, 120, nullptr, "constructing matrix from matrix");
+        profileRequires(loc, ENoProfile, 120, "constructing matrix from matrix");
 
         // "If a matrix argument is given to a matrix constructor,
         // it is a compile-time error to have any other arguments."
@@ -2111,13 +2115,13 @@ void TParseContext::globalQualifierFixCheck(TSourceLoc loc, TQualifier& qualifie
     // move from parameter/unknown qualifiers to pipeline in/out qualifiers
     switch (qualifier.storage) {
     case EvqIn:
-        profileRequires(loc, ENoProfile, 130, nullptr, "in for stage inputs");
-        profileRequires(loc, EEsProfile, 300, nullptr, "in for stage inputs");
+        profileRequires(loc, ENoProfile, 130, "in for stage inputs");
+        profileRequires(loc, EEsProfile, 300, "in for stage inputs");
         qualifier.storage = EvqVaryingIn;
         break;
     case EvqOut:
-        profileRequires(loc, ENoProfile, 130, nullptr, "out for stage outputs");
-        profileRequires(loc, EEsProfile, 300, nullptr, "out for stage outputs");
+        profileRequires(loc, ENoProfile, 130, "out for stage outputs");
+        profileRequires(loc, EEsProfile, 300, "out for stage outputs");
         qualifier.storage = EvqVaryingOut;
         break;
     case EvqInOut:
@@ -2156,7 +2160,7 @@ void TParseContext::globalQualifierTypeCheck(TSourceLoc loc, const TQualifier& q
     }
 
     if (publicType.basicType == EbtInt || publicType.basicType == EbtUint || publicType.basicType == EbtDouble) {
-        profileRequires(loc, EEsProfile, 300, nullptr, "shader input/output");
+        profileRequires(loc, EEsProfile, 300, "shader input/output");
         if (! qualifier.flat) {
             if (qualifier.storage == EvqVaryingIn && language == EShLangFragment)
                 error(loc, "must be qualified as flat", TType::getBasicString(publicType.basicType), GetStorageQualifierString(qualifier.storage));
@@ -2177,7 +2181,7 @@ void TParseContext::globalQualifierTypeCheck(TSourceLoc loc, const TQualifier& q
             }
             if (publicType.arraySizes) {
                 requireProfile(loc, ~EEsProfile, "vertex input arrays");
-                profileRequires(loc, ENoProfile, 150, nullptr, "vertex input arrays");
+                profileRequires(loc, ENoProfile, 150, "vertex input arrays");
             }
             if (qualifier.isAuxiliary() || qualifier.isInterpolation() || qualifier.isMemory() || qualifier.invariant)
                 error(loc, "vertex input cannot be further qualified", "", "");
@@ -2196,8 +2200,8 @@ void TParseContext::globalQualifierTypeCheck(TSourceLoc loc, const TQualifier& q
 
         case EShLangFragment:
             if (publicType.userDef) {
-                profileRequires(loc, EEsProfile, 300, nullptr, "fragment-shader struct input");
-                profileRequires(loc, ~EEsProfile, 150, nullptr, "fragment-shader struct input");
+                profileRequires(loc, EEsProfile, 300, "fragment-shader struct input");
+                profileRequires(loc, ~EEsProfile, 150, "fragment-shader struct input");
                 if (publicType.userDef->containsStructure())
                     requireProfile(loc, ~EEsProfile, "fragment-shader struct input containing structure");
                 if (publicType.userDef->containsArray())
@@ -2218,8 +2222,8 @@ void TParseContext::globalQualifierTypeCheck(TSourceLoc loc, const TQualifier& q
         switch (language) {
         case EShLangVertex:
             if (publicType.userDef) {
-                profileRequires(loc, EEsProfile, 300, nullptr, "vertex-shader struct output");
-                profileRequires(loc, ~EEsProfile, 150, nullptr, "vertex-shader struct output");
+                profileRequires(loc, EEsProfile, 300, "vertex-shader struct output");
+                profileRequires(loc, ~EEsProfile, 150, "vertex-shader struct output");
                 if (publicType.userDef->containsStructure())
                     requireProfile(loc, ~EEsProfile, "vertex-shader struct output containing structure");
                 if (publicType.userDef->containsArray())
@@ -2240,7 +2244,7 @@ void TParseContext::globalQualifierTypeCheck(TSourceLoc loc, const TQualifier& q
             break;
 
         case EShLangFragment:
-            profileRequires(loc, EEsProfile, 300, nullptr, "fragment shader output");
+            profileRequires(loc, EEsProfile, 300, "fragment shader output");
             if (publicType.basicType == EbtStruct) {
                 error(loc, "cannot be a structure", GetStorageQualifierString(qualifier.storage), "");
                 return;
@@ -2467,12 +2471,12 @@ bool TParseContext::arrayQualifierError(TSourceLoc loc, const TQualifier& qualif
 {
     if (qualifier.storage == EvqConst) {
         profileRequires(loc, ENoProfile, 120, E_GL_3DL_array_objects, "const array");
-        profileRequires(loc, EEsProfile, 300, nullptr, "const array");
+        profileRequires(loc, EEsProfile, 300, "const array");
     }
 
     if (qualifier.storage == EvqVaryingIn && language == EShLangVertex) {
         requireProfile(loc, ~EEsProfile, "vertex input arrays");
-        profileRequires(loc, ENoProfile, 150, nullptr, "vertex input arrays");
+        profileRequires(loc, ENoProfile, 150, "vertex input arrays");
     }
 
     return false;
@@ -2560,13 +2564,12 @@ void TParseContext::arrayOfArrayVersionCheck(TSourceLoc loc)
     const char* feature = "arrays of arrays";
 
     requireProfile(loc, EEsProfile | ECoreProfile | ECompatibilityProfile, feature);
-    profileRequires(loc, EEsProfile, 310, nullptr, feature);
-    profileRequires(loc, ECoreProfile | ECompatibilityProfile, 430, nullptr, feature);
+    profileRequires(loc, EEsProfile, 310, feature);
+    profileRequires(loc, ECoreProfile | ECompatibilityProfile, 430, feature);
 
-    static int once = false;
-    if (! once) {
+    if (! arrayOfArrayWarned) {
         warn(loc, feature, "Not supported yet.", "");
-        once = true;
+        arrayOfArrayWarned = true;
     }
 }
 
@@ -3075,7 +3078,7 @@ void TParseContext::arrayObjectCheck(TSourceLoc loc, const TType& type, const ch
     // Some versions don't allow comparing arrays or structures containing arrays
     if (type.containsArray()) {
         profileRequires(loc, ENoProfile, 120, E_GL_3DL_array_objects, op);
-        profileRequires(loc, EEsProfile, 300, nullptr, op);
+        profileRequires(loc, EEsProfile, 300, op);
     }
 }
 
@@ -3270,11 +3273,11 @@ void TParseContext::finalErrorCheck()
         if (profile == EEsProfile && version == 310)
             requireExtensions(getCurrentLoc(), Num_AEP_tessellation_shader, AEP_tessellation_shader, "tessellation shaders");
         else if (profile != EEsProfile && version < 400)
-            requireExtensions(getCurrentLoc(), 1, &E_GL_ARB_tessellation_shader, "tessellation shaders");
+            requireExtensions(getCurrentLoc(), E_GL_ARB_tessellation_shader, "tessellation shaders");
         break;
     case EShLangCompute:
         if (profile != EEsProfile && version < 430)
-            requireExtensions(getCurrentLoc(), 1, &E_GL_ARB_compute_shader, "tessellation shaders");
+            requireExtensions(getCurrentLoc(), E_GL_ARB_compute_shader, "tessellation shaders");
         break;
     default:
         break;
@@ -3313,8 +3316,8 @@ void TParseContext::setLayoutQualifier(TSourceLoc loc, TPublicType& publicType,
     }
     if (id == TQualifier::getLayoutPackingString(ElpStd430)) {
         requireProfile(loc, EEsProfile | ECoreProfile | ECompatibilityProfile, "std430");
-        profileRequires(loc, ECoreProfile | ECompatibilityProfile, 430, nullptr, "std430");
-        profileRequires(loc, EEsProfile, 310, nullptr, "std430");
+        profileRequires(loc, ECoreProfile | ECompatibilityProfile, 430, "std430");
+        profileRequires(loc, EEsProfile, 310, "std430");
         publicType.qualifier.layoutPacking = ElpStd430;
         return;
     }
@@ -3421,14 +3424,14 @@ void TParseContext::setLayoutQualifier(TSourceLoc loc, TPublicType& publicType,
         }
         if (id == "early_fragment_tests") {
             profileRequires(loc, ENoProfile | ECoreProfile | ECompatibilityProfile, 420, E_GL_ARB_shader_image_load_store, "early_fragment_tests");
-            profileRequires(loc, EEsProfile, 310, nullptr, "early_fragment_tests");
+            profileRequires(loc, EEsProfile, 310, "early_fragment_tests");
             publicType.shaderQualifiers.earlyFragmentTests = true;
             return;
         }
         for (TLayoutDepth depth = (TLayoutDepth)(EldNone + 1); depth < EldCount; depth = (TLayoutDepth)(depth+1)) {
             if (id == TQualifier::getLayoutDepthString(depth)) {
                 requireProfile(loc, ECoreProfile | ECompatibilityProfile, "depth layout qualifier");
-                profileRequires(loc, ECoreProfile | ECompatibilityProfile, 420, nullptr, "depth layout qualifier");
+                profileRequires(loc, ECoreProfile | ECompatibilityProfile, 420, "depth layout qualifier");
                 publicType.shaderQualifiers.layoutDepth = depth;
                 return;
             }
@@ -3468,9 +3471,9 @@ void TParseContext::setLayoutQualifier(TSourceLoc loc, TPublicType& publicType,
     if (id == "offset") {
         const char* feature = "uniform offset";
         requireProfile(loc, EEsProfile | ECoreProfile | ECompatibilityProfile, feature);
-        const char* exts[2] = { E_GL_ARB_enhanced_layouts, E_GL_ARB_shader_atomic_counters };
+        const TExtension exts[2] = { E_GL_ARB_enhanced_layouts, E_GL_ARB_shader_atomic_counters };
         profileRequires(loc, ECoreProfile | ECompatibilityProfile, 420, 2, exts, feature);
-        profileRequires(loc, EEsProfile, 310, nullptr, feature);
+        profileRequires(loc, EEsProfile, 310, feature);
         publicType.qualifier.layoutOffset = value;
         return;
     } else if (id == "align") {
@@ -3484,8 +3487,8 @@ void TParseContext::setLayoutQualifier(TSourceLoc loc, TPublicType& publicType,
             publicType.qualifier.layoutAlign = value;
         return;
     } else if (id == "location") {
-        profileRequires(loc, EEsProfile, 300, nullptr, "location");
-        const char* exts[2] = { E_GL_ARB_separate_shader_objects, E_GL_ARB_explicit_attrib_location };
+        profileRequires(loc, EEsProfile, 300, "location");
+        const TExtension exts[2] = { E_GL_ARB_separate_shader_objects, E_GL_ARB_explicit_attrib_location };
         profileRequires(loc, ~EEsProfile, 330, 2, exts, "location");
         if ((unsigned int)value >= TQualifier::layoutLocationEnd)
             error(loc, "location is too large", id.c_str(), "");
@@ -3500,7 +3503,7 @@ void TParseContext::setLayoutQualifier(TSourceLoc loc, TPublicType& publicType,
         return;
     } else if (id == "binding") {
         profileRequires(loc, ~EEsProfile, 420, E_GL_ARB_shading_language_420pack, "binding");
-        profileRequires(loc, EEsProfile, 310, nullptr, "binding");
+        profileRequires(loc, EEsProfile, 310, "binding");
         if ((unsigned int)value >= TQualifier::layoutBindingEnd)
             error(loc, "binding is too large", id.c_str(), "");
         else
@@ -3569,7 +3572,7 @@ void TParseContext::setLayoutQualifier(TSourceLoc loc, TPublicType& publicType,
 
     case EShLangGeometry:
         if (id == "invocations") {
-            profileRequires(loc, ECompatibilityProfile | ECoreProfile, 400, nullptr, "invocations");
+            profileRequires(loc, ECompatibilityProfile | ECoreProfile, 400, "invocations");
             publicType.shaderQualifiers.invocations = value;
             return;
         }
@@ -3589,7 +3592,7 @@ void TParseContext::setLayoutQualifier(TSourceLoc loc, TPublicType& publicType,
     case EShLangFragment:
         if (id == "index") {
             requireProfile(loc, ECompatibilityProfile | ECoreProfile, "index layout qualifier on fragment output");
-            const char* exts[2] = { E_GL_ARB_separate_shader_objects, E_GL_ARB_explicit_attrib_location };
+            const TExtension exts[2] = { E_GL_ARB_separate_shader_objects, E_GL_ARB_explicit_attrib_location };
             profileRequires(loc, ECompatibilityProfile | ECoreProfile, 330, 2, exts, "index layout qualifier on fragment output");
             publicType.qualifier.layoutIndex = value;
             return;
@@ -3882,12 +3885,12 @@ void TParseContext::layoutQualifierCheck(TSourceLoc loc, const TQualifier& quali
             else
                 requireStage(loc, (EShLanguageMask)~EShLangComputeMask, feature);
             if (language == EShLangVertex) {
-                const char* exts[2] = { E_GL_ARB_separate_shader_objects, E_GL_ARB_explicit_attrib_location };
+                const TExtension exts[2] = { E_GL_ARB_separate_shader_objects, E_GL_ARB_explicit_attrib_location };
                 profileRequires(loc, ~EEsProfile, 330, 2, exts, feature);
-                profileRequires(loc, EEsProfile, 300, nullptr, feature);
+                profileRequires(loc, EEsProfile, 300, feature);
             } else {
                 profileRequires(loc, ~EEsProfile, 410, E_GL_ARB_separate_shader_objects, feature);
-                profileRequires(loc, EEsProfile, 310, nullptr, feature);
+                profileRequires(loc, EEsProfile, 310, feature);
             }
             break;
         }
@@ -3899,12 +3902,12 @@ void TParseContext::layoutQualifierCheck(TSourceLoc loc, const TQualifier& quali
             else
                 requireStage(loc, (EShLanguageMask)~EShLangComputeMask, feature);
             if (language == EShLangFragment) {
-                const char* exts[2] = { E_GL_ARB_separate_shader_objects, E_GL_ARB_explicit_attrib_location };
+                const TExtension exts[2] = { E_GL_ARB_separate_shader_objects, E_GL_ARB_explicit_attrib_location };
                 profileRequires(loc, ~EEsProfile, 330, 2, exts, feature);
-                profileRequires(loc, EEsProfile, 300, nullptr, feature);
+                profileRequires(loc, EEsProfile, 300, feature);
             } else {
                 profileRequires(loc, ~EEsProfile, 410, E_GL_ARB_separate_shader_objects, feature);
-                profileRequires(loc, EEsProfile, 310, nullptr, feature);
+                profileRequires(loc, EEsProfile, 310, feature);
             }
             break;
         }
@@ -3913,8 +3916,8 @@ void TParseContext::layoutQualifierCheck(TSourceLoc loc, const TQualifier& quali
         {
             const char* feature = "location qualifier on uniform or buffer";
             requireProfile(loc, EEsProfile | ECoreProfile | ECompatibilityProfile, feature);
-            profileRequires(loc, ECoreProfile | ECompatibilityProfile, 430, nullptr, feature);
-            profileRequires(loc, EEsProfile, 310, nullptr, feature);
+            profileRequires(loc, ECoreProfile | ECompatibilityProfile, 430, feature);
+            profileRequires(loc, EEsProfile, 310, feature);
             break;
         }
         default:
@@ -4056,7 +4059,19 @@ const TFunction* TParseContext::findFunction120(TSourceLoc loc, const TFunction&
     // a match, it is a semantic error if there are multiple ways to apply these conversions to make the call match
     // more than one function."
 
+    // Calls resolving to built-ins through the same conversions are common, and
+    // the answer is the same for every compile sharing the built-in levels.
+    TOverloadCache* cache = symbolTable.getOverloadCache(call.getName());
+    if (cache) {
+        const TFunction* resolved = cache->find(call);
+        if (resolved) {
+            builtIn = true;
+            return resolved;
+        }
+    }
+
     const TFunction* candidate = 0;
+    bool ambiguous = false;
     TVector<TFunction*> candidateList;
     symbolTable.findFunctionNameList(call.getMangledName(), candidateList, builtIn);
 
@@ -4096,6 +4111,7 @@ const TFunction* TParseContext::findFunction120(TSourceLoc loc, const TFunction&
             if (candidate) {
                 // our second match, meaning ambiguity
                 error(loc, "ambiguous function signature match: multiple signatures match under implicit type conversion", call.getName().c_str(), "");
+                ambiguous = true;
             } else
                 candidate = &function;
         }
@@ -4103,6 +4119,8 @@ const TFunction* TParseContext::findFunction120(TSourceLoc loc, const TFunction&
 
     if (candidate == 0)
         error(loc, "no matching overloaded function found", call.getName().c_str(), "");
+    else if (cache && ! ambiguous)
+        cache->add(call, *candidate);
 
     return candidate;
 }
@@ -4184,7 +4202,7 @@ TIntermNode* TParseContext::declareVariable(TSourceLoc loc, TString& identifier,
 
         if (initializer) {
             profileRequires(loc, ENoProfile, 120, E_GL_3DL_array_objects, "initializer");
-            profileRequires(loc, EEsProfile, 300, nullptr, "initializer");
+            profileRequires(loc, EEsProfile, 300, "initializer");
         }
     } else {
         // non-array case
@@ -4833,15 +4851,15 @@ void TParseContext::blockStageIoCheck(TSourceLoc loc, const TQualifier& qualifie
 {
     switch (qualifier.storage) {
     case EvqUniform:
-        profileRequires(loc, EEsProfile, 300, nullptr, "uniform block");
-        profileRequires(loc, ENoProfile, 140, nullptr, "uniform block");
+        profileRequires(loc, EEsProfile, 300, "uniform block");
+        profileRequires(loc, ENoProfile, 140, "uniform block");
         if (currentBlockQualifier.layoutPacking == ElpStd430)
             requireProfile(loc, ~EEsProfile, "std430 on a uniform block");
         break;
     case EvqBuffer:
         requireProfile(loc, EEsProfile | ECoreProfile | ECompatibilityProfile, "buffer block");
-        profileRequires(loc, ECoreProfile | ECompatibilityProfile, 430, nullptr, "buffer block");
-        profileRequires(loc, EEsProfile, 310, nullptr, "buffer block");
+        profileRequires(loc, ECoreProfile | ECompatibilityProfile, 430, "buffer block");
+        profileRequires(loc, EEsProfile, 310, "buffer block");
         break;
     case EvqVaryingIn:
         profileRequires(loc, ~EEsProfile, 150, E_GL_ARB_separate_shader_objects, "input block");
@@ -5290,8 +5308,8 @@ void TParseContext::wrapupSwitchSubsequence(TIntermAggregate* statements, TInter
 //
 TIntermNode* TParseContext::addSwitch(TSourceLoc loc, TIntermTyped* expression, TIntermAggregate* lastStatements)
 {
-    profileRequires(loc, EEsProfile, 300, nullptr, "switch statements");
-    profileRequires(loc, ENoProfile, 130, nullptr, "switch statements");
+    profileRequires(loc, EEsProfile, 300, "switch statements");
+    profileRequires(loc, ENoProfile, 130, "switch statements");
 
     wrapupSwitchSubsequence(lastStatements, nullptr);
 
@@ -216,6 +216,7 @@ public:
     void setCurrentLine(int line) { currentScanner->setLine(line); }
     void setCurrentString(int string) { currentScanner->setString(string); }
     void setScanner(TInputScanner* scanner) { currentScanner  = scanner; }
+    TInputScanner* getScanner() const { return currentScanner; }
 
     bool lineDirectiveShouldSetNextLine() const;
 
@@ -225,18 +226,24 @@ public:
     void notifyExtensionDirective(int line, const char* extension, const char* behavior);
 
     // The following are implemented in Versions.cpp to localize version/profile/stage/extensions control
+    static void fillInExtensionMap();
+    static void deleteExtensionMap();
+    static int getExtensionId(const char* extension);
+    static const char* getExtensionName(TExtension);
     void initializeExtensionBehavior();
     void requireProfile(TSourceLoc, int queryProfiles, const char* featureDesc);
-    void profileRequires(TSourceLoc, int queryProfiles, int minVersion, int numExtensions, const char* const extensions[], const char* featureDesc);
-    void profileRequires(TSourceLoc, int queryProfiles, int minVersion, const char* const extension, const char* featureDesc);
+    void profileRequires(TSourceLoc, int queryProfiles, int minVersion, int numExtensions, const TExtension extensions[], const char* featureDesc);
+    void profileRequires(TSourceLoc, int queryProfiles, int minVersion, TExtension extension, const char* featureDesc);
+    void profileRequires(TSourceLoc, int queryProfiles, int minVersion, const char* featureDesc);
     void requireStage(TSourceLoc, EShLanguageMask, const char* featureDesc);
     void requireStage(TSourceLoc, EShLanguage, const char* featureDesc);
     void checkDeprecated(TSourceLoc, int queryProfiles, int depVersion, const char* featureDesc);
     void requireNotRemoved(TSourceLoc, int queryProfiles, int removedVersion, const char* featureDesc);
-    void requireExtensions(TSourceLoc, int numExtensions, const char* const extensions[], const char* featureDesc);
-    TExtensionBehavior getExtensionBehavior(const char*);
-    bool extensionTurnedOn(const char* const extension);
-    bool extensionsTurnedOn(int numExtensions, const char* const extensions[]);
+    void requireExtensions(TSourceLoc, int numExtensions, const TExtension extensions[], const char* featureDesc);
+    void requireExtensions(TSourceLoc, TExtension extension, const char* featureDesc);
+    TExtensionBehavior getExtensionBehavior(TExtension extension) const { return extensionBehavior[extension]; }
+    bool extensionTurnedOn(TExtension extension);
+    bool extensionsTurnedOn(int numExtensions, const TExtension extensions[]);
     void updateExtensionBehavior(int line, const char* const extension, const char* behavior);
     void fullIntegerCheck(TSourceLoc, const char* op);
     void doubleCheck(TSourceLoc, const char* op);
@@ -257,6 +264,7 @@ protected:
     TIntermTyped* convertInitializerList(TSourceLoc, const TType&, TIntermTyped* initializer);
     TOperator mapTypeToConstructorOp(const TType&) const;
     void updateExtensionBehavior(const char* const extension, TExtensionBehavior);
+    void updateExtensionBehavior(TExtension, TExtensionBehavior);
     void finalErrorCheck();
     void outputMessage(TSourceLoc, const char* szReason, const char* szToken,
                        const char* szExtraInfoFormat, TPrefixType prefix,
@@ -307,7 +315,7 @@ protected:
     TInputScanner* currentScanner;
     int numErrors;               // number of compile-time errors encountered
     bool parsingBuiltins;        // true if parsing built-in symbols/functions
-    TMap<TString, TExtensionBehavior> extensionBehavior;    // for each extension string, what its current behavior is set to
+    TExtensionBehavior extensionBehavior[NumExtensions];    // for each extension ID, what its current behavior is set to
     static const int maxSamplerIndex = EsdNumDims * (EbtNumTypes * (2 * 2 * 2)); // see computeSamplerTypeIndex()
     TPrecisionQualifier defaultSamplerPrecision[maxSamplerIndex];
     bool afterEOF;
@@ -320,6 +328,7 @@ protected:
     TIdSetType inductiveLoopIds;
     bool anyIndexLimits;
     TVector<TIntermTyped*> needsIndexLimitationChecking;
+    bool arrayOfArrayWarned;      // warn once per compile, not once per process, so threaded output is deterministic
 
     //
     // Geometry shader input arrays:
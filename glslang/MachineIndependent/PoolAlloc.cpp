@@ -107,7 +107,8 @@ TPoolAllocator::TPoolAllocator(int growthIncrement, int allocationAlignment) :
     alignment(allocationAlignment),
     freeList(0),
     inUseList(0),
-    numCalls(0)
+    numCalls(0),
+    totalBytes(0)
 {
     //
     // Don't allow page sizes we know are smaller than all common
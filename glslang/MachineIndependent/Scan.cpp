@@ -39,8 +39,7 @@
 //
 
 #include <string.h>
-#include <unordered_map>
-#include <unordered_set>
+#include <vector>
 
 #include "../Include/Types.h"
 #include "SymbolTable.h"
@@ -294,9 +293,20 @@ int yylex(YYSTYPE* glslangTokenDesc, glslang::TParseContext& parseContext)
 namespace {
 
 // A single global usable by all threads, by all versions, by all languages.
-// After a single process-level initialization, this is read only and thread safe
-std::unordered_map<std::string, int>* KeywordMap = 0;
-std::unordered_set<std::string>* ReservedSet = 0;
+// After a single process-level initialization, this is read only and thread safe.
+// Indexed by the keyword's atom in the preprocessor's shared atom table, giving
+// the keyword's token, ReservedKeyword, or 0 for an ordinary identifier.
+std::vector<int>* KeywordTable = 0;
+
+const int ReservedKeyword = -1;
+
+void AddKeyword(const char* name, int keyword)
+{
+    int atom = glslang::TPpContext::AddSharedAtom(name);
+    if ((size_t)atom >= KeywordTable->size())
+        KeywordTable->resize(atom + 1, 0);
+    (*KeywordTable)[atom] = keyword;
+}
 
 };
 
@@ -304,227 +314,224 @@ namespace glslang {
 
 void TScanContext::fillInKeywordMap()
 {
-    if (KeywordMap != 0) {
+    if (KeywordTable != 0) {
         // this is really an error, as this should called only once per process
         // but, the only risk is if two threads called simultaneously
         return;
     }
-    KeywordMap = new std::unordered_map<std::string, int>;
-
-    (*KeywordMap)["const"] =                   CONST;
-    (*KeywordMap)["uniform"] =                 UNIFORM;
-    (*KeywordMap)["in"] =                      IN;
-    (*KeywordMap)["out"] =                     OUT;
-    (*KeywordMap)["inout"] =                   INOUT;
-    (*KeywordMap)["struct"] =                  STRUCT;
-    (*KeywordMap)["break"] =                   BREAK;
-    (*KeywordMap)["continue"] =                CONTINUE;
-    (*KeywordMap)["do"] =                      DO;
-    (*KeywordMap)["for"] =                     FOR;
-    (*KeywordMap)["while"] =                   WHILE;
-    (*KeywordMap)["switch"] =                  SWITCH;
-    (*KeywordMap)["case"] =                    CASE;
-    (*KeywordMap)["default"] =                 DEFAULT;
-    (*KeywordMap)["if"] =                      IF;
-    (*KeywordMap)["else"] =                    ELSE;
-    (*KeywordMap)["discard"] =                 DISCARD;
-    (*KeywordMap)["return"] =                  RETURN;
-    (*KeywordMap)["void"] =                    VOID;
-    (*KeywordMap)["bool"] =                    BOOL;
-    (*KeywordMap)["float"] =                   FLOAT;
-    (*KeywordMap)["int"] =                     INT;
-    (*KeywordMap)["bvec2"] =                   BVEC2;
-    (*KeywordMap)["bvec3"] =                   BVEC3;
-    (*KeywordMap)["bvec4"] =                   BVEC4;
-    (*KeywordMap)["vec2"] =                    VEC2;
-    (*KeywordMap)["vec3"] =                    VEC3;
-    (*KeywordMap)["vec4"] =                    VEC4;
-    (*KeywordMap)["ivec2"] =                   IVEC2;
-    (*KeywordMap)["ivec3"] =                   IVEC3;
-    (*KeywordMap)["ivec4"] =                   IVEC4;
-    (*KeywordMap)["mat2"] =                    MAT2;
-    (*KeywordMap)["mat3"] =                    MAT3;
-    (*KeywordMap)["mat4"] =                    MAT4;
-    (*KeywordMap)["sampler2D"] =               SAMPLER2D;
-    (*KeywordMap)["samplerCube"] =             SAMPLERCUBE;
-    (*KeywordMap)["true"] =                    BOOLCONSTANT;
-    (*KeywordMap)["false"] =                   BOOLCONSTANT;
-    (*KeywordMap)["attribute"] =               ATTRIBUTE;
-    (*KeywordMap)["varying"] =                 VARYING;
-    (*KeywordMap)["buffer"] =                  BUFFER;
-    (*KeywordMap)["coherent"] =                COHERENT;
-    (*KeywordMap)["restrict"] =                RESTRICT;
-    (*KeywordMap)["readonly"] =                READONLY;
-    (*KeywordMap)["writeonly"] =               WRITEONLY;
-    (*KeywordMap)["atomic_uint"] =             ATOMIC_UINT;
-    (*KeywordMap)["volatile"] =                VOLATILE;
-    (*KeywordMap)["layout"] =                  LAYOUT;
-    (*KeywordMap)["shared"] =                  SHARED;
-    (*KeywordMap)["patch"] =                   PATCH;
-    (*KeywordMap)["sample"] =                  SAMPLE;
-    (*KeywordMap)["subroutine"] =              SUBROUTINE;
-    (*KeywordMap)["highp"] =                   HIGH_PRECISION;
-    (*KeywordMap)["mediump"] =                 MEDIUM_PRECISION;
-    (*KeywordMap)["lowp"] =                    LOW_PRECISION;
-    (*KeywordMap)["precision"] =               PRECISION;
-    (*KeywordMap)["mat2x2"] =                  MAT2X2;
-    (*KeywordMap)["mat2x3"] =                  MAT2X3;
-    (*KeywordMap)["mat2x4"] =                  MAT2X4;
-    (*KeywordMap)["mat3x2"] =                  MAT3X2;
-    (*KeywordMap)["mat3x3"] =                  MAT3X3;
-    (*KeywordMap)["mat3x4"] =                  MAT3X4;
-    (*KeywordMap)["mat4x2"] =                  MAT4X2;
-    (*KeywordMap)["mat4x3"] =                  MAT4X3;
-    (*KeywordMap)["mat4x4"] =                  MAT4X4;
-    (*KeywordMap)["dmat2"] =                   DMAT2;
-    (*KeywordMap)["dmat3"] =                   DMAT3;
-    (*KeywordMap)["dmat4"] =                   DMAT4;
-    (*KeywordMap)["dmat2x2"] =                 DMAT2X2;
-    (*KeywordMap)["dmat2x3"] =                 DMAT2X3;
-    (*KeywordMap)["dmat2x4"] =                 DMAT2X4;
-    (*KeywordMap)["dmat3x2"] =                 DMAT3X2;
-    (*KeywordMap)["dmat3x3"] =                 DMAT3X3;
-    (*KeywordMap)["dmat3x4"] =                 DMAT3X4;
-    (*KeywordMap)["dmat4x2"] =                 DMAT4X2;
-    (*KeywordMap)["dmat4x3"] =                 DMAT4X3;
-    (*KeywordMap)["dmat4x4"] =                 DMAT4X4;
-    (*KeywordMap)["image1D"] =                 IMAGE1D;
-    (*KeywordMap)["iimage1D"] =                IIMAGE1D;
-    (*KeywordMap)["uimage1D"] =                UIMAGE1D;
-    (*KeywordMap)["image2D"] =                 IMAGE2D;
-    (*KeywordMap)["iimage2D"] =                IIMAGE2D;
-    (*KeywordMap)["uimage2D"] =                UIMAGE2D;
-    (*KeywordMap)["image3D"] =                 IMAGE3D;
-    (*KeywordMap)["iimage3D"] =                IIMAGE3D;
-    (*KeywordMap)["uimage3D"] =                UIMAGE3D;
-    (*KeywordMap)["image2DRect"] =             IMAGE2DRECT;
-    (*KeywordMap)["iimage2DRect"] =            IIMAGE2DRECT;
-    (*KeywordMap)["uimage2DRect"] =            UIMAGE2DRECT;
-    (*KeywordMap)["imageCube"] =               IMAGECUBE;
-    (*KeywordMap)["iimageCube"] =              IIMAGECUBE;
-    (*KeywordMap)["uimageCube"] =              UIMAGECUBE;
-    (*KeywordMap)["imageBuffer"] =             IMAGEBUFFER;
-    (*KeywordMap)["iimageBuffer"] =            IIMAGEBUFFER;
-    (*KeywordMap)["uimageBuffer"] =            UIMAGEBUFFER;
-    (*KeywordMap)["image1DArray"] =            IMAGE1DARRAY;
-    (*KeywordMap)["iimage1DArray"] =           IIMAGE1DARRAY;
-    (*KeywordMap)["uimage1DArray"] =           UIMAGE1DARRAY;
-    (*KeywordMap)["image2DArray"] =            IMAGE2DARRAY;
-    (*KeywordMap)["iimage2DArray"] =           IIMAGE2DARRAY;
-    (*KeywordMap)["uimage2DArray"] =           UIMAGE2DARRAY;
-    (*KeywordMap)["imageCubeArray"] =          IMAGECUBEARRAY;
-    (*KeywordMap)["iimageCubeArray"] =         IIMAGECUBEARRAY;
-    (*KeywordMap)["uimageCubeArray"] =         UIMAGECUBEARRAY;
-    (*KeywordMap)["image2DMS"] =               IMAGE2DMS;
-    (*KeywordMap)["iimage2DMS"] =              IIMAGE2DMS;
-    (*KeywordMap)["uimage2DMS"] =              UIMAGE2DMS;
-    (*KeywordMap)["image2DMSArray"] =          IMAGE2DMSARRAY;
-    (*KeywordMap)["iimage2DMSArray"] =         IIMAGE2DMSARRAY;
-    (*KeywordMap)["uimage2DMSArray"] =         UIMAGE2DMSARRAY;
-    (*KeywordMap)["double"] =                  DOUBLE;
-    (*KeywordMap)["dvec2"] =                   DVEC2;
-    (*KeywordMap)["dvec3"] =                   DVEC3;
-    (*KeywordMap)["dvec4"] =                   DVEC4;
-    (*KeywordMap)["samplerCubeArray"] =        SAMPLERCUBEARRAY;
-    (*KeywordMap)["samplerCubeArrayShadow"] =  SAMPLERCUBEARRAYSHADOW;
-    (*KeywordMap)["isamplerCubeArray"] =       ISAMPLERCUBEARRAY;
-    (*KeywordMap)["usamplerCubeArray"] =       USAMPLERCUBEARRAY;
-    (*KeywordMap)["sampler1DArrayShadow"] =    SAMPLER1DARRAYSHADOW;
-    (*KeywordMap)["isampler1DArray"] =         ISAMPLER1DARRAY;
-    (*KeywordMap)["usampler1D"] =              USAMPLER1D;
-    (*KeywordMap)["isampler1D"] =              ISAMPLER1D;
-    (*KeywordMap)["usampler1DArray"] =         USAMPLER1DARRAY;
-    (*KeywordMap)["samplerBuffer"] =           SAMPLERBUFFER;
-    (*KeywordMap)["uint"] =                    UINT;
-    (*KeywordMap)["uvec2"] =                   UVEC2;
-    (*KeywordMap)["uvec3"] =                   UVEC3;
-    (*KeywordMap)["uvec4"] =                   UVEC4;
-    (*KeywordMap)["samplerCubeShadow"] =       SAMPLERCUBESHADOW;
-    (*KeywordMap)["sampler2DArray"] =          SAMPLER2DARRAY;
-    (*KeywordMap)["sampler2DArrayShadow"] =    SAMPLER2DARRAYSHADOW;
-    (*KeywordMap)["isampler2D"] =              ISAMPLER2D;
-    (*KeywordMap)["isampler3D"] =              ISAMPLER3D;
-    (*KeywordMap)["isamplerCube"] =            ISAMPLERCUBE;
-    (*KeywordMap)["isampler2DArray"] =         ISAMPLER2DARRAY;
-    (*KeywordMap)["usampler2D"] =              USAMPLER2D;
-    (*KeywordMap)["usampler3D"] =              USAMPLER3D;
-    (*KeywordMap)["usamplerCube"] =            USAMPLERCUBE;
-    (*KeywordMap)["usampler2DArray"] =         USAMPLER2DARRAY;
-    (*KeywordMap)["isampler2DRect"] =          ISAMPLER2DRECT;
-    (*KeywordMap)["usampler2DRect"] =          USAMPLER2DRECT;
-    (*KeywordMap)["isamplerBuffer"] =          ISAMPLERBUFFER;
-    (*KeywordMap)["usamplerBuffer"] =          USAMPLERBUFFER;
-    (*KeywordMap)["sampler2DMS"] =             SAMPLER2DMS;
-    (*KeywordMap)["isampler2DMS"] =            ISAMPLER2DMS;
-    (*KeywordMap)["usampler2DMS"] =            USAMPLER2DMS;
-    (*KeywordMap)["sampler2DMSArray"] =        SAMPLER2DMSARRAY;
-    (*KeywordMap)["isampler2DMSArray"] =       ISAMPLER2DMSARRAY;
-    (*KeywordMap)["usampler2DMSArray"] =       USAMPLER2DMSARRAY;
-    (*KeywordMap)["sampler1D"] =               SAMPLER1D;
-    (*KeywordMap)["sampler1DShadow"] =         SAMPLER1DSHADOW;
-    (*KeywordMap)["sampler3D"] =               SAMPLER3D;
-    (*KeywordMap)["sampler2DShadow"] =         SAMPLER2DSHADOW;
-    (*KeywordMap)["sampler2DRect"] =           SAMPLER2DRECT;
-    (*KeywordMap)["sampler2DRectShadow"] =     SAMPLER2DRECTSHADOW;
-    (*KeywordMap)["sampler1DArray"] =          SAMPLER1DARRAY;
-    (*KeywordMap)["samplerExternalOES"] =      SAMPLEREXTERNALOES; // GL_OES_EGL_image_external
-    (*KeywordMap)["noperspective"] =           NOPERSPECTIVE;
-    (*KeywordMap)["smooth"] =                  SMOOTH;
-    (*KeywordMap)["flat"] =                    FLAT;
-    (*KeywordMap)["centroid"] =                CENTROID;
-    (*KeywordMap)["precise"] =                 PRECISE;
-    (*KeywordMap)["invariant"] =               INVARIANT;
-    (*KeywordMap)["packed"] =                  PACKED;
-    (*KeywordMap)["resource"] =                RESOURCE;
-    (*KeywordMap)["superp"] =                  SUPERP;
-
-    ReservedSet = new std::unordered_set<std::string>;
-    
-    ReservedSet->insert("common");
-    ReservedSet->insert("partition");
-    ReservedSet->insert("active");
-    ReservedSet->insert("asm");
-    ReservedSet->insert("class");
-    ReservedSet->insert("union");
-    ReservedSet->insert("enum");
-    ReservedSet->insert("typedef");
-    ReservedSet->insert("template");
-    ReservedSet->insert("this");
-    ReservedSet->insert("goto");
-    ReservedSet->insert("inline");
-    ReservedSet->insert("noinline");
-    ReservedSet->insert("public");
-    ReservedSet->insert("static");
-    ReservedSet->insert("extern");
-    ReservedSet->insert("external");
-    ReservedSet->insert("interface");
-    ReservedSet->insert("long");
-    ReservedSet->insert("short");
-    ReservedSet->insert("half");
-    ReservedSet->insert("fixed");
-    ReservedSet->insert("unsigned");
-    ReservedSet->insert("input");
-    ReservedSet->insert("output");
-    ReservedSet->insert("hvec2");
-    ReservedSet->insert("hvec3");
-    ReservedSet->insert("hvec4");
-    ReservedSet->insert("fvec2");
-    ReservedSet->insert("fvec3");
-    ReservedSet->insert("fvec4");
-    ReservedSet->insert("sampler3DRect");
-    ReservedSet->insert("filter");
-    ReservedSet->insert("sizeof");
-    ReservedSet->insert("cast");
-    ReservedSet->insert("namespace");
-    ReservedSet->insert("using");
+    KeywordTable = new std::vector<int>;
+
+    AddKeyword("const", CONST);
+    AddKeyword("uniform", UNIFORM);
+    AddKeyword("in", IN);
+    AddKeyword("out", OUT);
+    AddKeyword("inout", INOUT);
+    AddKeyword("struct", STRUCT);
+    AddKeyword("break", BREAK);
+    AddKeyword("continue", CONTINUE);
+    AddKeyword("do", DO);
+    AddKeyword("for", FOR);
+    AddKeyword("while", WHILE);
+    AddKeyword("switch", SWITCH);
+    AddKeyword("case", CASE);
+    AddKeyword("default", DEFAULT);
+    AddKeyword("if", IF);
+    AddKeyword("else", ELSE);
+    AddKeyword("discard", DISCARD);
+    AddKeyword("return", RETURN);
+    AddKeyword("void", VOID);
+    AddKeyword("bool", BOOL);
+    AddKeyword("float", FLOAT);
+    AddKeyword("int", INT);
+    AddKeyword("bvec2", BVEC2);
+    AddKeyword("bvec3", BVEC3);
+    AddKeyword("bvec4", BVEC4);
+    AddKeyword("vec2", VEC2);
+    AddKeyword("vec3", VEC3);
+    AddKeyword("vec4", VEC4);
+    AddKeyword("ivec2", IVEC2);
+    AddKeyword("ivec3", IVEC3);
+    AddKeyword("ivec4", IVEC4);
+    AddKeyword("mat2", MAT2);
+    AddKeyword("mat3", MAT3);
+    AddKeyword("mat4", MAT4);
+    AddKeyword("sampler2D", SAMPLER2D);
+    AddKeyword("samplerCube", SAMPLERCUBE);
+    AddKeyword("true", BOOLCONSTANT);
+    AddKeyword("false", BOOLCONSTANT);
+    AddKeyword("attribute", ATTRIBUTE);
+    AddKeyword("varying", VARYING);
+    AddKeyword("buffer", BUFFER);
+    AddKeyword("coherent", COHERENT);
+    AddKeyword("restrict", RESTRICT);
+    AddKeyword("readonly", READONLY);
+    AddKeyword("writeonly", WRITEONLY);
+    AddKeyword("atomic_uint", ATOMIC_UINT);
+    AddKeyword("volatile", VOLATILE);
+    AddKeyword("layout", LAYOUT);
+    AddKeyword("shared", SHARED);
+    AddKeyword("patch", PATCH);
+    AddKeyword("sample", SAMPLE);
+    AddKeyword("subroutine", SUBROUTINE);
+    AddKeyword("highp", HIGH_PRECISION);
+    AddKeyword("mediump", MEDIUM_PRECISION);
+    AddKeyword("lowp", LOW_PRECISION);
+    AddKeyword("precision", PRECISION);
+    AddKeyword("mat2x2", MAT2X2);
+    AddKeyword("mat2x3", MAT2X3);
+    AddKeyword("mat2x4", MAT2X4);
+    AddKeyword("mat3x2", MAT3X2);
+    AddKeyword("mat3x3", MAT3X3);
+    AddKeyword("mat3x4", MAT3X4);
+    AddKeyword("mat4x2", MAT4X2);
+    AddKeyword("mat4x3", MAT4X3);
+    AddKeyword("mat4x4", MAT4X4);
+    AddKeyword("dmat2", DMAT2);
+    AddKeyword("dmat3", DMAT3);
+    AddKeyword("dmat4", DMAT4);
+    AddKeyword("dmat2x2", DMAT2X2);
+    AddKeyword("dmat2x3", DMAT2X3);
+    AddKeyword("dmat2x4", DMAT2X4);
+    AddKeyword("dmat3x2", DMAT3X2);
+    AddKeyword("dmat3x3", DMAT3X3);
+    AddKeyword("dmat3x4", DMAT3X4);
+    AddKeyword("dmat4x2", DMAT4X2);
+    AddKeyword("dmat4x3", DMAT4X3);
+    AddKeyword("dmat4x4", DMAT4X4);
+    AddKeyword("image1D", IMAGE1D);
+    AddKeyword("iimage1D", IIMAGE1D);
+    AddKeyword("uimage1D", UIMAGE1D);
+    AddKeyword("image2D", IMAGE2D);
+    AddKeyword("iimage2D", IIMAGE2D);
+    AddKeyword("uimage2D", UIMAGE2D);
+    AddKeyword("image3D", IMAGE3D);
+    AddKeyword("iimage3D", IIMAGE3D);
+    AddKeyword("uimage3D", UIMAGE3D);
+    AddKeyword("image2DRect", IMAGE2DRECT);
+    AddKeyword("iimage2DRect", IIMAGE2DRECT);
+    AddKeyword("uimage2DRect", UIMAGE2DRECT);
+    AddKeyword("imageCube", IMAGECUBE);
+    AddKeyword("iimageCube", IIMAGECUBE);
+    AddKeyword("uimageCube", UIMAGECUBE);
+    AddKeyword("imageBuffer", IMAGEBUFFER);
+    AddKeyword("iimageBuffer", IIMAGEBUFFER);
+    AddKeyword("uimageBuffer", UIMAGEBUFFER);
+    AddKeyword("image1DArray", IMAGE1DARRAY);
+    AddKeyword("iimage1DArray", IIMAGE1DARRAY);
+    AddKeyword("uimage1DArray", UIMAGE1DARRAY);
+    AddKeyword("image2DArray", IMAGE2DARRAY);
+    AddKeyword("iimage2DArray", IIMAGE2DARRAY);
+    AddKeyword("uimage2DArray", UIMAGE2DARRAY);
+    AddKeyword("imageCubeArray", IMAGECUBEARRAY);
+    AddKeyword("iimageCubeArray", IIMAGECUBEARRAY);
+    AddKeyword("uimageCubeArray", UIMAGECUBEARRAY);
+    AddKeyword("image2DMS", IMAGE2DMS);
+    AddKeyword("iimage2DMS", IIMAGE2DMS);
+    AddKeyword("uimage2DMS", UIMAGE2DMS);
+    AddKeyword("image2DMSArray", IMAGE2DMSARRAY);
+    AddKeyword("iimage2DMSArray", IIMAGE2DMSARRAY);
+    AddKeyword("uimage2DMSArray", UIMAGE2DMSARRAY);
+    AddKeyword("double", DOUBLE);
+    AddKeyword("dvec2", DVEC2);
+    AddKeyword("dvec3", DVEC3);
+    AddKeyword("dvec4", DVEC4);
+    AddKeyword("samplerCubeArray", SAMPLERCUBEARRAY);
+    AddKeyword("samplerCubeArrayShadow", SAMPLERCUBEARRAYSHADOW);
+    AddKeyword("isamplerCubeArray", ISAMPLERCUBEARRAY);
+    AddKeyword("usamplerCubeArray", USAMPLERCUBEARRAY);
+    AddKeyword("sampler1DArrayShadow", SAMPLER1DARRAYSHADOW);
+    AddKeyword("isampler1DArray", ISAMPLER1DARRAY);
+    AddKeyword("usampler1D", USAMPLER1D);
+    AddKeyword("isampler1D", ISAMPLER1D);
+    AddKeyword("usampler1DArray", USAMPLER1DARRAY);
+    AddKeyword("samplerBuffer", SAMPLERBUFFER);
+    AddKeyword("uint", UINT);
+    AddKeyword("uvec2", UVEC2);
+    AddKeyword("uvec3", UVEC3);
+    AddKeyword("uvec4", UVEC4);
+    AddKeyword("samplerCubeShadow", SAMPLERCUBESHADOW);
+    AddKeyword("sampler2DArray", SAMPLER2DARRAY);
+    AddKeyword("sampler2DArrayShadow", SAMPLER2DARRAYSHADOW);
+    AddKeyword("isampler2D", ISAMPLER2D);
+    AddKeyword("isampler3D", ISAMPLER3D);
+    AddKeyword("isamplerCube", ISAMPLERCUBE);
+    AddKeyword("isampler2DArray", ISAMPLER2DARRAY);
+    AddKeyword("usampler2D", USAMPLER2D);
+    AddKeyword("usampler3D", USAMPLER3D);
+    AddKeyword("usamplerCube", USAMPLERCUBE);
+    AddKeyword("usampler2DArray", USAMPLER2DARRAY);
+    AddKeyword("isampler2DRect", ISAMPLER2DRECT);
+    AddKeyword("usampler2DRect", USAMPLER2DRECT);
+    AddKeyword("isamplerBuffer", ISAMPLERBUFFER);
+    AddKeyword("usamplerBuffer", USAMPLERBUFFER);
+    AddKeyword("sampler2DMS", SAMPLER2DMS);
+    AddKeyword("isampler2DMS", ISAMPLER2DMS);
+    AddKeyword("usampler2DMS", USAMPLER2DMS);
+    AddKeyword("sampler2DMSArray", SAMPLER2DMSARRAY);
+    AddKeyword("isampler2DMSArray", ISAMPLER2DMSARRAY);
+    AddKeyword("usampler2DMSArray", USAMPLER2DMSARRAY);
+    AddKeyword("sampler1D", SAMPLER1D);
+    AddKeyword("sampler1DShadow", SAMPLER1DSHADOW);
+    AddKeyword("sampler3D", SAMPLER3D);
+    AddKeyword("sampler2DShadow", SAMPLER2DSHADOW);
+    AddKeyword("sampler2DRect", SAMPLER2DRECT);
+    AddKeyword("sampler2DRectShadow", SAMPLER2DRECTSHADOW);
+    AddKeyword("sampler1DArray", SAMPLER1DARRAY);
+    AddKeyword("samplerExternalOES", SAMPLEREXTERNALOES); // GL_OES_EGL_image_external
+    AddKeyword("noperspective", NOPERSPECTIVE);
+    AddKeyword("smooth", SMOOTH);
+    AddKeyword("flat", FLAT);
+    AddKeyword("centroid", CENTROID);
+    AddKeyword("precise", PRECISE);
+    AddKeyword("invariant", INVARIANT);
+    AddKeyword("packed", PACKED);
+    AddKeyword("resource", RESOURCE);
+    AddKeyword("superp", SUPERP);
+
+
+    AddKeyword("common", ReservedKeyword);
+    AddKeyword("partition", ReservedKeyword);
+    AddKeyword("active", ReservedKeyword);
+    AddKeyword("asm", ReservedKeyword);
+    AddKeyword("class", ReservedKeyword);
+    AddKeyword("union", ReservedKeyword);
+    AddKeyword("enum", ReservedKeyword);
+    AddKeyword("typedef", ReservedKeyword);
+    AddKeyword("template", ReservedKeyword);
+    AddKeyword("this", ReservedKeyword);
+    AddKeyword("goto", ReservedKeyword);
+    AddKeyword("inline", ReservedKeyword);
+    AddKeyword("noinline", ReservedKeyword);
+    AddKeyword("public", ReservedKeyword);
+    AddKeyword("static", ReservedKeyword);
+    AddKeyword("extern", ReservedKeyword);
+    AddKeyword("external", ReservedKeyword);
+    AddKeyword("interface", ReservedKeyword);
+    AddKeyword("long", ReservedKeyword);
+    AddKeyword("short", ReservedKeyword);
+    AddKeyword("half", ReservedKeyword);
+    AddKeyword("fixed", ReservedKeyword);
+    AddKeyword("unsigned", ReservedKeyword);
+    AddKeyword("input", ReservedKeyword);
+    AddKeyword("output", ReservedKeyword);
+    AddKeyword("hvec2", ReservedKeyword);
+    AddKeyword("hvec3", ReservedKeyword);
+    AddKeyword("hvec4", ReservedKeyword);
+    AddKeyword("fvec2", ReservedKeyword);
+    AddKeyword("fvec3", ReservedKeyword);
+    AddKeyword("fvec4", ReservedKeyword);
+    AddKeyword("sampler3DRect", ReservedKeyword);
+    AddKeyword("filter", ReservedKeyword);
+    AddKeyword("sizeof", ReservedKeyword);
+    AddKeyword("cast", ReservedKeyword);
+    AddKeyword("namespace", ReservedKeyword);
+    AddKeyword("using", ReservedKeyword);
 }
 
 void TScanContext::deleteKeywordMap()
 {
-    delete KeywordMap;
-    KeywordMap = 0;
-    delete ReservedSet;
-    ReservedSet = 0;
+    delete KeywordTable;
+    KeywordTable = 0;
 }
 
 int TScanContext::tokenize(TPpContext* pp, TParserToken& token)
@@ -598,7 +605,7 @@ int TScanContext::tokenize(TPpContext* pp, TParserToken& token)
         case PpAtomConstUint:          parserToken->sType.lex.i = ppToken.ival;       return UINTCONSTANT;
         case PpAtomConstFloat:         parserToken->sType.lex.d = ppToken.dval;       return FLOATCONSTANT;
         case PpAtomConstDouble:        parserToken->sType.lex.d = ppToken.dval;       return DOUBLECONSTANT;
-        case PpAtomIdentifier:         return tokenizeIdentifier();
+        case PpAtomIdentifier:         return tokenizeIdentifier(ppToken.atom);
 
         case EOF:                       return 0;
                                    
@@ -612,17 +619,21 @@ int TScanContext::tokenize(TPpContext* pp, TParserToken& token)
     } while (true);
 }
 
-int TScanContext::tokenizeIdentifier()
+int TScanContext::tokenizeIdentifier(int atom)
 {
-    if (ReservedSet->find(tokenText) != ReservedSet->end())
+    parserToken->sType.lex.atom = atom;
+
+    // Keywords were all interned before any compile started, so any
+    // compile-local atom is past the end of the table.
+    int entry = (size_t)atom < KeywordTable->size() ? (*KeywordTable)[atom] : 0;
+    if (entry == ReservedKeyword)
         return reservedWord();
 
-    auto it = KeywordMap->find(tokenText);
-    if (it == KeywordMap->end()) {
+    if (entry == 0) {
         // Should have an identifier of some sort
         return identifierOrType();
     }
-    keyword = it->second;
+    keyword = entry;
     field = false;
 
     switch (keyword) {
@@ -715,8 +726,8 @@ int TScanContext::tokenizeIdentifier()
     case LAYOUT:
     {
         const int numLayoutExts = 2;
-        const char* layoutExts[numLayoutExts] = { E_GL_ARB_shading_language_420pack,
-                                                  E_GL_ARB_explicit_attrib_location };
+        const TExtension layoutExts[numLayoutExts] = { E_GL_ARB_shading_language_420pack,
+                                                       E_GL_ARB_explicit_attrib_location };
         if ((parseContext.profile == EEsProfile && parseContext.version < 300) ||
             (parseContext.profile != EEsProfile && parseContext.version < 140 &&
             ! parseContext.extensionsTurnedOn(numLayoutExts, layoutExts)))
@@ -905,7 +916,7 @@ int TScanContext::tokenizeIdentifier()
             reservedWord();
         else if (parseContext.version < 140 && ! parseContext.symbolTable.atBuiltInLevel() && ! parseContext.extensionTurnedOn(E_GL_ARB_texture_rectangle)) {
             if (parseContext.relaxedErrors())
-                parseContext.requireExtensions(loc, 1, &E_GL_ARB_texture_rectangle, "texture-rectangle sampler keyword");
+                parseContext.requireExtensions(loc, E_GL_ARB_texture_rectangle, "texture-rectangle sampler keyword");
             else
                 reservedWord();
         }
@@ -986,6 +997,10 @@ int TScanContext::tokenizeIdentifier()
     }
 }
 
+//
+// The identifier's atom goes along in the parser token, and the symbol table
+// is keyed by atoms, so the lookup here needs no hashing of the name.
+//
 int TScanContext::identifierOrType()
 {
     parserToken->sType.lex.string = NewPoolTString(tokenText);
@@ -995,7 +1010,7 @@ int TScanContext::identifierOrType()
         return FIELD_SELECTION;
     }
 
-    parserToken->sType.lex.symbol = parseContext.symbolTable.find(*parserToken->sType.lex.string);
+    parserToken->sType.lex.symbol = parseContext.symbolTable.find(*parserToken->sType.lex.string, 0, 0, parserToken->sType.lex.atom);
     if (afterType == false && parserToken->sType.lex.symbol) {
         if (const TVariable* variable = parserToken->sType.lex.symbol->getAsVariable()) {
             if (variable->isUserType()) {
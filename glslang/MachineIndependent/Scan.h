@@ -50,6 +50,8 @@ public:
         numSources(n), sources(s), lengths(L), currentSource(0), currentChar(0), stringBias(b), finale(f)
     {
         loc = new TSourceLoc[numSources];
+        for (int i = 0; i < numSources; ++i)
+            loc[i].init();
         loc[currentSource].string = -stringBias;
         loc[currentSource].line = 1;
         loc[currentSource].column = 0;
@@ -99,6 +101,24 @@ public:
         return sources[sourceToRead][charToRead];
     }
 
+    // Move past characters, in bulk rather than get() by get(), up to the
+    // next one 'stop' is true for.  The last character of each string is
+    // left for get(), which knows how to move on to the next string.
+    // 'stop' must be true for '\n' and '\r', so only the column changes.
+    void skipTo(const bool stop[256])
+    {
+        if (currentSource >= numSources || lengths[currentSource] == 0)
+            return;
+
+        const char* source = sources[currentSource];
+        size_t last = lengths[currentSource] - 1;
+        size_t c = currentChar;
+        while (c < last && ! stop[(unsigned char)source[c]])
+            ++c;
+        loc[currentSource].column += (int)(c - currentChar);
+        currentChar = c;
+    }
+
     // go back one character
     void unget()
     {
@@ -136,6 +156,13 @@ public:
     void setLine(int newLine) { loc[getLastValidSourceIndex()].line = newLine; }
     void setString(int newString) { loc[getLastValidSourceIndex()].string = newString; }
 
+    // for the contents of an included file, located in the includer's string, by the file's name
+    void setName(const TString* name)
+    {
+        for (int i = 0; i < numSources; ++i)
+            loc[i].name = name;
+    }
+
     const TSourceLoc& getSourceLoc() const { return loc[std::max(0, std::min(currentSource, numSources - finale - 1))]; }
     // Returns the index (starting from 0) of the most recent valid source string we are reading from.
     int getLastValidSourceIndex() const { return std::min(currentSource, numSources - 1); }
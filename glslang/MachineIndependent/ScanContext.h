@@ -60,7 +60,7 @@ protected:
     TScanContext(TScanContext&);
     TScanContext& operator=(TScanContext&);
 
-    int tokenizeIdentifier();
+    int tokenizeIdentifier(int atom);
     int identifierOrType();
     int reservedWord();
     int identifierOrReserved(bool reserved);
@@ -41,9 +41,14 @@
 // and the shading language compiler/linker.
 //
 #include <string.h>
+#include <stddef.h>
 #include <iostream>
 #include <sstream>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
 #include "SymbolTable.h"
+#include "SymbolTableSnapshot.h"
 #include "ParseHelper.h"
 #include "Scan.h"
 #include "ScanContext.h"
@@ -57,6 +62,7 @@
 #include "../Public/ShaderLang.h"
 #include "reflection.h"
 #include "Initialize.h"
+#include "BuiltInImage.h"
 
 namespace { // anonymous namespace for file-local functions and symbols
 
@@ -119,7 +125,74 @@ enum EPrecisionClass {
 TSymbolTable* CommonSymbolTable[VersionCount][ProfileCount][EPcCount] = {};
 TSymbolTable* SharedSymbolTables[VersionCount][ProfileCount][EShLangCount] = {};
 
-TPoolAllocator* PerProcessGPA = 0;
+// The process-global pools holding the tables above: one for each version/profile's
+// common tables, and one for each of its stages' tables, so that different
+// versions/profiles/stages can be set up at the same time.  (Tables read from
+// a snapshot are all in the version/profile's pool.)
+TPoolAllocator* PerProcessGPA[VersionCount][ProfileCount] = {};
+TPoolAllocator* PerProcessStageGPA[VersionCount][ProfileCount][EShLangCount] = {};
+
+// Whether each version/profile's common tables, and each of its stage's table,
+// are complete; once set, they can be read without any locking.  Setting up a
+// version/profile, or one of its stages, is serialized only with other threads
+// wanting that same one.  A stage's table is set up only once a compile needs
+// it, after the common tables it adopts.
+std::atomic<bool> BuiltInTablesReady[VersionCount][ProfileCount];
+std::mutex BuiltInTablesLock[VersionCount][ProfileCount];
+std::atomic<bool> BuiltInStageReady[VersionCount][ProfileCount][EShLangCount];
+std::mutex BuiltInStageLock[VersionCount][ProfileCount][EShLangCount];
+
+// The context-dependent built-ins for each version/profile/stage, per distinct set
+// of resources, each in its own process-global pool; see GetContextSymbolTable().
+struct TContextSymbolTable {
+    TPoolAllocator* pool;
+    TSymbolTable* table;
+};
+typedef std::unordered_map<std::string, TContextSymbolTable> TContextSymbolTableMap;
+TContextSymbolTableMap ContextSymbolTables[VersionCount][ProfileCount][EShLangCount];
+std::mutex ContextSymbolTablesLock[VersionCount][ProfileCount];
+
+// Beyond this many sets of resources for one version/profile/stage, they vary
+// too much to be worth keeping, and are parsed for each compile.
+const size_t MaxContextSymbolTables = 16;
+
+// A mapped snapshot of the tables above, see LoadBuiltins(), and where in it
+// each version/profile's tables are, if there.
+void* BuiltInImageMapping = 0;
+const char* BuiltInImage = 0;
+struct TBuiltInImageEntry {
+    size_t offset;
+    size_t size;
+};
+TBuiltInImageEntry BuiltInImageEntries[VersionCount][ProfileCount] = {};
+
+// The names the loaded snapshot's built-ins declare, and whether ShInitialize()
+// has added the built-ins' names to the atom table yet; see AddBuiltInNames().
+std::vector<std::string> BuiltInImageNames;
+bool BuiltInNamesAdded = false;
+
+// Whether ShInitialize() loads the snapshot compiled into the library, when no
+// other is loaded; see UnloadBuiltins().
+bool UseGeneratedBuiltInImage = true;
+
+// Identifies the snapshot format.  Bump the version on any change to what
+// TSymbolTableWriter writes or TSymbolTableReader reads.
+const int BuiltInImageMagic = 0x53424c47;  // "GLBS"
+const int BuiltInImageFormatVersion = 7;
+
+//
+// Identifies what a snapshot's enumerants depend on, beyond the format version:
+// the number of each kind of enumerant.  Types are written field by field, so
+// their layout in this build doesn't matter.
+//
+std::string BuiltInImageStamp()
+{
+    std::ostringstream stamp;
+    stamp << GetGlslVersionString() << " " << EbtNumTypes << " " << EsdNumDims << " " << EvqLast << " "
+          << EbvLast << " " << ElfCount << " " << ETextureGuardEnd << " " << NumExtensions;
+
+    return stamp.str();
+}
 
 //
 // Parse and add to the given symbol table the content of the given shader string.
@@ -165,55 +238,69 @@ int CommonIndex(EProfile profile, EShLanguage language)
 }
 
 //
-// To initialize per-stage shared tables, with the common table already complete.
+// Whether the given stage has any built-ins for the given version/profile.
 //
-void InitializeStageSymbolTable(TBuiltIns& builtIns, int version, EProfile profile, EShLanguage language, TInfoSink& infoSink, TSymbolTable** commonTable, TSymbolTable** symbolTables)
+bool HasStageBuiltIns(int version, EProfile profile, EShLanguage language)
 {
-    (*symbolTables[language]).adoptLevels(*commonTable[CommonIndex(profile, language)]);
-    InitializeSymbolTable(builtIns.getStageString(language), version, profile, language, infoSink, *symbolTables[language]);
-    IdentifyBuiltIns(version, profile, language, *symbolTables[language]);
+    switch (language) {
+    case EShLangVertex:
+    case EShLangFragment:
+        // always have vertex and fragment
+        return true;
+    case EShLangTessControl:
+    case EShLangTessEvaluation:
+    case EShLangGeometry:
+        return (profile != EEsProfile && version >= 150) ||
+               (profile == EEsProfile && version >= 310);
+    case EShLangCompute:
+        return (profile != EEsProfile && version >= 430) ||
+               (profile == EEsProfile && version >= 310);
+    default:
+        return false;
+    }
+}
+
+//
+// To initialize a per-stage shared table, with the common table already complete.
+//
+void InitializeStageSymbolTable(TBuiltIns& builtIns, int version, EProfile profile, EShLanguage language, TInfoSink& infoSink, TSymbolTable& commonTable, TSymbolTable& symbolTable)
+{
+    symbolTable.adoptLevels(commonTable);
+    InitializeSymbolTable(builtIns.getStageString(language), version, profile, language, infoSink, symbolTable);
+    symbolTable.addLazyFunctions(builtIns.getStageFunctions(language), version, profile, language);
+    IdentifyBuiltIns(version, profile, language, symbolTable);
     if (profile == EEsProfile && version >= 300)
-        (*symbolTables[language]).setNoBuiltInRedeclarations();
+        symbolTable.setNoBuiltInRedeclarations();
     if (version == 110)
-        (*symbolTables[language]).setSeparateNameSpaces();
+        symbolTable.setSeparateNameSpaces();
 }
 
 //
-// Initialize the full set of shareable symbol tables;
-// The common (cross-stage) and those shareable per-stage.
+// Initialize the common (cross-stage) shareable symbol tables.
 //
-bool InitializeSymbolTables(TInfoSink& infoSink, TSymbolTable** commonTable,  TSymbolTable** symbolTables, int version, EProfile profile)
+// Identifying each stage's built-ins also tags functions in the common tables
+// (operators, extensions), so that is done here for every stage, ahead of
+// whichever stages get set up later.
+//
+bool InitializeCommonSymbolTables(TBuiltIns& builtIns, TInfoSink& infoSink, TSymbolTable** commonTable, int version, EProfile profile)
 {
-    TBuiltIns builtIns;
-    builtIns.initialize(version, profile);
-
-    // do the common tables
     InitializeSymbolTable(builtIns.getCommonString(), version, profile, EShLangVertex, infoSink, *commonTable[EPcGeneral]);
-    if (profile == EEsProfile)
+    commonTable[EPcGeneral]->addLazyFunctions(builtIns.getCommonFunctions(), version, profile, EShLangVertex);
+    if (profile == EEsProfile) {
         InitializeSymbolTable(builtIns.getCommonString(), version, profile, EShLangFragment, infoSink, *commonTable[EPcFragment]);
-
-    // do the per-stage tables
-
-    // always have vertex and fragment
-    InitializeStageSymbolTable(builtIns, version, profile, EShLangVertex, infoSink, commonTable, symbolTables);
-    InitializeStageSymbolTable(builtIns, version, profile, EShLangFragment, infoSink, commonTable, symbolTables);
-
-    // check for tessellation
-    if ((profile != EEsProfile && version >= 150) ||
-        (profile == EEsProfile && version >= 310)) {
-        InitializeStageSymbolTable(builtIns, version, profile, EShLangTessControl, infoSink, commonTable, symbolTables);
-        InitializeStageSymbolTable(builtIns, version, profile, EShLangTessEvaluation, infoSink, commonTable, symbolTables);
+        commonTable[EPcFragment]->addLazyFunctions(builtIns.getCommonFunctions(), version, profile, EShLangFragment);
     }
 
-    // check for geometry
-    if ((profile != EEsProfile && version >= 150) ||
-        (profile == EEsProfile && version >= 310))
-        InitializeStageSymbolTable(builtIns, version, profile, EShLangGeometry, infoSink, commonTable, symbolTables);
-
-    // check for compute
-    if ((profile != EEsProfile && version >= 430) ||
-        (profile == EEsProfile && version >= 310))
-        InitializeStageSymbolTable(builtIns, version, profile, EShLangCompute, infoSink, commonTable, symbolTables);
+    for (int stage = 0; stage < EShLangCount; ++stage) {
+        if (! HasStageBuiltIns(version, profile, (EShLanguage)stage))
+            continue;
+
+        // an empty stage level, so only what's common is identified
+        TSymbolTable stageTable;
+        stageTable.adoptLevels(*commonTable[CommonIndex(profile, (EShLanguage)stage)]);
+        stageTable.push();
+        IdentifyBuiltIns(version, profile, (EShLanguage)stage, stageTable);
+    }
 
     return true;
 }
@@ -229,6 +316,240 @@ bool AddContextSpecificSymbols(const TBuiltInResource* resources, TInfoSink& inf
     return true;
 }
 
+//
+// Get the context-dependent built-ins for a compile, as a table adopting the
+// given shared table, for the compile to copy from.  These depend only on the
+// stage, version, profile, and resources (not the resource 'limits' flags), so
+// they are parsed just once for each, and otherwise looked up.  Returns 0 if
+// they are not to be kept, for the compile to add them itself.
+//
+TSymbolTable* GetContextSymbolTable(const TBuiltInResource& resources, TInfoSink& infoSink, int version, EProfile profile,
+                                    EShLanguage language, TSymbolTable& sharedTable)
+{
+    int versionIndex = MapVersionToIndex(version);
+    int profileIndex = MapProfileToIndex(profile);
+    TContextSymbolTableMap& tables = ContextSymbolTables[versionIndex][profileIndex][language];
+    std::string key(reinterpret_cast<const char*>(&resources), offsetof(TBuiltInResource, limits));
+    {
+        std::lock_guard<std::mutex> guard(ContextSymbolTablesLock[versionIndex][profileIndex]);
+        TContextSymbolTableMap::const_iterator it = tables.find(key);
+        if (it != tables.end())
+            return it->second.table;
+        if (tables.size() >= MaxContextSymbolTables)
+            return 0;
+    }
+
+    // Parse them in a pool of their own, and copy the result to a process-global
+    // pool, as SetupBuiltinSymbolTable() does, without holding the lock.
+    TPoolAllocator& previousAllocator = GetThreadPoolAllocator();
+    TPoolAllocator* builtInPoolAllocator = new TPoolAllocator();
+    SetThreadPoolAllocator(*builtInPoolAllocator);
+
+    TSymbolTable* localTable = new TSymbolTable;
+    localTable->adoptLevels(sharedTable);
+    AddContextSpecificSymbols(&resources, infoSink, *localTable, version, profile, language);
+
+    TContextSymbolTable context;
+    context.pool = new TPoolAllocator();
+    SetThreadPoolAllocator(*context.pool);
+    context.table = new TSymbolTable;
+    context.table->adoptLevels(sharedTable);
+    context.table->copyTable(*localTable);
+    context.table->readOnly();
+
+    delete localTable;
+    delete builtInPoolAllocator;
+    SetThreadPoolAllocator(previousAllocator);
+
+    // Another thread might have gotten there first
+    std::lock_guard<std::mutex> guard(ContextSymbolTablesLock[versionIndex][profileIndex]);
+    std::pair<TContextSymbolTableMap::iterator, bool> inserted = tables.insert(std::make_pair(key, context));
+    if (! inserted.second) {
+        delete context.table;
+        delete context.pool;
+    }
+
+    return inserted.first->second.table;
+}
+
+//
+// Set up a version/profile's tables from the loaded snapshot, in a new
+// process-global pool, if the snapshot has them.  Nothing is set up if the
+// snapshot's tables are malformed.
+//
+bool ReadBuiltInImage(int versionIndex, int profileIndex, EProfile profile)
+{
+    const TBuiltInImageEntry& entry = BuiltInImageEntries[versionIndex][profileIndex];
+    if (entry.size == 0)
+        return false;
+
+    TPoolAllocator& previousAllocator = GetThreadPoolAllocator();
+    TPoolAllocator* builtInPoolAllocator = new TPoolAllocator();
+    SetThreadPoolAllocator(*builtInPoolAllocator);
+
+    TSymbolTable* commonTable[EPcCount] = {};
+    TSymbolTable* stageTables[EShLangCount] = {};
+    TSymbolTableReader reader(BuiltInImage + entry.offset, entry.size);
+
+    int commonMask = reader.readInt();
+    for (int precClass = 0; precClass < EPcCount; ++precClass) {
+        if (commonMask & (1 << precClass)) {
+            commonTable[precClass] = new TSymbolTable;
+            reader.readTable(*commonTable[precClass]);
+            commonTable[precClass]->readOnly();
+        }
+    }
+    int stageMask = reader.readInt();
+    bool success = commonTable[EPcGeneral] != 0;
+    for (int stage = 0; stage < EShLangCount && success; ++stage) {
+        if (stageMask & (1 << stage)) {
+            TSymbolTable* stageCommon = commonTable[CommonIndex(profile, (EShLanguage)stage)];
+            if (stageCommon == 0) {
+                success = false;
+                break;
+            }
+            stageTables[stage] = new TSymbolTable;
+            stageTables[stage]->adoptLevels(*stageCommon);
+            reader.readTable(*stageTables[stage]);
+            stageTables[stage]->readOnly();
+        }
+    }
+    success = success && ! reader.failed();
+
+    if (success) {
+        for (int precClass = 0; precClass < EPcCount; ++precClass)
+            CommonSymbolTable[versionIndex][profileIndex][precClass] = commonTable[precClass];
+        for (int stage = 0; stage < EShLangCount; ++stage) {
+            if (stageTables[stage]) {
+                SharedSymbolTables[versionIndex][profileIndex][stage] = stageTables[stage];
+                BuiltInStageReady[versionIndex][profileIndex][stage].store(true, std::memory_order_release);
+            }
+        }
+        PerProcessGPA[versionIndex][profileIndex] = builtInPoolAllocator;
+    } else {
+        for (int stage = 0; stage < EShLangCount; ++stage)
+            delete stageTables[stage];
+        for (int precClass = 0; precClass < EPcCount; ++precClass)
+            delete commonTable[precClass];
+        delete builtInPoolAllocator;
+    }
+
+    SetThreadPoolAllocator(previousAllocator);
+
+    return success;
+}
+
+//
+// Write a version/profile's tables, already set up, for ReadBuiltInImage().
+//
+void WriteBuiltInImage(int versionIndex, int profileIndex, std::string& image)
+{
+    TSymbolTableWriter writer(image);
+
+    int commonMask = 0;
+    for (int precClass = 0; precClass < EPcCount; ++precClass) {
+        if (CommonSymbolTable[versionIndex][profileIndex][precClass])
+            commonMask |= 1 << precClass;
+    }
+    writer.writeInt(commonMask);
+    for (int precClass = 0; precClass < EPcCount; ++precClass) {
+        if (CommonSymbolTable[versionIndex][profileIndex][precClass])
+            writer.writeTable(*CommonSymbolTable[versionIndex][profileIndex][precClass]);
+    }
+
+    int stageMask = 0;
+    for (int stage = 0; stage < EShLangCount; ++stage) {
+        if (SharedSymbolTables[versionIndex][profileIndex][stage])
+            stageMask |= 1 << stage;
+    }
+    writer.writeInt(stageMask);
+    for (int stage = 0; stage < EShLangCount; ++stage) {
+        if (SharedSymbolTables[versionIndex][profileIndex][stage])
+            writer.writeTable(*SharedSymbolTables[versionIndex][profileIndex][stage]);
+    }
+}
+
+void UnloadBuiltInImage()
+{
+    if (BuiltInImageMapping)
+        OS_UnmapFile(BuiltInImageMapping);
+    BuiltInImageMapping = 0;
+    BuiltInImage = 0;
+    for (int version = 0; version < VersionCount; ++version) {
+        for (int p = 0; p < ProfileCount; ++p)
+            BuiltInImageEntries[version][p].size = 0;
+    }
+    BuiltInImageNames.clear();
+}
+
+//
+// Add each identifier in the text to the process-wide atom table.
+//
+void AddSharedNames(const TString& text)
+{
+    size_t c = 0;
+    while (c < text.size()) {
+        if (isalpha(text[c]) || text[c] == '_') {
+            size_t start = c;
+            while (c < text.size() && (isalnum(text[c]) || text[c] == '_'))
+                ++c;
+            TPpContext::AddSharedName(text.c_str() + start, c - start);
+        } else if (isdigit(text[c])) {
+            // a number, with its suffix
+            while (c < text.size() && (isalnum(text[c]) || text[c] == '.'))
+                ++c;
+        } else
+            ++c;
+    }
+}
+
+//
+// Add the names the built-ins declare to the process-wide atom table, so the
+// shared levels are keyed by atoms all compiles agree on; see TSymbolTableLevel.
+// They come from the loaded snapshot, which records them, else from the text
+// of the built-ins of ES 100 and of the newest version of each profile, which
+// between them declare the names of all the other versions.  A name missed
+// here is still found, by its text.
+//
+void AddBuiltInNames()
+{
+    if (BuiltInImageNames.size() > 0) {
+        for (size_t n = 0; n < BuiltInImageNames.size(); ++n)
+            TPpContext::AddSharedName(BuiltInImageNames[n].c_str(), BuiltInImageNames[n].size());
+        return;
+    }
+
+    TPoolAllocator& previousAllocator = GetThreadPoolAllocator();
+    TPoolAllocator* namesPoolAllocator = new TPoolAllocator();
+    SetThreadPoolAllocator(*namesPoolAllocator);
+
+    const int versions[] = { 100, 310, 450, 450 };
+    const EProfile profiles[] = { EEsProfile, EEsProfile, ECoreProfile, ECompatibilityProfile };
+    TBuiltInResource resources;
+    memset(&resources, 0, sizeof(resources));
+    for (int v = 0; v < (int)(sizeof(versions) / sizeof(versions[0])); ++v) {
+        TBuiltIns builtIns;
+        builtIns.initialize(versions[v], profiles[v]);
+        AddSharedNames(builtIns.getCommonString());
+        AddSharedNames(builtIns.getCommonFunctions());
+        for (int stage = 0; stage < EShLangCount; ++stage) {
+            AddSharedNames(builtIns.getStageString((EShLanguage)stage));
+            AddSharedNames(builtIns.getStageFunctions((EShLanguage)stage));
+
+            // the names of context-specific built-ins don't depend on the resources
+            TBuiltIns contextBuiltIns;
+            contextBuiltIns.initialize(resources, versions[v], profiles[v], (EShLanguage)stage);
+            AddSharedNames(contextBuiltIns.getCommonString());
+        }
+    }
+
+    // what IdentifyBuiltIns() declares without text
+    AddSharedNames("gl_FragData");
+
+    delete namesPoolAllocator;
+    SetThreadPoolAllocator(previousAllocator);
+}
+
 //
 // To do this on the fly, we want to leave the current state of our thread's 
 // pool allocator intact, so:
@@ -239,24 +560,30 @@ bool AddContextSpecificSymbols(const TBuiltInResource* resources, TInfoSink& inf
 //  - Switch back to the original thread's pool
 //
 // This only gets done the first time any thread needs a particular symbol table
-// (lazy evaluation).
+// (lazy evaluation).  The common tables are set up first, then each stage's
+// table separately, as needed.
 //
-void SetupBuiltinSymbolTable(int version, EProfile profile)
+void SetupCommonSymbolTables(int version, EProfile profile)
 {
-    TInfoSink infoSink;
-
-    // Make sure only one thread tries to do this at a time
-    glslang::GetGlobalLock();
-
     // See if it's already been done for this version/profile combination
     int versionIndex = MapVersionToIndex(version);
     int profileIndex = MapProfileToIndex(profile);
-    if (CommonSymbolTable[versionIndex][profileIndex][EPcGeneral]) {
-        glslang::ReleaseGlobalLock();
+    if (BuiltInTablesReady[versionIndex][profileIndex].load(std::memory_order_acquire))
+        return;
 
+    // Make sure only one thread tries to do this at a time, for this version/profile
+    std::lock_guard<std::mutex> guard(BuiltInTablesLock[versionIndex][profileIndex]);
+    if (BuiltInTablesReady[versionIndex][profileIndex].load(std::memory_order_relaxed))
+        return;
+
+    // Read them from a snapshot, if there is one with them
+    if (ReadBuiltInImage(versionIndex, profileIndex, profile)) {
+        BuiltInTablesReady[versionIndex][profileIndex].store(true, std::memory_order_release);
         return;
     }
 
+    TInfoSink infoSink;
+
     // Switch to a new pool
     TPoolAllocator& previousAllocator = GetThreadPoolAllocator();
     TPoolAllocator* builtInPoolAllocator = new TPoolAllocator();
@@ -264,17 +591,17 @@ void SetupBuiltinSymbolTable(int version, EProfile profile)
 
     // Dynamically allocate the local symbol tables so we can control when they are deallocated WRT when the pool is popped.
     TSymbolTable* commonTable[EPcCount];
-    TSymbolTable* stageTables[EShLangCount];
     for (int precClass = 0; precClass < EPcCount; ++precClass)
         commonTable[precClass] = new TSymbolTable;
-    for (int stage = 0; stage < EShLangCount; ++stage)
-        stageTables[stage] = new TSymbolTable;
 
     // Generate the local symbol tables using the new pool
-    InitializeSymbolTables(infoSink, commonTable, stageTables, version, profile);
+    TBuiltIns builtIns;
+    builtIns.initialize(version, profile);
+    InitializeCommonSymbolTables(builtIns, infoSink, commonTable, version, profile);
 
     // Switch to the process-global pool
-    SetThreadPoolAllocator(*PerProcessGPA);
+    PerProcessGPA[versionIndex][profileIndex] = new TPoolAllocator();
+    SetThreadPoolAllocator(*PerProcessGPA[versionIndex][profileIndex]);
 
     // Copy the local symbol tables from the new pool to the global tables using the process-global pool
     for (int precClass = 0; precClass < EPcCount; ++precClass) {
@@ -284,25 +611,68 @@ void SetupBuiltinSymbolTable(int version, EProfile profile)
             CommonSymbolTable[versionIndex][profileIndex][precClass]->readOnly();
         }
     }
-    for (int stage = 0; stage < EShLangCount; ++stage) {
-        if (! stageTables[stage]->isEmpty()) {
-            SharedSymbolTables[versionIndex][profileIndex][stage] = new TSymbolTable;
-            SharedSymbolTables[versionIndex][profileIndex][stage]->adoptLevels(*CommonSymbolTable[versionIndex][profileIndex][CommonIndex(profile, (EShLanguage)stage)]);
-            SharedSymbolTables[versionIndex][profileIndex][stage]->copyTable(*stageTables[stage]);
-            SharedSymbolTables[versionIndex][profileIndex][stage]->readOnly();
-        }    
-    }
 
     // Clean up the local tables before deleting the pool they used.
     for (int precClass = 0; precClass < EPcCount; ++precClass)
         delete commonTable[precClass];
-    for (int stage = 0; stage < EShLangCount; ++stage)
-        delete stageTables[stage];
 
     delete builtInPoolAllocator;
     SetThreadPoolAllocator(previousAllocator);
 
-    glslang::ReleaseGlobalLock();
+    BuiltInTablesReady[versionIndex][profileIndex].store(true, std::memory_order_release);
+}
+
+//
+// Set up a stage's shared table, as above, along with the common tables it
+// adopts, if not done yet.
+//
+void SetupBuiltinSymbolTable(int version, EProfile profile, EShLanguage language)
+{
+    int versionIndex = MapVersionToIndex(version);
+    int profileIndex = MapProfileToIndex(profile);
+    if (BuiltInStageReady[versionIndex][profileIndex][language].load(std::memory_order_acquire))
+        return;
+
+    SetupCommonSymbolTables(version, profile);
+
+    // Make sure only one thread tries to do this at a time, for this version/profile/stage
+    std::lock_guard<std::mutex> guard(BuiltInStageLock[versionIndex][profileIndex][language]);
+    if (BuiltInStageReady[versionIndex][profileIndex][language].load(std::memory_order_acquire))
+        return;
+
+    if (HasStageBuiltIns(version, profile, language)) {
+        TInfoSink infoSink;
+
+        // Switch to a new pool
+        TPoolAllocator& previousAllocator = GetThreadPoolAllocator();
+        TPoolAllocator* builtInPoolAllocator = new TPoolAllocator();
+        SetThreadPoolAllocator(*builtInPoolAllocator);
+
+        // Generate the local symbol table using the new pool, adopting the shared
+        // common table, which identifying the stage's built-ins leaves alone, as
+        // it's read only (and was already identified for every stage).
+        TSymbolTable& sharedCommonTable = *CommonSymbolTable[versionIndex][profileIndex][CommonIndex(profile, language)];
+        TSymbolTable* stageTable = new TSymbolTable;
+        TBuiltIns builtIns;
+        builtIns.initialize(version, profile);
+        InitializeStageSymbolTable(builtIns, version, profile, language, infoSink, sharedCommonTable, *stageTable);
+
+        // Switch to the process-global pool, and copy the local stage table to it, adopting the shared common table
+        PerProcessStageGPA[versionIndex][profileIndex][language] = new TPoolAllocator();
+        SetThreadPoolAllocator(*PerProcessStageGPA[versionIndex][profileIndex][language]);
+        SharedSymbolTables[versionIndex][profileIndex][language] = new TSymbolTable;
+        SharedSymbolTables[versionIndex][profileIndex][language]->adoptLevels(sharedCommonTable);
+        SharedSymbolTables[versionIndex][profileIndex][language]->copyTable(*stageTable);
+        SharedSymbolTables[versionIndex][profileIndex][language]->readOnly();
+
+        // Clean up the local table before deleting the pool it used.
+        delete stageTable;
+
+        delete builtInPoolAllocator;
+        SetThreadPoolAllocator(previousAllocator);
+    }
+
+    BuiltInStageReady[versionIndex][profileIndex][language].store(true, std::memory_order_release);
 }
 
 bool DeduceVersionProfile(TInfoSink& infoSink, EShLanguage stage, bool versionNotFirst, int defaultVersion, int& version, EProfile& profile)
@@ -462,7 +832,8 @@ bool ProcessDeferred(
     EShMessages messages,       // warnings/errors/AST; things to print out
     TIntermediate& intermediate, // returned tree, etc.
     ProcessingContext& processingContext,
-    bool requireNonempty
+    bool requireNonempty,
+    TShader::Includer* includer  // resolves #include; null if not allowed
     )
 {
     if (! InitThread())
@@ -533,7 +904,7 @@ bool ProcessDeferred(
 
     intermediate.setVersion(version);
     intermediate.setProfile(profile);
-    SetupBuiltinSymbolTable(version, profile);
+    SetupBuiltinSymbolTable(version, profile, compiler->getLanguage());
     
     TSymbolTable* cachedTable = SharedSymbolTables[MapVersionToIndex(version)]
                                                   [MapProfileToIndex(profile)]
@@ -546,8 +917,15 @@ bool ProcessDeferred(
         symbolTable.adoptLevels(*cachedTable);
     
     // Add built-in symbols that are potentially context dependent;
-    // they get popped again further down.
-    AddContextSpecificSymbols(resources, compiler->infoSink, symbolTable, version, profile, compiler->getLanguage());
+    // they get popped again further down.  They are copied, rather than
+    // adopted, as parsing edits them (e.g., implicit array sizes).
+    TSymbolTable* contextTable = 0;
+    if (cachedTable)
+        contextTable = GetContextSymbolTable(*resources, compiler->infoSink, version, profile, compiler->getLanguage(), *cachedTable);
+    if (contextTable)
+        symbolTable.copyTable(*contextTable);
+    else
+        AddContextSpecificSymbols(resources, compiler->infoSink, symbolTable, version, profile, compiler->getLanguage());
     
     //
     // Now we can process the full shader under proper symbols and rules.
@@ -555,10 +933,13 @@ bool ProcessDeferred(
 
     TParseContext parseContext(symbolTable, intermediate, false, version, profile, compiler->getLanguage(), compiler->infoSink, forwardCompatible, messages);
     glslang::TScanContext scanContext(parseContext);
-    TPpContext ppContext(parseContext);
+    TPpContext ppContext(parseContext, includer);
     parseContext.setScanContext(&scanContext);
     parseContext.setPpContext(&ppContext);
     parseContext.setLimits(*resources);
+
+    // the shader's own levels are keyed by this compile's atoms
+    symbolTable.setAtoms(&ppContext);
     if (! goodVersion)
         parseContext.addError();
     if (warnVersionNotFirst) {
@@ -733,14 +1114,18 @@ struct DoPreprocessing {
 
         int lastToken = EOF; // lastToken records the last token processed.
         while (const char* tok = ppContext.tokenize(&token)) {
+            // Tokens from an #include'd file stay on the line of the
+            // outermost #include, keeping the output's lines those of the
+            // shader's strings.
+            const TSourceLoc& loc = token.loc.name ? ppContext.getIncludeDirectiveLoc() : token.loc;
             bool isNewString = lineSync.syncToMostRecentString();
-            bool isNewLine = lineSync.syncToLine(token.loc.line);
+            bool isNewLine = lineSync.syncToLine(loc.line);
 
             if (isNewLine) {
                 // Don't emit whitespace onto empty lines.
                 // Copy any whitespace characters at the start of a line
                 // from the input to the output.
-                outputStream << std::string(token.loc.column - 1, ' ');
+                outputStream << std::string(loc.column - 1, ' ');
             }
 
             // Output a space in between tokens, but not at the start of a line,
@@ -818,12 +1203,13 @@ bool PreprocessDeferred(
     bool forwardCompatible,     // give errors for use of deprecated features
     EShMessages messages,       // warnings/errors/AST; things to print out
     TIntermediate& intermediate, // returned tree, etc.
-    std::string* outputString)
+    std::string* outputString,
+    TShader::Includer* includer)
 {
     DoPreprocessing parser(outputString);
     return ProcessDeferred(compiler, shaderStrings, numStrings, inputLengths,
                            preamble, optLevel, resources, defaultVersion, defaultProfile, forceDefaultVersionAndProfile,
-                           forwardCompatible, messages, intermediate, parser, false);
+                           forwardCompatible, messages, intermediate, parser, false, includer);
 }
 
 
@@ -851,12 +1237,13 @@ bool CompileDeferred(
     bool forceDefaultVersionAndProfile,
     bool forwardCompatible,     // give errors for use of deprecated features
     EShMessages messages,       // warnings/errors/AST; things to print out
-    TIntermediate& intermediate) // returned tree, etc.
+    TIntermediate& intermediate, // returned tree, etc.
+    TShader::Includer* includer = nullptr)
 {
     DoFullParse parser;
     return ProcessDeferred(compiler, shaderStrings, numStrings, inputLengths,
                            preamble, optLevel, resources, defaultVersion, defaultProfile, forceDefaultVersionAndProfile,
-                           forwardCompatible, messages, intermediate, parser, true);
+                           forwardCompatible, messages, intermediate, parser, true, includer);
 }
 
 } // end anonymous namespace for local functions
@@ -872,10 +1259,20 @@ int ShInitialize()
     if (! InitProcess())
         return 0;
 
-    if (! PerProcessGPA)
-        PerProcessGPA = new TPoolAllocator();
-
+    glslang::TPpContext::InitSharedAtomTable();
+    glslang::TPpContext::InitIncludeCache();
     glslang::TScanContext::fillInKeywordMap();
+    glslang::TParseContext::fillInExtensionMap();
+
+    // if the build's snapshot can't be used, the built-ins just get parsed
+    if (BuiltInImage == 0 && UseGeneratedBuiltInImage && GeneratedBuiltInImageSize > 0)
+        glslang::LoadBuiltins(GeneratedBuiltInImage, GeneratedBuiltInImageSize);
+
+    // the atom table is read only after this
+    if (! BuiltInNamesAdded) {
+        AddBuiltInNames();
+        BuiltInNamesAdded = true;
+    }
 
     return 1;
 }
@@ -944,6 +1341,19 @@ int __fastcall ShFinalize()
         }
     }
 
+    for (int version = 0; version < VersionCount; ++version) {
+        for (int p = 0; p < ProfileCount; ++p) {
+            for (int lang = 0; lang < EShLangCount; ++lang) {
+                TContextSymbolTableMap& tables = ContextSymbolTables[version][p][lang];
+                for (TContextSymbolTableMap::iterator it = tables.begin(); it != tables.end(); ++it) {
+                    delete it->second.table;
+                    delete it->second.pool;
+                }
+                tables.clear();
+            }
+        }
+    }
+
     for (int version = 0; version < VersionCount; ++version) {
         for (int p = 0; p < ProfileCount; ++p) {
             for (int pc = 0; pc < EPcCount; ++pc) {
@@ -953,13 +1363,31 @@ int __fastcall ShFinalize()
         }
     }
 
-    if (PerProcessGPA) {
-        PerProcessGPA->popAll();
-        delete PerProcessGPA;
-        PerProcessGPA = 0;
+    for (int version = 0; version < VersionCount; ++version) {
+        for (int p = 0; p < ProfileCount; ++p) {
+            if (PerProcessGPA[version][p]) {
+                PerProcessGPA[version][p]->popAll();
+                delete PerProcessGPA[version][p];
+                PerProcessGPA[version][p] = 0;
+            }
+            BuiltInTablesReady[version][p] = false;
+            for (int lang = 0; lang < EShLangCount; ++lang) {
+                if (PerProcessStageGPA[version][p][lang]) {
+                    PerProcessStageGPA[version][p][lang]->popAll();
+                    delete PerProcessStageGPA[version][p][lang];
+                    PerProcessStageGPA[version][p][lang] = 0;
+                }
+                BuiltInStageReady[version][p][lang] = false;
+            }
+        }
     }
 
+    UnloadBuiltInImage();
+
+    glslang::TParseContext::deleteExtensionMap();
     glslang::TScanContext::deleteKeywordMap();
+    glslang::TPpContext::DeleteIncludeCache();
+    glslang::TPpContext::DeleteSharedAtomTable();
 
     return 1;
 }
@@ -1250,6 +1678,274 @@ void FinalizeProcess()
     ShFinalize();
 }
 
+namespace {
+
+// The versions/profiles/stages for WarmBuiltins() to set up, claimed by its threads in turn.
+struct TWarmJob {
+    std::vector<int> versions;
+    std::vector<EProfile> profiles;
+    std::vector<EShLanguage> stages;
+    std::atomic<int> next;
+};
+
+void RunWarmJob(TWarmJob& job)
+{
+    for (int v = job.next++; v < (int)job.versions.size(); v = job.next++)
+        SetupBuiltinSymbolTable(job.versions[v], job.profiles[v], job.stages[v]);
+}
+
+//
+// Take each given version/profile to what a compile would end up setting up,
+// returning false if any is not a supported combination (leaving it out).
+//
+bool DeduceBuiltInVersions(const int* versions, const EProfile* profiles, int count,
+                           std::vector<int>& deducedVersions, std::vector<EProfile>& deducedProfiles)
+{
+    bool success = true;
+    for (int v = 0; v < count; ++v) {
+        int version = versions[v];
+        EProfile profile = profiles[v];
+        TInfoSink infoSink;
+        if (! DeduceVersionProfile(infoSink, EShLangVertex, false, versions[v], version, profile) ||
+            (MapVersionToIndex(version) == 0 && version != 100)) {
+            success = false;
+            continue;
+        }
+        deducedVersions.push_back(version);
+        deducedProfiles.push_back(profile);
+    }
+
+    return success;
+}
+
+unsigned int
+#ifdef _WIN32
+    __stdcall
+#endif
+WarmJobThread(void* args)
+{
+    if (! InitThread())
+        return 0;
+
+    RunWarmJob(*static_cast<TWarmJob*>(args));
+    DetachThread();
+
+    return 1;
+}
+
+} // end anonymous namespace
+
+//
+// For TLazyFunctions: parse some built-in function prototypes on their own.
+//
+bool ParseBuiltInFunctions(const TString& prototypes, int version, EProfile profile, EShLanguage language, TSymbolTable& symbolTable)
+{
+    TInfoSink infoSink;
+
+    return InitializeSymbolTable(prototypes, version, profile, language, infoSink, symbolTable);
+}
+
+//
+// Set up the built-in symbol tables for each stage of each given version/profile,
+// on up to 'numThreads' threads including this one.  Different versions/profiles,
+// and the stages of one once its common tables are done, build independently,
+// see SetupBuiltinSymbolTable(), each parsing into its own pool.
+//
+bool WarmBuiltins(const int* versions, const EProfile* profiles, int count, int numThreads)
+{
+    std::vector<int> deducedVersions;
+    std::vector<EProfile> deducedProfiles;
+    bool success = DeduceBuiltInVersions(versions, profiles, count, deducedVersions, deducedProfiles);
+
+    // stage by stage, so the first stages of all versions/profiles are taken first
+    TWarmJob job;
+    job.next = 0;
+    for (int stage = 0; stage < EShLangCount; ++stage) {
+        for (int v = 0; v < (int)deducedVersions.size(); ++v) {
+            if (HasStageBuiltIns(deducedVersions[v], deducedProfiles[v], (EShLanguage)stage)) {
+                job.versions.push_back(deducedVersions[v]);
+                job.profiles.push_back(deducedProfiles[v]);
+                job.stages.push_back((EShLanguage)stage);
+            }
+        }
+    }
+
+    std::vector<void*> threads;
+    for (int t = 1; t < numThreads && t < (int)job.versions.size(); ++t) {
+        void* thread = OS_CreateThread(&WarmJobThread, &job);
+        if (thread)
+            threads.push_back(thread);
+    }
+    RunWarmJob(job);
+    if (threads.size() > 0)
+        OS_WaitForAllThreads(&threads[0], (int)threads.size());
+
+    return success;
+}
+
+//
+// The snapshot is a header, the stamp of the build, a directory of the
+// versions/profiles present, and the strings of the atom table, which hold
+// the names of the built-ins, followed by the tables of each version/profile,
+// written by WriteBuiltInImage().
+//
+bool SaveBuiltins(const char* fileName, const int* versions, const EProfile* profiles, int count)
+{
+    std::vector<int> deducedVersions;
+    std::vector<EProfile> deducedProfiles;
+    bool success = DeduceBuiltInVersions(versions, profiles, count, deducedVersions, deducedProfiles);
+
+    std::vector<std::string> images;
+    std::vector<int> entryVersions;
+    std::vector<int> entryProfiles;
+    bool saved[VersionCount][ProfileCount] = {};
+    for (int v = 0; v < (int)deducedVersions.size(); ++v) {
+        int versionIndex = MapVersionToIndex(deducedVersions[v]);
+        int profileIndex = MapProfileToIndex(deducedProfiles[v]);
+        if (saved[versionIndex][profileIndex])
+            continue;
+        saved[versionIndex][profileIndex] = true;
+
+        for (int stage = 0; stage < EShLangCount; ++stage)
+            SetupBuiltinSymbolTable(deducedVersions[v], deducedProfiles[v], (EShLanguage)stage);
+        images.push_back(std::string());
+        WriteBuiltInImage(versionIndex, profileIndex, images.back());
+        entryVersions.push_back(deducedVersions[v]);
+        entryProfiles.push_back(deducedProfiles[v]);
+    }
+
+    std::string header;
+    TSymbolTableWriter writer(header);
+    std::string stamp = BuiltInImageStamp();
+    writer.writeInt(BuiltInImageMagic);
+    writer.writeInt(BuiltInImageFormatVersion);
+    writer.writeInt((int)stamp.size());
+    writer.writeBytes(stamp.c_str(), stamp.size());
+    std::string names;
+    TSymbolTableWriter namesWriter(names);
+    int numNames = 0;
+    for (int atom = 1; atom < TPpContext::GetSharedAtomCount(); ++atom) {
+        if (TPpContext::GetSharedAtomString(atom))
+            ++numNames;
+    }
+    namesWriter.writeInt(numNames);
+    for (int atom = 1; atom < TPpContext::GetSharedAtomCount(); ++atom) {
+        const char* name = TPpContext::GetSharedAtomString(atom);
+        if (name) {
+            namesWriter.writeInt((int)strlen(name));
+            namesWriter.writeBytes(name, strlen(name));
+        }
+    }
+
+    writer.writeInt((int)images.size());
+    size_t offset = header.size() + images.size() * 4 * sizeof(int) + names.size();
+    for (int e = 0; e < (int)images.size(); ++e) {
+        writer.writeInt(entryVersions[e]);
+        writer.writeInt(entryProfiles[e]);
+        writer.writeInt((int)offset);
+        writer.writeInt((int)images[e].size());
+        offset += images[e].size();
+    }
+    header.append(names);
+
+    FILE* file = fopen(fileName, "wb");
+    if (file == 0)
+        return false;
+    bool written = fwrite(header.data(), 1, header.size(), file) == header.size();
+    for (int e = 0; e < (int)images.size(); ++e)
+        written = written && fwrite(images[e].data(), 1, images[e].size(), file) == images[e].size();
+    if (fclose(file) != 0)
+        written = false;
+
+    return success && written;
+}
+
+bool LoadBuiltins(const char* fileName)
+{
+    UnloadBuiltInImage();
+
+    const char* image;
+    size_t size;
+    void* mapping = OS_MapFile(fileName, image, size);
+    if (mapping == 0)
+        return false;
+
+    bool success = LoadBuiltins(image, size);
+    if (success)
+        BuiltInImageMapping = mapping;
+    else
+        OS_UnmapFile(mapping);
+
+    return success;
+}
+
+bool LoadBuiltins(const void* data, size_t size)
+{
+    UnloadBuiltInImage();
+
+    const char* image = static_cast<const char*>(data);
+    BuiltInImage = image;
+
+    TSymbolTableReader reader(image, size);
+    bool success = reader.readInt() == BuiltInImageMagic &&
+                   reader.readInt() == BuiltInImageFormatVersion;
+
+    std::string stamp = BuiltInImageStamp();
+    if (success && reader.readInt() == (int)stamp.size()) {
+        std::vector<char> imageStamp(stamp.size());
+        success = stamp.empty() || (reader.readBytes(&imageStamp[0], imageStamp.size()) &&
+                                    stamp.compare(0, stamp.size(), &imageStamp[0], imageStamp.size()) == 0);
+    } else
+        success = false;
+
+    int numEntries = success ? reader.readInt() : 0;
+    for (int e = 0; e < numEntries && success; ++e) {
+        int version = reader.readInt();
+        EProfile profile = (EProfile)reader.readInt();
+        int offset = reader.readInt();
+        int entrySize = reader.readInt();
+        if (reader.failed() || (MapVersionToIndex(version) == 0 && version != 100) ||
+            offset < 0 || entrySize <= 0 || (size_t)offset > size || (size_t)entrySize > size - offset) {
+            success = false;
+            break;
+        }
+        TBuiltInImageEntry& entry = BuiltInImageEntries[MapVersionToIndex(version)][MapProfileToIndex(profile)];
+        entry.offset = offset;
+        entry.size = entrySize;
+    }
+
+    int numNames = success ? reader.readInt() : 0;
+    if (numNames < 0 || (size_t)numNames > size)
+        success = false;
+    for (int n = 0; n < numNames && success; ++n) {
+        int length = reader.readInt();
+        if (length <= 0 || (size_t)length > size) {
+            success = false;
+            break;
+        }
+        std::vector<char> name(length);
+        success = reader.readBytes(&name[0], length);
+        if (success)
+            BuiltInImageNames.push_back(std::string(&name[0], length));
+    }
+    success = success && ! reader.failed();
+
+    if (! success)
+        UnloadBuiltInImage();
+
+    // after initialization, the snapshot's names still need adding
+    if (success && BuiltInNamesAdded)
+        AddBuiltInNames();
+
+    return success;
+}
+
+void UnloadBuiltins()
+{
+    UnloadBuiltInImage();
+    UseGeneratedBuiltInImage = false;
+}
+
 class TDeferredCompiler : public TCompiler {
 public:
     TDeferredCompiler(EShLanguage s, TInfoSink& i) : TCompiler(s, i) { }
@@ -1257,7 +1953,7 @@ public:
 };
 
 TShader::TShader(EShLanguage s) 
-    : pool(0), stage(s), preamble(""), lengths(nullptr)
+    : pool(0), stage(s), preamble(""), lengths(nullptr), includer(nullptr)
 {
     infoSink = new TInfoSink;
     compiler = new TDeferredCompiler(stage, *infoSink);
@@ -1301,7 +1997,7 @@ bool TShader::parse(const TBuiltInResource* builtInResources, int defaultVersion
     if (! preamble)
         preamble = "";
 
-    return CompileDeferred(compiler, strings, numStrings, lengths, preamble, EShOptNone, builtInResources, defaultVersion, defaultProfile, forceDefaultVersionAndProfile, forwardCompatible, messages, *intermediate);
+    return CompileDeferred(compiler, strings, numStrings, lengths, preamble, EShOptNone, builtInResources, defaultVersion, defaultProfile, forceDefaultVersionAndProfile, forwardCompatible, messages, *intermediate, includer);
 }
 
 bool TShader::parse(const TBuiltInResource* builtInResources, int defaultVersion, bool forwardCompatible, EShMessages messages)
@@ -1327,7 +2023,17 @@ bool TShader::preprocess(const TBuiltInResource* builtInResources,
     return PreprocessDeferred(compiler, strings, numStrings,
                               lengths, preamble, EShOptNone, builtInResources,
                               defaultVersion, defaultProfile, forceDefaultVersionAndProfile, forwardCompatible, message,
-                              *intermediate, output_string);
+                              *intermediate, output_string, includer);
+}
+
+const std::vector<std::string>& TShader::getIncludedFiles() const
+{
+    return intermediate->getIncludedFiles();
+}
+
+int TShader::getNumIncludeDirectives() const
+{
+    return intermediate->getNumIncludeDirectives();
 }
 
 const char* TShader::getInfoLog()
@@ -1361,6 +2067,93 @@ TProgram::~TProgram()
     delete pool;
 }
 
+namespace {
+
+// What a thread needs for parsing one shader, for TProgram::parseShaders().
+struct TParseJob {
+    TShader* shader;
+    const TBuiltInResource* resources;
+    int defaultVersion;
+    EProfile defaultProfile;
+    bool forceDefaultVersionAndProfile;
+    bool forwardCompatible;
+    EShMessages messages;
+    bool success;
+};
+
+void RunParseJob(TParseJob& job)
+{
+    job.success = job.shader->parse(job.resources, job.defaultVersion, job.defaultProfile, job.forceDefaultVersionAndProfile,
+                                    job.forwardCompatible, job.messages);
+}
+
+unsigned int
+#ifdef _WIN32
+    __stdcall
+#endif
+ParseJobThread(void* args)
+{
+    TParseJob& job = *static_cast<TParseJob*>(args);
+    if (! InitThread()) {
+        job.success = false;
+        return 0;
+    }
+
+    // parse() leaves the shader's pool as the thread's current pool;
+    // the thread's own pool must be current again before detaching.
+    TPoolAllocator& threadAllocator = GetThreadPoolAllocator();
+    RunParseJob(job);
+    SetThreadPoolAllocator(threadAllocator);
+    DetachThread();
+
+    return job.success ? 1 : 0;
+}
+
+} // end anonymous namespace
+
+//
+// Parse every added shader, each on its own thread.  Each shader parses into
+// its own pool, exactly as TShader::parse() does, so the only shared state is
+// the process-wide built-in symbol tables.
+//
+// Return true if all shaders parsed successfully.
+//
+bool TProgram::parseShaders(const TBuiltInResource* builtInResources, int defaultVersion, EProfile defaultProfile, bool forceDefaultVersionAndProfile,
+                            bool forwardCompatible, EShMessages messages)
+{
+    std::vector<TParseJob> jobs;
+    for (int s = 0; s < EShLangCount; ++s) {
+        std::list<TShader*>::const_iterator it;
+        for (it = stages[s].begin(); it != stages[s].end(); ++it) {
+            TParseJob job = { *it, builtInResources, defaultVersion, defaultProfile, forceDefaultVersionAndProfile,
+                              forwardCompatible, messages, false };
+            jobs.push_back(job);
+        }
+    }
+
+    // The last job, or any that can't get a thread, is done on this thread.
+    std::vector<void*> threads;
+    for (size_t j = 0; j + 1 < jobs.size(); ++j) {
+        void* thread = OS_CreateThread(&ParseJobThread, &jobs[j]);
+        if (thread)
+            threads.push_back(thread);
+        else
+            RunParseJob(jobs[j]);
+    }
+    if (jobs.size() > 0)
+        RunParseJob(jobs.back());
+    if (threads.size() > 0)
+        OS_WaitForAllThreads(&threads[0], (int)threads.size());
+
+    bool success = true;
+    for (size_t j = 0; j < jobs.size(); ++j) {
+        if (! jobs[j].success)
+            success = false;
+    }
+
+    return success;
+}
+
 //
 // Merge the compilation units within each stage into a single TIntermediate.
 // All starting compilation units need to be the result of calling TShader::parse().
@@ -1468,5 +2261,6 @@ int TProgram::getUniformBufferOffset(int index)      { return reflection->getUni
 int TProgram::getUniformArraySize(int index)         { return reflection->getUniform(index).size; }
 
 void TProgram::dumpReflection()                      { reflection->dump(); }
+void TProgram::dumpReflection(std::string& text)     { reflection->dump(text); }
 
 } // end namespace glslang
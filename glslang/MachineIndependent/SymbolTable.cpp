@@ -40,6 +40,8 @@
 //
 
 #include "SymbolTable.h"
+#include "Initialize.h"
+#include "preprocessor/PpContext.h"
 
 namespace glslang {
 
@@ -149,6 +151,11 @@ void TSymbolTableLevel::dump(TInfoSink &infoSink) const
     tLevel::const_iterator it;
     for (it = level.begin(); it != level.end(); ++it)
         (*it).second->dump(infoSink);
+    tFunctionIndex::const_iterator overloads;
+    for (overloads = functions.begin(); overloads != functions.end(); ++overloads) {
+        for (TFunctionList::const_iterator f = overloads->second.begin(); f != overloads->second.end(); ++f)
+            (*f)->dump(infoSink);
+    }
 }
 
 void TSymbolTable::dump(TInfoSink &infoSink) const
@@ -175,44 +182,283 @@ TSymbolTableLevel::~TSymbolTableLevel()
 {
     for (tLevel::iterator it = level.begin(); it != level.end(); ++it)
         delete (*it).second;
+    for (tFunctionIndex::iterator overloads = functions.begin(); overloads != functions.end(); ++overloads) {
+        for (TFunctionList::iterator f = overloads->second.begin(); f != overloads->second.end(); ++f)
+            delete *f;
+    }
 
     delete [] defaultPrecision;
+    delete lazyFunctions;
+    delete overloadCache;
+}
+
+//
+// A compile's own level keys a name by the compile's atom for it, adding one
+// if needed.  A shared level keys it by its process-wide atom, or if it has
+// none, which should be true of none of the built-ins' names, by a number
+// below zero that's the level's own.
+//
+int TSymbolTableLevel::getKey(const TString& name)
+{
+    int atom = atoms ? atoms->LookUpAddString(name.c_str()) : TPpContext::LookUpSharedAtom(name.c_str());
+    if (atom != 0)
+        return atom;
+
+    int& key = unatomized[name];
+    if (key == 0)
+        key = -(int)unatomized.size();
+
+    return key;
+}
+
+int TSymbolTableLevel::findKey(const TString& name, int atom) const
+{
+    if (atoms != 0 || TPpContext::IsSharedAtom(atom))
+        return atom;
+
+    if (unatomized.empty())
+        return 0;
+
+    tUnatomized::const_iterator it = unatomized.find(TString(name, 0, name.find_first_of('(')));
+
+    return it == unatomized.end() ? 0 : it->second;
+}
+
+int TSymbolTable::findAtom(const TString& name) const
+{
+    size_t parenAt = name.find_first_of('(');
+    if (parenAt != name.npos)
+        return findAtom(TString(name, 0, parenAt));
+
+    return atoms ? atoms->LookUpString(name.c_str()) : TPpContext::LookUpSharedAtom(name.c_str());
+}
+
+//
+// Index each line of 'prototypes' by the name of the function it declares.
+//
+void TSymbolTableLevel::addLazyFunctions(const TString& prototypes, int version, EProfile profile, EShLanguage language)
+{
+    if (lazyFunctions == 0)
+        lazyFunctions = new TLazyFunctions(version, profile, language);
+
+    size_t start = 0;
+    while (start < prototypes.size()) {
+        size_t end = prototypes.find_first_of('\n', start);
+        end = end == prototypes.npos ? prototypes.size() : end + 1;
+        size_t parenAt = prototypes.find_first_of('(', start);
+        if (parenAt < end) {
+            size_t nameAt = parenAt;
+            while (nameAt > start && (isalnum(prototypes[nameAt - 1]) || prototypes[nameAt - 1] == '_'))
+                --nameAt;
+            TString name(prototypes, nameAt, parenAt - nameAt);
+            lazyFunctions->addPrototype(getKey(name), name, prototypes.c_str() + start, end - start);
+        }
+        start = end;
+    }
+}
+
+//
+// Lazily parsed functions have their own pool.
+//
+TLazyFunctions::~TLazyFunctions()
+{
+    delete pool;
+}
+
+// The name is copied anew, so that it's in the current pool, not the one of the string passed in.
+TLazyFunctions::TEntry& TLazyFunctions::getEntry(int key, const TString& name)
+{
+    TEntry*& entry = entries[key];
+    if (entry == 0) {
+        entry = new TEntry;
+        entry->name = name.c_str();
+    }
+
+    return *entry;
+}
+
+void TLazyFunctions::addPrototype(int key, const TString& name, const char* prototype, size_t length)
+{
+    assert(writable);
+
+    getEntry(key, name).prototypes.append(prototype, length);
+}
+
+//
+// Get all the functions of the given non-function-style name, parsing them
+// if this is the first time they are asked for.  Returns 0 if there are none.
+//
+const TFunctionList* TLazyFunctions::findFunctions(int key) const
+{
+    tEntries::const_iterator it = entries.find(key);
+    if (it == entries.end())
+        return 0;
+
+    TEntry& entry = *it->second;
+    TFunctionList* functions = entry.functions.load(std::memory_order_acquire);
+    if (functions)
+        return functions;
+
+    std::lock_guard<std::mutex> guard(lock);
+    functions = entry.functions.load(std::memory_order_relaxed);
+    if (functions == 0) {
+        functions = parse(entry);
+        entry.functions.store(functions, std::memory_order_release);
+    }
+
+    return functions;
+}
+
+TFunction* TLazyFunctions::find(int key, const TString& mangledName) const
+{
+    const TFunctionList* functions = findFunctions(key);
+    if (functions == 0)
+        return 0;
+
+    for (TFunctionList::const_iterator it = functions->begin(); it != functions->end(); ++it) {
+        if ((*it)->getMangledName() == mangledName)
+            return *it;
+    }
+
+    return 0;
+}
+
+//
+// Parse an entry's prototypes in a pool of their own, as is done for all
+// built-ins, and keep read-only copies of the resulting functions in this
+// set's pool.  The caller holds the lock.
+//
+TFunctionList* TLazyFunctions::parse(const TEntry& entry) const
+{
+    TPoolAllocator& previousAllocator = GetThreadPoolAllocator();
+    TPoolAllocator* parsePoolAllocator = new TPoolAllocator();
+    SetThreadPoolAllocator(*parsePoolAllocator);
+
+    TSymbolTable* symbolTable = new TSymbolTable;
+    ParseBuiltInFunctions(entry.prototypes, version, profile, language, *symbolTable);
+    TFunctionList parsed;
+    if (! symbolTable->isEmpty())
+        symbolTable->table[0]->findFunctionNameList(entry.name, symbolTable->findAtom(entry.name), parsed);
+
+    if (pool == 0)
+        pool = new TPoolAllocator();
+    SetThreadPoolAllocator(*pool);
+    TFunctionList* functions = new TFunctionList;
+    for (TFunctionList::const_iterator it = parsed.begin(); it != parsed.end(); ++it) {
+        TFunction* function = (*it)->clone();
+        if (entry.op != EOpNull)
+            function->relateToOperator(entry.op);
+        if (entry.numExtensions > 0)
+            function->setExtensions(entry.numExtensions, entry.extensions);
+        function->makeReadOnly();
+        functions->push_back(function);
+    }
+
+    delete symbolTable;
+    delete parsePoolAllocator;
+    SetThreadPoolAllocator(previousAllocator);
+
+    return functions;
+}
+
+//
+// These record what's asked for names not parsed yet, to apply when they are.
+//
+void TLazyFunctions::relateToOperator(int key, TOperator op)
+{
+    if (! writable)
+        return;
+
+    tEntries::const_iterator it = entries.find(key);
+    if (it != entries.end())
+        it->second->op = op;
+}
+
+void TLazyFunctions::setFunctionExtensions(int key, int num, const TExtension extensions[])
+{
+    if (! writable)
+        return;
+
+    tEntries::const_iterator it = entries.find(key);
+    if (it != entries.end()) {
+        TEntry& entry = *it->second;
+        entry.numExtensions = num;
+        entry.extensions = NewPoolObject(extensions[0], num);
+        for (int e = 0; e < num; ++e)
+            entry.extensions[e] = extensions[e];
+    }
+}
+
+//
+// Copy the prototypes and what's recorded for them.  Functions parsed from
+// prototypes are not copied; the copy parses again, as needed, into its own
+// pool.  Functions that came without prototypes, from a snapshot, are copied
+// into the current pool.
+//
+TLazyFunctions* TLazyFunctions::clone() const
+{
+    TLazyFunctions* lazyFunctions = new TLazyFunctions(version, profile, language);
+    for (tEntries::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+        TEntry& entry = lazyFunctions->getEntry(it->first, it->second->name);
+        entry.prototypes = it->second->prototypes;
+        entry.op = it->second->op;
+        const TFunctionList* functions = it->second->functions.load(std::memory_order_acquire);
+        if (entry.prototypes.empty() && functions) {
+            TFunctionList* copies = new TFunctionList;
+            for (TFunctionList::const_iterator f = functions->begin(); f != functions->end(); ++f) {
+                TFunction* function = (*f)->clone();
+                function->makeReadOnly();
+                copies->push_back(function);
+            }
+            entry.functions.store(copies, std::memory_order_relaxed);
+        }
+        if (it->second->numExtensions > 0) {
+            entry.numExtensions = it->second->numExtensions;
+            entry.extensions = NewPoolObject(it->second->extensions[0], entry.numExtensions);
+            for (int e = 0; e < entry.numExtensions; ++e)
+                entry.extensions[e] = it->second->extensions[e];
+        }
+    }
+
+    return lazyFunctions;
 }
 
 //
 // Change all function entries in the table with the non-mangled name
 // to be related to the provided built-in operation.
 //
+// Read-only (shared) entries are skipped; they were related when they were set up.
+//
 void TSymbolTableLevel::relateToOperator(const char* name, TOperator op)
 {
-    tLevel::const_iterator candidate = level.lower_bound(name);
-    while (candidate != level.end()) {
-        const TString& candidateName = (*candidate).first;
-        TString::size_type parenAt = candidateName.find_first_of('(');
-        if (parenAt != candidateName.npos && candidateName.compare(0, parenAt, name) == 0) {
-            TFunction* function = (*candidate).second->getAsFunction();
-            function->relateToOperator(op);
-        } else
-            break;
-        ++candidate;
+    int key = findKey(name, atoms ? atoms->LookUpString(name) : TPpContext::LookUpSharedAtom(name));
+    tFunctionIndex::const_iterator overloads = functions.find(key);
+    if (overloads != functions.end()) {
+        for (TFunctionList::const_iterator it = overloads->second.begin(); it != overloads->second.end(); ++it) {
+            if (! (*it)->isReadOnly())
+                (*it)->relateToOperator(op);
+        }
     }
+
+    if (lazyFunctions)
+        lazyFunctions->relateToOperator(key, op);
 }
 
 // Make all function overloads of the given name require an extension(s).
 // Should only be used for a version/profile that actually needs the extension(s).
-void TSymbolTableLevel::setFunctionExtensions(const char* name, int num, const char* const extensions[])
-{
-    tLevel::const_iterator candidate = level.lower_bound(name);
-    while (candidate != level.end()) {
-        const TString& candidateName = (*candidate).first;
-        TString::size_type parenAt = candidateName.find_first_of('(');
-        if (parenAt != candidateName.npos && candidateName.compare(0, parenAt, name) == 0) {
-            TSymbol* symbol = candidate->second;
-            symbol->setExtensions(num, extensions);
-        } else
-            break;
-        ++candidate;
+void TSymbolTableLevel::setFunctionExtensions(const char* name, int num, const TExtension extensions[])
+{
+    int key = findKey(name, atoms ? atoms->LookUpString(name) : TPpContext::LookUpSharedAtom(name));
+    tFunctionIndex::const_iterator overloads = functions.find(key);
+    if (overloads != functions.end()) {
+        for (TFunctionList::const_iterator it = overloads->second.begin(); it != overloads->second.end(); ++it) {
+            if (! (*it)->isReadOnly())
+                (*it)->setExtensions(num, extensions);
+        }
     }
+
+    if (lazyFunctions)
+        lazyFunctions->setFunctionExtensions(key, num, extensions);
 }
 
 //
@@ -222,6 +468,49 @@ void TSymbolTableLevel::readOnly()
 {
     for (tLevel::iterator it = level.begin(); it != level.end(); ++it)
         (*it).second->makeReadOnly();
+    for (tFunctionIndex::iterator overloads = functions.begin(); overloads != functions.end(); ++overloads) {
+        for (TFunctionList::iterator f = overloads->second.begin(); f != overloads->second.end(); ++f)
+            (*f)->makeReadOnly();
+    }
+    if (lazyFunctions)
+        lazyFunctions->readOnly();
+    if (overloadCache == 0)
+        overloadCache = new TOverloadCache;
+}
+
+//
+// The call's mangled name doesn't distinguish multisample samplers, which
+// can still resolve differently, so mark those in the key.
+//
+void TOverloadCache::buildKey(const TFunction& call, std::string& key)
+{
+    key.assign(call.getMangledName().c_str(), call.getMangledName().size());
+    for (int i = 0; i < call.getParamCount(); ++i) {
+        if (call[i].type->getBasicType() == EbtSampler && call[i].type->getSampler().ms)
+            key += 'M';
+        else
+            key += '-';
+    }
+}
+
+const TFunction* TOverloadCache::find(const TFunction& call)
+{
+    std::string key;
+    buildKey(call, key);
+
+    std::lock_guard<std::mutex> guard(lock);
+    std::unordered_map<std::string, const TFunction*>::const_iterator it = resolved.find(key);
+
+    return it == resolved.end() ? 0 : it->second;
+}
+
+void TOverloadCache::add(const TFunction& call, const TFunction& function)
+{
+    std::string key;
+    buildKey(call, key);
+
+    std::lock_guard<std::mutex> guard(lock);
+    resolved[key] = &function;
 }
 
 //
@@ -257,6 +546,26 @@ TVariable* TVariable::clone() const
     return variable;
 }
 
+//
+// Copy a variable from a shared level for editing by the current compile.  Unlike
+// clone(), the copy keeps referring to the parts of the original that are never
+// edited, like its names and extensions, as the shared level outlives the compile.
+//
+TVariable* TVariable::editableClone() const
+{
+    TVariable *variable = new TVariable(name, type, userType);
+    variable->type.editableCopy(type);
+    variable->uniqueId = uniqueId;
+    variable->numExtensions = numExtensions;
+    variable->extensions = extensions;
+    if (! unionArray.empty()) {
+        TConstUnionArray newArray(unionArray, 0, unionArray.size());
+        variable->unionArray = newArray;
+    }
+
+    return variable;
+}
+
 TFunction::TFunction(const TFunction& copyOf) : TSymbol(copyOf)
 {	
     for (unsigned int i = 0; i < copyOf.parameters.size(); ++i) {
@@ -267,7 +576,7 @@ TFunction::TFunction(const TFunction& copyOf) : TSymbol(copyOf)
 
     numExtensions = 0;
     extensions = 0;
-    if (copyOf.extensions > 0)
+    if (copyOf.extensions != 0)
         setExtensions(copyOf.numExtensions, copyOf.extensions);
     returnType.deepCopy(copyOf.returnType);
     mangledName = copyOf.mangledName;
@@ -295,26 +604,39 @@ TAnonMember* TAnonMember::clone() const
 
 TSymbolTableLevel* TSymbolTableLevel::clone() const
 {
-    TSymbolTableLevel *symTableLevel = new TSymbolTableLevel();
+    TSymbolTableLevel *symTableLevel = new TSymbolTableLevel(atoms);
     symTableLevel->anonId = anonId;
-    std::vector<bool> containerCopied(anonId, false);
+    for (tUnatomized::const_iterator it = unatomized.begin(); it != unatomized.end(); ++it)
+        symTableLevel->unatomized[it->first.c_str()] = it->second;
+    std::vector<const TVariable*> containers(anonId, (const TVariable*)0);
     tLevel::const_iterator iter;
     for (iter = level.begin(); iter != level.end(); ++iter) {
         const TAnonMember* anon = iter->second->getAsAnonMember();
-        if (anon) {
-            // Insert all the anonymous members of this same container at once,
-            // avoid inserting the other members in the future, once this has been done,
-            // allowing them to all be part of the same new container.
-            if (! containerCopied[anon->getAnonId()]) {
-                TVariable* container = anon->getAnonContainer().clone();
-                container->changeName(NewPoolTString(""));
-                // insert the whole container
-                symTableLevel->insert(*container, false);
-                containerCopied[anon->getAnonId()] = true;
-            }
-        } else
-            symTableLevel->insert(*iter->second->clone(), false);
+        if (anon)
+            containers[anon->getAnonId()] = &anon->getAnonContainer();
+        else
+            symTableLevel->level.insert(tLevelPair(iter->first, iter->second->clone()));
+    }
+    tFunctionIndex::const_iterator overloads;
+    for (overloads = functions.begin(); overloads != functions.end(); ++overloads) {
+        TFunctionList& copies = symTableLevel->functions[overloads->first];
+        for (TFunctionList::const_iterator f = overloads->second.begin(); f != overloads->second.end(); ++f)
+            copies.push_back((*f)->clone());
+    }
+
+    // Insert all the anonymous members of each container at once, allowing
+    // them to all be part of the same new container.  This is done in the
+    // order the containers were made, as 'level' has no order.
+    for (unsigned int a = 0; a < containers.size(); ++a) {
+        if (containers[a]) {
+            TVariable* container = containers[a]->clone();
+            container->changeName(NewPoolTString(""));
+            // insert the whole container
+            symTableLevel->insert(*container, false);
+        }
     }
+    if (lazyFunctions)
+        symTableLevel->lazyFunctions = lazyFunctions->clone();
 
     return symTableLevel;
 }
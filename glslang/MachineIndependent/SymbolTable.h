@@ -68,8 +68,15 @@
 #include "../Include/intermediate.h"
 #include "../Include/InfoSink.h"
 
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 namespace glslang {
 
+class TPpContext;
+
 //
 // Symbol base class.  (Can build functions or variables out of these...)
 //
@@ -97,7 +104,7 @@ public:
     virtual TType& getWritableType() = 0;
     virtual void setUniqueId(int id) { uniqueId = id; }
     virtual int getUniqueId() const { return uniqueId; }
-    virtual void setExtensions(int num, const char* const exts[])
+    virtual void setExtensions(int num, const TExtension exts[])
     {
         assert(extensions == 0);
         assert(num > 0);
@@ -107,7 +114,7 @@ public:
             extensions[e] = exts[e];
     }
     virtual int getNumExtensions() const { return numExtensions; }
-    virtual const char** getExtensions() const { return extensions; }
+    virtual const TExtension* getExtensions() const { return extensions; }
     virtual void dump(TInfoSink &infoSink) const = 0;
 
     virtual bool isReadOnly() const { return ! writable; }
@@ -123,7 +130,7 @@ protected:
     // For tracking what extensions must be present 
     // (don't use if correct version/profile is present).
     int numExtensions;
-    const char** extensions; // an array of pointers to existing constant char strings
+    TExtension* extensions;
 
     //
     // N.B.: Non-const functions that will be generally used should assert on this,
@@ -146,6 +153,7 @@ class TVariable : public TSymbol {
 public:
     TVariable(const TString *name, const TType& t, bool uT = false ) : TSymbol(name), userType(uT) { type.shallowCopy(t); }
     virtual TVariable* clone() const;
+    TVariable* editableClone() const;
     virtual ~TVariable() { }
 
     virtual TVariable* getAsVariable() { return this; }
@@ -231,6 +239,9 @@ public:
     virtual void dump(TInfoSink &infoSink) const;
 
 protected:
+    friend class TSymbolTableWriter;
+    friend class TSymbolTableReader;
+
     explicit TFunction(const TFunction&);
     TFunction& operator=(const TFunction&);
 
@@ -284,10 +295,108 @@ protected:
     int anonId;
 };
 
+typedef TVector<TFunction*> TFunctionList;
+
+//
+// Built-in function prototypes held as text, by base name, and only parsed
+// into functions the first time a lookup needs that name.  This is for the
+// large, regular sets of texturing and imaging prototypes, of which a shader
+// uses only a few.  Names are looked up by the key the owning level gives
+// them, see TSymbolTableLevel.
+//
+// The names and text only change while the owning level is being built.
+// After that, the level can be shared across threads: each name's functions
+// are parsed at most once, under a lock, into a pool of their own, and are
+// read only.  A level read from a built-in snapshot has all its functions
+// already parsed, and no text.
+//
+class TLazyFunctions {
+public:
+    POOL_ALLOCATOR_NEW_DELETE(GetThreadPoolAllocator())
+    TLazyFunctions(int version, EProfile profile, EShLanguage language) :
+        version(version), profile(profile), language(language), writable(true), pool(0) { }
+    ~TLazyFunctions();
+
+    // Add a prototype, a line of the text of built-ins, for the function 'name'.
+    void addPrototype(int key, const TString& name, const char* prototype, size_t length);
+
+    bool hasName(int key) const { return entries.find(key) != entries.end(); }
+    const TFunctionList* findFunctions(int key) const;
+    TFunction* find(int key, const TString& mangledName) const;
+
+    void relateToOperator(int key, TOperator op);
+    void setFunctionExtensions(int key, int num, const TExtension extensions[]);
+    void readOnly() { writable = false; }
+    TLazyFunctions* clone() const;
+
+protected:
+    friend class TSymbolTableWriter;
+    friend class TSymbolTableReader;
+
+    TLazyFunctions(TLazyFunctions&);
+    TLazyFunctions& operator=(TLazyFunctions&);
+
+    struct TEntry {
+        POOL_ALLOCATOR_NEW_DELETE(GetThreadPoolAllocator())
+        TEntry() : op(EOpNull), numExtensions(0), extensions(0), functions(0) { }
+
+        TString name;
+        TString prototypes;
+        TOperator op;
+        int numExtensions;
+        TExtension* extensions;
+        std::atomic<TFunctionList*> functions;  // sorted by mangled name, once parsed
+    };
+    TEntry& getEntry(int key, const TString& name);
+    TFunctionList* parse(const TEntry&) const;
+
+    typedef TUnorderedMap<int, TEntry*> tEntries;
+    tEntries entries;
+    int version;
+    EProfile profile;
+    EShLanguage language;
+    bool writable;
+    mutable TPoolAllocator* pool;   // for the parsed functions
+    mutable std::mutex lock;        // for parsing
+};
+
+//
+// Remembers how calls resolved, through implicit conversions, against the
+// overloads of the read-only built-in levels, so later calls with the same
+// argument types skip the search.  It belongs to a shared level and is used
+// by all the compiles adopting that level, so it is not pool allocated, and
+// is locked for each lookup.
+//
+class TOverloadCache {
+public:
+    TOverloadCache() { }
+
+    const TFunction* find(const TFunction& call);
+    void add(const TFunction& call, const TFunction& function);
+
+protected:
+    TOverloadCache(TOverloadCache&);
+    TOverloadCache& operator=(TOverloadCache&);
+
+    static void buildKey(const TFunction& call, std::string& key);
+
+    std::unordered_map<std::string, const TFunction*> resolved;
+    std::mutex lock;
+};
+
+//
+// A level's symbols are keyed by the atoms of their names, see TPpContext.
+// Shared levels outlive any one compile, so are keyed by the process-wide
+// atoms, which include all the names the built-ins declare; a name that has
+// none is given a negative key of the level's own, and found by its text.
+// A compile's own levels are keyed by the atoms of its preprocessor, which
+// extend the process-wide ones.  Either way, lookups pass the atom the name
+// has in the current compile, or 0 if it has none.
+//
 class TSymbolTableLevel {
 public:
     POOL_ALLOCATOR_NEW_DELETE(GetThreadPoolAllocator())
-    TSymbolTableLevel() : defaultPrecision(0), anonId(0) { }
+    explicit TSymbolTableLevel(TPpContext* atoms = 0) : atoms(atoms), defaultPrecision(0), anonId(0), lazyFunctions(0), overloadCache(0) { }
     ~TSymbolTableLevel();
 
     bool insert(TSymbol& symbol, bool separateNameSpaces)
@@ -308,7 +417,7 @@ public:
             const TTypeList& types = *symbol.getAsVariable()->getType().getStruct();
             for (unsigned int m = 0; m < types.size(); ++m) {
                 TAnonMember* member = new TAnonMember(&types[m].type->getFieldName(), m, *symbol.getAsVariable(), anonId);
-                result = level.insert(tLevelPair(member->getMangledName(), member));
+                result = level.insert(tLevelPair(getKey(member->getName()), member));
                 if (! result.second)
                     isOkay = false;
             }
@@ -318,90 +427,111 @@ public:
             return isOkay;
         } else {
             // Check for redefinition errors:
-            // - STL itself will tell us if there is a direct name collision, with name mangling, at this level
+            // - STL itself will tell us if there is a direct name collision at this level
+            // - a function's overloads are told apart by mangled name
             // - additionally, check for function-redefining-variable name collisions
-            const TString& insertName = symbol.getMangledName();
+            int key = getKey(name);
             if (symbol.getAsFunction()) {
                 // make sure there isn't a variable of this name
-                if (! separateNameSpaces && level.find(name) != level.end())
+                if (! separateNameSpaces && level.find(key) != level.end())
                     return false;
 
                 // insert, and whatever happens is okay
-                level.insert(tLevelPair(insertName, &symbol));
+                indexFunction(key, *symbol.getAsFunction());
 
                 return true;
             } else {
-                result = level.insert(tLevelPair(insertName, &symbol));
+                result = level.insert(tLevelPair(key, &symbol));
 
                 return result.second;
             }
         }
     }
 
-    TSymbol* find(const TString& name) const
+    // Find a variable by name, or a function by mangled name, where 'atom' is that of the non-mangled name.
+    TSymbol* find(const TString& name, int atom) const
     {
-        tLevel::const_iterator it = level.find(name);
-        if (it == level.end()) 
+        int key = findKey(name, atom);
+        if (key == 0)
             return 0;
-        else
-            return (*it).second;
+
+        if (name.find_first_of('(') == name.npos) {
+            tLevel::const_iterator it = level.find(key);
+
+            return it == level.end() ? 0 : it->second;
+        }
+
+        tFunctionIndex::const_iterator overloads = functions.find(key);
+        if (overloads != functions.end()) {
+            TFunctionList::const_iterator it = std::lower_bound(overloads->second.begin(), overloads->second.end(), name, lessMangledNameThan);
+            if (it != overloads->second.end() && (*it)->getMangledName() == name)
+                return *it;
+        }
+
+        return lazyFunctions ? lazyFunctions->find(key, name) : 0;
     }
 
-    void findFunctionNameList(const TString& name, TVector<TFunction*>& list)
+    // Append all the overloads of the function named by the given mangled name, in order of mangled name.
+    void findFunctionNameList(const TString& name, int atom, TVector<TFunction*>& list) const
     {
-        size_t parenAt = name.find_first_of('(');
-        TString base(name, 0, parenAt + 1);
+        int key = findKey(name, atom);
+        if (key == 0)
+            return;
 
-        tLevel::const_iterator begin = level.lower_bound(base);
-        base[parenAt] = ')';  // assume ')' is lexically after '('
-        tLevel::const_iterator end = level.upper_bound(base);
-        for (tLevel::const_iterator it = begin; it != end; ++it)
-            list.push_back(it->second->getAsFunction());
+        size_t start = list.size();
+        tFunctionIndex::const_iterator overloads = functions.find(key);
+        if (overloads != functions.end())
+            list.insert(list.end(), overloads->second.begin(), overloads->second.end());
+
+        if (lazyFunctions) {
+            const TFunctionList* lazyOverloads = lazyFunctions->findFunctions(key);
+            if (lazyOverloads) {
+                bool merge = list.size() > start;
+                list.insert(list.end(), lazyOverloads->begin(), lazyOverloads->end());
+                if (merge)
+                    std::sort(list.begin() + start, list.end(), lessMangledName);
+            }
+        }
     }
 
     // See if there is already a function in the table having the given non-function-style name.
-    bool hasFunctionName(const TString& name) const
+    bool hasFunctionName(const TString& name, int atom) const
     {
-        tLevel::const_iterator candidate = level.lower_bound(name);
-        if (candidate != level.end()) {
-            const TString& candidateName = (*candidate).first;
-            TString::size_type parenAt = candidateName.find_first_of('(');
-            if (parenAt != candidateName.npos && candidateName.compare(0, parenAt, name) == 0)
+        int key = findKey(name, atom);
+        if (key == 0)
+            return false;
 
-                return true;
-        }
+        if (functions.find(key) != functions.end())
+            return true;
 
-        return false;
+        return lazyFunctions && lazyFunctions->hasName(key);
     }
 
     // See if there is a variable at this level having the given non-function-style name.
     // Return true if name is found, and set variable to true if the name was a variable.
-    bool findFunctionVariableName(const TString& name, bool& variable) const
-    {
-        tLevel::const_iterator candidate = level.lower_bound(name);
-        if (candidate != level.end()) {
-            const TString& candidateName = (*candidate).first;
-            TString::size_type parenAt = candidateName.find_first_of('(');
-            if (parenAt == candidateName.npos) {
-                // not a mangled name
-                if (candidateName == name) {
-                    // found a variable name match
-                    variable = true;
-                    return true;
-                }
-            } else {
-                // a mangled name
-                if (candidateName.compare(0, parenAt, name) == 0) {
-                    // found a function name match
-                    variable = false;
-                    return true;
-                }
-            }
+    bool findFunctionVariableName(const TString& name, int atom, bool& variable) const
+    {
+        int key = findKey(name, atom);
+        if (key == 0)
+            return false;
+
+        if (level.find(key) != level.end()) {
+            // found a variable name match
+            variable = true;
+            return true;
+        }
+
+        if (functions.find(key) != functions.end() || (lazyFunctions && lazyFunctions->hasName(key))) {
+            variable = false;
+            return true;
         }
 
         return false;
     }
 
+    // Add built-in function prototypes that are only parsed when looked up, see TLazyFunctions.
+    void addLazyFunctions(const TString& prototypes, int version, EProfile profile, EShLanguage language);
+
     // Use this to do a lazy 'push' of precision defaults the first time
     // a precision statement is seen in a new scope.  Leave it at 0 for
     // when no push was needed.  Thus, it is not the current defaults,
@@ -430,27 +560,65 @@ public:
     }
 
     void relateToOperator(const char* name, TOperator op);
-    void setFunctionExtensions(const char* name, int num, const char* const extensions[]);
+    void setFunctionExtensions(const char* name, int num, const TExtension extensions[]);
     void dump(TInfoSink &infoSink) const;
     TSymbolTableLevel* clone() const;
     void readOnly();
+    TOverloadCache* getOverloadCache() const { return overloadCache; }
 
 protected:
+    friend class TSymbolTableWriter;
+    friend class TSymbolTableReader;
+
     explicit TSymbolTableLevel(TSymbolTableLevel&);
     TSymbolTableLevel& operator=(TSymbolTableLevel&);
 
-    typedef std::map<TString, TSymbol*, std::less<TString>, pool_allocator<std::pair<const TString, TSymbol*> > > tLevel;
+    typedef TUnorderedMap<int, TSymbol*> tLevel;
     typedef const tLevel::value_type tLevelPair;
     typedef std::pair<tLevel::iterator, bool> tInsertResult;
+    typedef TUnorderedMap<int, TFunctionList> tFunctionIndex;
+    typedef TUnorderedMap<TString, int> tUnatomized;
+
+    // The key for a name, adding one if needed.
+    int getKey(const TString& name);
+
+    // The key for a (possibly mangled) name having the given atom in the
+    // current compile; 0 if no symbol at this level can have the name.
+    int findKey(const TString& name, int atom) const;
+
+    static bool lessMangledName(const TFunction* left, const TFunction* right)
+    {
+        return left->getMangledName() < right->getMangledName();
+    }
+
+    static bool lessMangledNameThan(const TFunction* left, const TString& right)
+    {
+        return left->getMangledName() < right;
+    }
 
-    tLevel level;  // named mappings
+    // Add a function to its name's overloads, keeping them in order of mangled name.
+    // A function with the same mangled name as one already there is not added.
+    void indexFunction(int key, TFunction& function)
+    {
+        TFunctionList& overloads = functions[key];
+        TFunctionList::iterator it = std::lower_bound(overloads.begin(), overloads.end(), function.getMangledName(), lessMangledNameThan);
+        if (it == overloads.end() || (*it)->getMangledName() != function.getMangledName())
+            overloads.insert(it, &function);
+    }
+
+    TPpContext* atoms;  // whose atoms are the keys, or 0 for the process-wide ones
+    tLevel level;  // the variables and anonymous members, by name
+    tFunctionIndex functions;  // the functions, by non-mangled name
+    tUnatomized unatomized;  // the keys of names without process-wide atoms, when 'atoms' is 0
     TPrecisionQualifier *defaultPrecision;
     int anonId;
+    TLazyFunctions* lazyFunctions;  // function names not yet in 'functions', if any
+    TOverloadCache* overloadCache;  // once read only, resolutions against this level and those below it
 };
 
 class TSymbolTable {
 public:
-    TSymbolTable() : uniqueId(0), noBuiltInRedeclarations(false), separateNameSpaces(false), adoptedLevels(0)
+    TSymbolTable() : uniqueId(0), noBuiltInRedeclarations(false), separateNameSpaces(false), adoptedLevels(0), atoms(0)
     {
         //
         // This symbol table cannot be used until push() is called.
@@ -496,10 +664,13 @@ public:
 
     void setNoBuiltInRedeclarations() { noBuiltInRedeclarations = true; }
     void setSeparateNameSpaces() { separateNameSpaces = true; }
+
+    // The preprocessor whose atoms key the levels pushed after the built-in ones.
+    void setAtoms(TPpContext* context) { atoms = context; }
     
     void push()
     {
-        table.push_back(new TSymbolTableLevel);
+        table.push_back(new TSymbolTableLevel(isBuiltInLevel(currentLevel() + 1) ? 0 : atoms));
     }
 
     void pop(TPrecisionQualifier *p)
@@ -518,17 +689,18 @@ public:
     bool insert(TSymbol& symbol)
     {
         symbol.setUniqueId(++uniqueId);
+        int atom = findAtom(symbol.getName());
 
         // make sure there isn't a function of this variable name
-        if (! separateNameSpaces && ! symbol.getAsFunction() && table[currentLevel()]->hasFunctionName(symbol.getName()))
+        if (! separateNameSpaces && ! symbol.getAsFunction() && table[currentLevel()]->hasFunctionName(symbol.getName(), atom))
             return false;
             
         // check for not overloading or redefining a built-in function
         if (noBuiltInRedeclarations) {
             if (atGlobalLevel() && currentLevel() > 0) {
-                if (table[0]->hasFunctionName(symbol.getName()))
+                if (table[0]->hasFunctionName(symbol.getName(), atom))
                     return false;
-                if (currentLevel() > 1 && table[1]->hasFunctionName(symbol.getName()))
+                if (currentLevel() > 1 && table[1]->hasFunctionName(symbol.getName(), atom))
                     return false;
             }
         }
@@ -555,13 +727,13 @@ public:
     TSymbol* copyUpDeferredInsert(TSymbol* shared)
     {
         if (shared->getAsVariable()) {
-            TSymbol* copy = shared->clone();
+            TSymbol* copy = shared->getAsVariable()->editableClone();
             copy->setUniqueId(shared->getUniqueId());
             return copy;
         } else {
             const TAnonMember* anon = shared->getAsAnonMember();
             assert(anon);
-            TVariable* container = anon->getAnonContainer().clone();
+            TVariable* container = anon->getAnonContainer().editableClone();
             container->changeName(NewPoolTString(""));
             container->setUniqueId(anon->getAnonContainer().getUniqueId());
             return container;
@@ -576,16 +748,23 @@ public:
             return copy;
         else {
             // return the copy of the anonymous member
-            return table[globalLevel]->find(shared->getName());
+            return table[globalLevel]->find(shared->getName(), findAtom(shared->getName()));
         }
     }
 
-    TSymbol* find(const TString& name, bool* builtIn = 0, bool *currentScope = 0)
+    //
+    // Find a variable by name, or a function by mangled name.  The scanner
+    // passes the atom the name already has, saving looking it up again.
+    //
+    TSymbol* find(const TString& name, bool* builtIn = 0, bool *currentScope = 0, int atom = 0)
     {
+        if (atom == 0)
+            atom = findAtom(name);
+
         int level = currentLevel();
         TSymbol* symbol;
         do {
-            symbol = table[level]->find(name);
+            symbol = table[level]->find(name, atom);
             --level;
         } while (symbol == 0 && level >= 0);
         level++;
@@ -602,10 +781,11 @@ public:
         if (separateNameSpaces)
             return false;
 
+        int atom = findAtom(name);
         int level = currentLevel();
         do {
             bool variable;
-            bool found = table[level]->findFunctionVariableName(name, variable);
+            bool found = table[level]->findFunctionVariableName(name, atom, variable);
             if (found)
                 return variable;
             --level;
@@ -618,9 +798,10 @@ public:
     {
         // For user levels, return the set found in the first scope with a match
         builtIn = false;
+        int atom = findAtom(name);
         int level = currentLevel();
         do {
-            table[level]->findFunctionNameList(name, list);
+            table[level]->findFunctionNameList(name, atom, list);
             --level;
         } while (list.empty() && level >= globalLevel);
 
@@ -630,7 +811,7 @@ public:
         // Gather across all built-in levels; they don't hide each other
         builtIn = true;
         do {
-            table[level]->findFunctionNameList(name, list);
+            table[level]->findFunctionNameList(name, atom, list);
             --level;
         } while (level >= 0);
     }
@@ -641,19 +822,54 @@ public:
             table[level]->relateToOperator(name, op);
     }
     
-    void setFunctionExtensions(const char* name, int num, const char* const extensions[])
+    void setFunctionExtensions(const char* name, int num, const TExtension extensions[])
     {
         for (unsigned int level = 0; level < table.size(); ++level)
             table[level]->setFunctionExtensions(name, num, extensions);
     }
 
-    void setVariableExtensions(const char* name, int num, const char* const extensions[])
+    void setFunctionExtensions(const char* name, TExtension extension)
+    {
+        setFunctionExtensions(name, 1, &extension);
+    }
+
+    void addLazyFunctions(const TString& prototypes, int version, EProfile profile, EShLanguage language)
+    {
+        table[currentLevel()]->addLazyFunctions(prototypes, version, profile, language);
+    }
+
+    //
+    // When only the shared levels have functions of this name, overload resolution
+    // depends on nothing but the call, so can be cached with the per-stage level,
+    // for all compiles of the same version, profile, and stage.  Returns 0 if
+    // that's not the case.
+    //
+    TOverloadCache* getOverloadCache(const TString& name)
+    {
+        if (adoptedLevels < 2)
+            return 0;
+
+        int atom = findAtom(name);
+        for (int level = currentLevel(); ! isSharedLevel(level); --level) {
+            if (table[level]->hasFunctionName(name, atom))
+                return 0;
+        }
+
+        return table[1]->getOverloadCache();
+    }
+
+    void setVariableExtensions(const char* name, int num, const TExtension extensions[])
     {
         TSymbol* symbol = find(TString(name));
-        if (symbol)
+        if (symbol && ! symbol->isReadOnly())
             symbol->setExtensions(num, extensions);
     }
 
+    void setVariableExtensions(const char* name, TExtension extension)
+    {
+        setVariableExtensions(name, 1, &extension);
+    }
+
     int getMaxSymbolId() { return uniqueId; }
     void dump(TInfoSink &infoSink) const;
     void copyTable(const TSymbolTable& copyOf);
@@ -667,16 +883,25 @@ public:
     }
 
 protected:
+    friend class TSymbolTableWriter;
+    friend class TSymbolTableReader;
+    friend class TLazyFunctions;
+
     TSymbolTable(TSymbolTable&);
     TSymbolTable& operator=(TSymbolTableLevel&);
 
     int currentLevel() const { return static_cast<int>(table.size()) - 1; }
 
+    // The atom of a name, or of the non-mangled part of a mangled one, in the
+    // current compile; 0 if it has none, so no level has it, except by text.
+    int findAtom(const TString& name) const;
+
     std::vector<TSymbolTableLevel*> table;
     int uniqueId;     // for unique identification in code generation
     bool noBuiltInRedeclarations;
     bool separateNameSpaces;
     unsigned int adoptedLevels;
+    TPpContext* atoms;
 };
 
 } // end namespace glslang
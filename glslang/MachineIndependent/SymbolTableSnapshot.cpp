@@ -0,0 +1,665 @@
+//
+//Copyright (C) 2015 LunarG, Inc.
+//
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions
+//are met:
+//
+//    Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//    Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//    Neither the name of 3Dlabs Inc. Ltd. nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+//INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "SymbolTableSnapshot.h"
+
+#include <string.h>
+
+namespace glslang {
+
+//
+// The kinds of entries written for a level.  An anonymous block's members
+// are not written; they are made again from the block's container.
+//
+enum TSnapshotSymbol {
+    ESnapshotVariable,
+    ESnapshotFunction,
+    ESnapshotAnonContainer,
+};
+
+//
+// Writing
+//
+
+void TSymbolTableWriter::writeInt(int value)
+{
+    writeBytes(&value, sizeof(value));
+}
+
+void TSymbolTableWriter::writeBytes(const void* bytes, size_t size)
+{
+    image.append(static_cast<const char*>(bytes), size);
+}
+
+// A missing string is written with a length of -1.
+void TSymbolTableWriter::writeString(const TString* string)
+{
+    if (string == 0) {
+        writeInt(-1);
+        return;
+    }
+
+    writeInt((int)string->size());
+    writeBytes(string->c_str(), string->size());
+}
+
+//
+// Types are written a field at a time, never as raw bytes, so an image holds
+// no padding and doesn't depend on how this build lays out bit-fields.
+// Booleans are gathered into a single mask.
+//
+
+void TSymbolTableWriter::writeSampler(const TSampler& sampler)
+{
+    writeInt(sampler.type);
+    writeInt(sampler.dim);
+    writeInt((sampler.arrayed  ? 1 << 0 : 0) |
+             (sampler.shadow   ? 1 << 1 : 0) |
+             (sampler.ms       ? 1 << 2 : 0) |
+             (sampler.image    ? 1 << 3 : 0) |
+             (sampler.external ? 1 << 4 : 0));
+}
+
+void TSymbolTableWriter::writeQualifier(const TQualifier& qualifier)
+{
+    writeInt(qualifier.storage);
+    writeInt(qualifier.builtIn);
+    writeInt(qualifier.precision);
+    writeInt((qualifier.invariant ? 1 << 0  : 0) |
+             (qualifier.centroid  ? 1 << 1  : 0) |
+             (qualifier.smooth    ? 1 << 2  : 0) |
+             (qualifier.flat      ? 1 << 3  : 0) |
+             (qualifier.nopersp   ? 1 << 4  : 0) |
+             (qualifier.patch     ? 1 << 5  : 0) |
+             (qualifier.sample    ? 1 << 6  : 0) |
+             (qualifier.coherent  ? 1 << 7  : 0) |
+             (qualifier.volatil   ? 1 << 8  : 0) |
+             (qualifier.restrict  ? 1 << 9  : 0) |
+             (qualifier.readonly  ? 1 << 10 : 0) |
+             (qualifier.writeonly ? 1 << 11 : 0));
+    writeInt(qualifier.layoutMatrix);
+    writeInt(qualifier.layoutPacking);
+    writeInt(qualifier.layoutOffset);
+    writeInt(qualifier.layoutAlign);
+    writeInt(qualifier.layoutLocation);
+    writeInt(qualifier.layoutComponent);
+    writeInt(qualifier.layoutSet);
+    writeInt(qualifier.layoutBinding);
+    writeInt(qualifier.layoutIndex);
+    writeInt(qualifier.layoutStream);
+    writeInt(qualifier.layoutXfbBuffer);
+    writeInt(qualifier.layoutXfbStride);
+    writeInt(qualifier.layoutXfbOffset);
+    writeInt(qualifier.layoutFormat);
+}
+
+void TSymbolTableWriter::writeConstUnion(const TConstUnion& constant)
+{
+    writeInt(constant.getType());
+    switch (constant.getType()) {
+    case EbtInt:    writeInt(constant.getIConst());                 break;
+    case EbtUint:   writeInt((int)constant.getUConst());            break;
+    case EbtBool:   writeInt(constant.getBConst() ? 1 : 0);         break;
+    default:
+    {
+        double value = constant.getDConst();
+        writeBytes(&value, sizeof(value));
+        break;
+    }
+    }
+}
+
+void TSymbolTableWriter::writeType(const TType& type)
+{
+    writeInt(type.basicType);
+    writeInt(type.vectorSize);
+    writeInt(type.matrixCols);
+    writeInt(type.matrixRows);
+    writeSampler(type.sampler);
+    writeQualifier(type.qualifier);
+
+    if (type.arraySizes) {
+        int numDims = type.arraySizes->getNumDims();
+        writeInt(numDims);
+        writeInt(type.arraySizes->getImplicitSize());
+        for (int d = 0; d < numDims; ++d)
+            writeInt((*type.arraySizes)[d]);
+    } else
+        writeInt(-1);
+
+    if (type.structure) {
+        writeInt((int)type.structure->size());
+        for (unsigned int m = 0; m < type.structure->size(); ++m) {
+            const TTypeLoc& member = (*type.structure)[m];
+            writeInt(member.loc.string);
+            writeInt(member.loc.line);
+            writeInt(member.loc.column);
+            writeType(*member.type);
+        }
+    } else
+        writeInt(-1);
+
+    writeString(type.fieldName);
+    writeString(type.typeName);
+}
+
+// What all symbols have beyond their name, written last, after what's needed to construct the symbol.
+void TSymbolTableWriter::writeSymbol(const TSymbol& symbol)
+{
+    writeInt(symbol.getUniqueId());
+    writeInt(symbol.getNumExtensions());
+    for (int e = 0; e < symbol.getNumExtensions(); ++e)
+        writeInt(symbol.getExtensions()[e]);
+}
+
+void TSymbolTableWriter::writeVariable(const TVariable& variable)
+{
+    writeString(&variable.getName());
+    writeType(variable.getType());
+    writeInt(variable.isUserType());
+
+    const TConstUnionArray& constArray = variable.getConstArray();
+    writeInt(constArray.size());
+    for (int c = 0; c < constArray.size(); ++c)
+        writeConstUnion(constArray[c]);
+
+    writeSymbol(variable);
+}
+
+void TSymbolTableWriter::writeFunction(const TFunction& function)
+{
+    writeString(&function.getName());
+    writeType(function.returnType);
+    writeInt(function.op);
+    writeString(&function.mangledName);
+    writeInt(function.defined);
+    writeInt(function.prototyped);
+
+    writeInt(function.getParamCount());
+    for (int p = 0; p < function.getParamCount(); ++p) {
+        writeString(function[p].name);
+        writeType(*function[p].type);
+    }
+
+    writeSymbol(function);
+}
+
+void TSymbolTableWriter::writeLevel(const TSymbolTableLevel& level)
+{
+    writeInt(level.anonId);
+
+    // Each anonymous container is written once, for all its members, as in TSymbolTableLevel::clone().
+    std::vector<bool> containerWritten(level.anonId, false);
+    int numEntries = 0;
+    TSymbolTableLevel::tLevel::const_iterator it;
+    for (it = level.level.begin(); it != level.level.end(); ++it) {
+        const TAnonMember* anon = it->second->getAsAnonMember();
+        if (anon == 0 || ! containerWritten[anon->getAnonId()]) {
+            if (anon)
+                containerWritten[anon->getAnonId()] = true;
+            ++numEntries;
+        }
+    }
+    TSymbolTableLevel::tFunctionIndex::const_iterator overloads;
+    for (overloads = level.functions.begin(); overloads != level.functions.end(); ++overloads)
+        numEntries += (int)overloads->second.size();
+
+    writeInt(numEntries);
+    containerWritten.assign(level.anonId, false);
+    for (it = level.level.begin(); it != level.level.end(); ++it) {
+        const TSymbol& symbol = *it->second;
+        const TAnonMember* anon = symbol.getAsAnonMember();
+        if (anon) {
+            if (! containerWritten[anon->getAnonId()]) {
+                writeInt(ESnapshotAnonContainer);
+                writeVariable(anon->getAnonContainer());
+                writeInt(anon->getAnonId());
+                containerWritten[anon->getAnonId()] = true;
+            }
+        } else {
+            writeInt(ESnapshotVariable);
+            writeVariable(*symbol.getAsVariable());
+        }
+    }
+    for (overloads = level.functions.begin(); overloads != level.functions.end(); ++overloads) {
+        for (TFunctionList::const_iterator f = overloads->second.begin(); f != overloads->second.end(); ++f) {
+            writeInt(ESnapshotFunction);
+            writeFunction(**f);
+        }
+    }
+
+    if (level.lazyFunctions) {
+        writeInt(1);
+        writeLazyFunctions(*level.lazyFunctions);
+    } else
+        writeInt(0);
+}
+
+// The functions of every name, parsed now if not yet, so that reading them
+// back parses nothing.  The prototypes aren't needed after that.
+void TSymbolTableWriter::writeLazyFunctions(const TLazyFunctions& lazyFunctions)
+{
+    writeInt(lazyFunctions.version);
+    writeInt(lazyFunctions.profile);
+    writeInt(lazyFunctions.language);
+
+    writeInt((int)lazyFunctions.entries.size());
+    TLazyFunctions::tEntries::const_iterator it;
+    for (it = lazyFunctions.entries.begin(); it != lazyFunctions.entries.end(); ++it) {
+        const TLazyFunctions::TEntry& entry = *it->second;
+        writeString(&entry.name);
+        writeInt(entry.op);
+        writeInt(entry.numExtensions);
+        for (int e = 0; e < entry.numExtensions; ++e)
+            writeInt(entry.extensions[e]);
+
+        const TFunctionList* functions = lazyFunctions.findFunctions(it->first);
+        writeInt(functions ? (int)functions->size() : 0);
+        for (int f = 0; functions && f < (int)functions->size(); ++f)
+            writeFunction(*(*functions)[f]);
+    }
+}
+
+void TSymbolTableWriter::writeTable(const TSymbolTable& table)
+{
+    writeInt(table.uniqueId);
+    writeInt(table.noBuiltInRedeclarations);
+    writeInt(table.separateNameSpaces);
+
+    writeInt((int)(table.table.size() - table.adoptedLevels));
+    for (unsigned int level = table.adoptedLevels; level < table.table.size(); ++level)
+        writeLevel(*table.table[level]);
+}
+
+//
+// Reading
+//
+// Nothing read is trusted to be in bounds.  Once something is out of bounds,
+// reading continues with zeros, so that callers need only check at the end.
+//
+
+int TSymbolTableReader::readInt()
+{
+    int value = 0;
+    readBytes(&value, sizeof(value));
+
+    return value;
+}
+
+bool TSymbolTableReader::readBytes(void* bytes, size_t size)
+{
+    if (bad || (size_t)(end - next) < size) {
+        bad = true;
+        memset(bytes, 0, size);
+        return false;
+    }
+
+    memcpy(bytes, next, size);
+    next += size;
+
+    return true;
+}
+
+// A count of things still to read, each at least a byte, so a bad count can't run away.
+int TSymbolTableReader::readCount()
+{
+    int count = readInt();
+    if (count < 0 || count > end - next) {
+        bad = true;
+        return 0;
+    }
+
+    return count;
+}
+
+TExtension TSymbolTableReader::readExtension()
+{
+    int extension = readInt();
+    if (extension < 0 || extension >= NumExtensions) {
+        bad = true;
+        return static_cast<TExtension>(0);
+    }
+
+    return static_cast<TExtension>(extension);
+}
+
+TString* TSymbolTableReader::readString()
+{
+    int length = readInt();
+    if (length == -1)
+        return 0;
+    if (length < 0 || length > end - next) {
+        bad = true;
+        return 0;
+    }
+
+    TString* string = NewPoolTString("");
+    string->assign(next, length);
+    next += length;
+
+    return string;
+}
+
+void TSymbolTableReader::readSampler(TSampler& sampler)
+{
+    sampler.type = (TBasicType)readInt();
+    sampler.dim = (TSamplerDim)readInt();
+    int flags = readInt();
+    sampler.arrayed  = (flags & (1 << 0)) != 0;
+    sampler.shadow   = (flags & (1 << 1)) != 0;
+    sampler.ms       = (flags & (1 << 2)) != 0;
+    sampler.image    = (flags & (1 << 3)) != 0;
+    sampler.external = (flags & (1 << 4)) != 0;
+}
+
+void TSymbolTableReader::readQualifier(TQualifier& qualifier)
+{
+    qualifier.storage = (TStorageQualifier)readInt();
+    qualifier.builtIn = (TBuiltInVariable)readInt();
+    qualifier.precision = (TPrecisionQualifier)readInt();
+    int flags = readInt();
+    qualifier.invariant = (flags & (1 << 0))  != 0;
+    qualifier.centroid  = (flags & (1 << 1))  != 0;
+    qualifier.smooth    = (flags & (1 << 2))  != 0;
+    qualifier.flat      = (flags & (1 << 3))  != 0;
+    qualifier.nopersp   = (flags & (1 << 4))  != 0;
+    qualifier.patch     = (flags & (1 << 5))  != 0;
+    qualifier.sample    = (flags & (1 << 6))  != 0;
+    qualifier.coherent  = (flags & (1 << 7))  != 0;
+    qualifier.volatil   = (flags & (1 << 8))  != 0;
+    qualifier.restrict  = (flags & (1 << 9))  != 0;
+    qualifier.readonly  = (flags & (1 << 10)) != 0;
+    qualifier.writeonly = (flags & (1 << 11)) != 0;
+    qualifier.layoutMatrix = (TLayoutMatrix)readInt();
+    qualifier.layoutPacking = (TLayoutPacking)readInt();
+    qualifier.layoutOffset = readInt();
+    qualifier.layoutAlign = readInt();
+    qualifier.layoutLocation = readInt();
+    qualifier.layoutComponent = readInt();
+    qualifier.layoutSet = readInt();
+    qualifier.layoutBinding = readInt();
+    qualifier.layoutIndex = readInt();
+    qualifier.layoutStream = readInt();
+    qualifier.layoutXfbBuffer = readInt();
+    qualifier.layoutXfbStride = readInt();
+    qualifier.layoutXfbOffset = readInt();
+    qualifier.layoutFormat = (TLayoutFormat)readInt();
+}
+
+void TSymbolTableReader::readConstUnion(TConstUnion& constant)
+{
+    switch (readInt()) {
+    case EbtInt:    constant.setIConst(readInt());                  break;
+    case EbtUint:   constant.setUConst((unsigned int)readInt());    break;
+    case EbtBool:   constant.setBConst(readInt() != 0);             break;
+    default:
+    {
+        double value;
+        readBytes(&value, sizeof(value));
+        constant.setDConst(value);
+        break;
+    }
+    }
+}
+
+void TSymbolTableReader::readType(TType& type)
+{
+    type.basicType = (TBasicType)readInt();
+    type.vectorSize = readInt();
+    type.matrixCols = readInt();
+    type.matrixRows = readInt();
+    readSampler(type.sampler);
+    readQualifier(type.qualifier);
+
+    int numDims = readInt();
+    if (numDims >= 0) {
+        type.arraySizes = new TArraySizes;
+        type.arraySizes->setImplicitSize(readInt());
+        if (numDims > end - next)
+            bad = true;
+        for (int d = 0; d < numDims && ! bad; ++d)
+            type.arraySizes->setOuterSize(readInt());
+    } else
+        type.arraySizes = 0;
+
+    int numMembers = readInt();
+    if (numMembers >= 0) {
+        type.structure = new TTypeList;
+        if (numMembers > end - next)
+            bad = true;
+        for (int m = 0; m < numMembers && ! bad; ++m) {
+            TTypeLoc member;
+            member.loc.init();
+            member.loc.string = readInt();
+            member.loc.line = readInt();
+            member.loc.column = readInt();
+            member.type = new TType;
+            readType(*member.type);
+            type.structure->push_back(member);
+        }
+    } else
+        type.structure = 0;
+
+    type.fieldName = readString();
+    type.typeName = readString();
+}
+
+void TSymbolTableReader::readSymbol(TSymbol& symbol)
+{
+    symbol.setUniqueId(readInt());
+
+    int numExtensions = readCount();
+    if (numExtensions == 0)
+        return;
+
+    std::vector<TExtension> extensions;
+    for (int e = 0; e < numExtensions; ++e)
+        extensions.push_back(readExtension());
+    symbol.setExtensions(numExtensions, &extensions[0]);
+}
+
+TVariable* TSymbolTableReader::readVariable()
+{
+    const TString* name = readString();
+    TType type;
+    readType(type);
+    bool userType = readInt() != 0;
+    if (name == 0)
+        bad = true;
+    if (bad)
+        return 0;
+
+    TVariable* variable = new TVariable(name, type, userType);
+
+    int numConsts = readCount();
+    if (numConsts > 0) {
+        TConstUnionArray constArray(numConsts);
+        for (int c = 0; c < numConsts; ++c)
+            readConstUnion(constArray[c]);
+        variable->setConstArray(constArray);
+    }
+
+    readSymbol(*variable);
+
+    return variable;
+}
+
+TFunction* TSymbolTableReader::readFunction()
+{
+    const TString* name = readString();
+    TType returnType;
+    readType(returnType);
+    TOperator op = (TOperator)readInt();
+    const TString* mangledName = readString();
+    if (name == 0 || mangledName == 0)
+        bad = true;
+    if (bad)
+        return 0;
+
+    // The mangled name is taken as written, rather than built up again as the parameters are added.
+    TFunction* function = new TFunction(name, returnType, op);
+    function->mangledName = *mangledName;
+    function->defined = readInt() != 0;
+    function->prototyped = readInt() != 0;
+
+    int numParams = readCount();
+    for (int p = 0; p < numParams && ! bad; ++p) {
+        TParameter param;
+        param.name = readString();
+        param.type = new TType;
+        readType(*param.type);
+        function->parameters.push_back(param);
+    }
+
+    readSymbol(*function);
+
+    return function;
+}
+
+void TSymbolTableReader::readLevel(TSymbolTableLevel& level)
+{
+    level.anonId = readInt();
+
+    int numEntries = readCount();
+    for (int e = 0; e < numEntries && ! bad; ++e) {
+        switch (readInt()) {
+        case ESnapshotVariable:
+        {
+            TVariable* variable = readVariable();
+            if (variable)
+                level.level.insert(TSymbolTableLevel::tLevelPair(level.getKey(variable->getName()), variable));
+            break;
+        }
+        case ESnapshotFunction:
+        {
+            TFunction* function = readFunction();
+            if (function)
+                level.indexFunction(level.getKey(function->getName()), *function);
+            break;
+        }
+        case ESnapshotAnonContainer:
+        {
+            // make the members again, all pointing to this one container, as TSymbolTableLevel::insert() does
+            TVariable* container = readVariable();
+            int anonId = readInt();
+            if (container == 0 || container->getType().getStruct() == 0) {
+                bad = true;
+                break;
+            }
+            const TTypeList& types = *container->getType().getStruct();
+            for (unsigned int m = 0; m < types.size(); ++m) {
+                if (types[m].type->fieldName == 0) {
+                    bad = true;
+                    break;
+                }
+                TAnonMember* member = new TAnonMember(types[m].type->fieldName, m, *container, anonId);
+                level.level.insert(TSymbolTableLevel::tLevelPair(level.getKey(member->getName()), member));
+            }
+            break;
+        }
+        default:
+            bad = true;
+            break;
+        }
+    }
+
+    if (readInt() != 0 && ! bad)
+        level.lazyFunctions = readLazyFunctions(level);
+}
+
+// The names are keyed anew, by the level being read.
+TLazyFunctions* TSymbolTableReader::readLazyFunctions(TSymbolTableLevel& level)
+{
+    int version = readInt();
+    EProfile profile = (EProfile)readInt();
+    int language = readInt();
+    if (language < 0 || language >= EShLangCount)
+        bad = true;
+    if (bad)
+        return 0;
+
+    TLazyFunctions* lazyFunctions = new TLazyFunctions(version, profile, (EShLanguage)language);
+
+    int numEntries = readCount();
+    for (int e = 0; e < numEntries && ! bad; ++e) {
+        const TString* name = readString();
+        if (name == 0) {
+            bad = true;
+            break;
+        }
+        int key = level.getKey(*name);
+        TLazyFunctions::TEntry& entry = lazyFunctions->getEntry(key, *name);
+        entry.op = (TOperator)readInt();
+
+        int numExtensions = readCount();
+        if (numExtensions > 0) {
+            std::vector<TExtension> extensions;
+            for (int x = 0; x < numExtensions; ++x)
+                extensions.push_back(readExtension());
+            lazyFunctions->setFunctionExtensions(key, numExtensions, &extensions[0]);
+        }
+
+        // already parsed, as TLazyFunctions::parse() leaves them
+        TFunctionList* functions = new TFunctionList;
+        int numFunctions = readCount();
+        for (int f = 0; f < numFunctions && ! bad; ++f) {
+            TFunction* function = readFunction();
+            if (function) {
+                function->makeReadOnly();
+                functions->push_back(function);
+            }
+        }
+        entry.functions.store(functions, std::memory_order_relaxed);
+    }
+
+    return lazyFunctions;
+}
+
+bool TSymbolTableReader::readTable(TSymbolTable& table)
+{
+    table.uniqueId = readInt();
+    table.noBuiltInRedeclarations = readInt() != 0;
+    table.separateNameSpaces = readInt() != 0;
+
+    int numLevels = readCount();
+    for (int level = 0; level < numLevels && ! bad; ++level) {
+        table.push();
+        readLevel(*table.table.back());
+    }
+
+    return ! bad;
+}
+
+} // end namespace glslang
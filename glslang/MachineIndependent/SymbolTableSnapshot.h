@@ -0,0 +1,121 @@
+//
+//Copyright (C) 2015 LunarG, Inc.
+//
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions
+//are met:
+//
+//    Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//    Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//    Neither the name of 3Dlabs Inc. Ltd. nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+//INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+//ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef _SYMBOL_TABLE_SNAPSHOT_INCLUDED_
+#define _SYMBOL_TABLE_SNAPSHOT_INCLUDED_
+
+//
+// Flattening of shared built-in symbol tables into an image, and rebuilding
+// them from it, so built-ins can be read from a snapshot instead of being
+// generated and parsed again.
+//
+// The image holds no pointers, so it can be used from a mapped file.  What the
+// tables link by pointer (types within types, the container of an anonymous
+// member, ...) is rebuilt on reading, the same way TSymbolTableLevel::clone()
+// does it.  An image is only meaningful to the build of glslang that wrote it.
+//
+
+#include "SymbolTable.h"
+
+#include <string>
+
+namespace glslang {
+
+class TSymbolTableWriter {
+public:
+    explicit TSymbolTableWriter(std::string& image) : image(image) { }
+
+    // Append the levels 'table' did not adopt from another table.
+    void writeTable(const TSymbolTable&);
+
+    void writeInt(int);
+    void writeBytes(const void*, size_t);
+
+protected:
+    TSymbolTableWriter(TSymbolTableWriter&);
+    TSymbolTableWriter& operator=(TSymbolTableWriter&);
+
+    void writeString(const TString*);
+    void writeSampler(const TSampler&);
+    void writeQualifier(const TQualifier&);
+    void writeConstUnion(const TConstUnion&);
+    void writeType(const TType&);
+    void writeSymbol(const TSymbol&);
+    void writeVariable(const TVariable&);
+    void writeFunction(const TFunction&);
+    void writeLevel(const TSymbolTableLevel&);
+    void writeLazyFunctions(const TLazyFunctions&);
+
+    std::string& image;
+};
+
+class TSymbolTableReader {
+public:
+    TSymbolTableReader(const char* image, size_t size) : next(image), end(image + size), bad(false) { }
+
+    // Push onto 'table' the levels written for it by TSymbolTableWriter::writeTable(),
+    // allocating from the current pool.  If the table adopts levels, it must
+    // already have done so.  Returns false if the image is malformed.
+    bool readTable(TSymbolTable&);
+
+    int readInt();
+    bool readBytes(void*, size_t);
+    bool failed() const { return bad; }
+
+protected:
+    TSymbolTableReader(TSymbolTableReader&);
+    TSymbolTableReader& operator=(TSymbolTableReader&);
+
+    int readCount();
+    TExtension readExtension();
+    TString* readString();
+    void readSampler(TSampler&);
+    void readQualifier(TQualifier&);
+    void readConstUnion(TConstUnion&);
+    void readType(TType&);
+    void readSymbol(TSymbol&);
+    TVariable* readVariable();
+    TFunction* readFunction();
+    void readLevel(TSymbolTableLevel&);
+    TLazyFunctions* readLazyFunctions(TSymbolTableLevel&);
+
+    const char* next;
+    const char* end;
+    bool bad;
+};
+
+} // end namespace glslang
+
+#endif // _SYMBOL_TABLE_SNAPSHOT_INCLUDED_
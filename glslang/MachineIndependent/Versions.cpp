@@ -70,14 +70,14 @@
 //    However, if symbols specific to the extension are added (step 5), they will
 //    only be added under tests that the minimum version and profile are present.
 //
-// 1) Add a symbol name for the extension string at the bottom of Versions.h:
+// 1) Add a symbolic ID for the extension to the TExtension enum at the bottom of Versions.h:
 //
-//     const char* const XXX_extension_X = "XXX_extension_X";
+//     E_XXX_extension_X,
 // 
-// 2) Add extension initialization to TParseContext::initializeExtensionBehavior(),
-//    the first function below:
+// 2) Add the extension, its name, and its initial behavior to the Extensions[] table
+//    below, at the same position as its ID in the enum:
 // 
-//     extensionBehavior[XXX_extension_X] = EBhDisable;
+//     { E_XXX_extension_X, "XXX_extension_X", EBhDisable },
 //
 // 3) Add any preprocessor directives etc. in the next function, TParseContext::getPreamble():
 //
@@ -103,7 +103,7 @@
 //        profileRequires(loc, 
 //                        ECoreProfile | ECompatibilityProfile,
 //                        420,             // 0 if no version incorporated the feature into the core spec.
-//                        XXX_extension_X, // can be a list of extensions that all add the feature
+//                        E_XXX_extension_X, // can be a list of extensions that all add the feature
 //                        "Feature F Description");
 // 
 //    This allows the feature if either A) one of the extensions is enabled or
@@ -140,67 +140,134 @@
 
 #include "ParseHelper.h"
 
+using namespace glslang;
+
+namespace {
+
+//
+// Every extension the front end knows about, with its initial behavior, almost
+// always 'disable', as once their features are incorporated into a core version,
+// their features are supported through allowing that core version, not through
+// a pseudo-enablement of the extension.
+//
+// An extension's index in this table is its TExtension ID; a parse context
+// tracks the current behaviors as an array indexed by that ID.
+//
+const struct {
+    TExtension id;
+    const char* name;
+    TExtensionBehavior behavior;
+} Extensions[] = {
+    { E_GL_OES_texture_3D,                            "GL_OES_texture_3D",                           EBhDisable },
+    { E_GL_OES_standard_derivatives,                  "GL_OES_standard_derivatives",                 EBhDisable },
+    { E_GL_EXT_frag_depth,                            "GL_EXT_frag_depth",                           EBhDisable },
+    { E_GL_OES_EGL_image_external,                    "GL_OES_EGL_image_external",                   EBhDisable },
+    { E_GL_EXT_shader_texture_lod,                    "GL_EXT_shader_texture_lod",                   EBhDisable },
+
+    { E_GL_ARB_texture_rectangle,                     "GL_ARB_texture_rectangle",                    EBhDisable },
+    { E_GL_3DL_array_objects,                         "GL_3DL_array_objects",                        EBhDisable },
+    { E_GL_ARB_shading_language_420pack,              "GL_ARB_shading_language_420pack",             EBhDisable },
+    { E_GL_ARB_texture_gather,                        "GL_ARB_texture_gather",                       EBhDisable },
+    { E_GL_ARB_gpu_shader5,                           "GL_ARB_gpu_shader5",                          EBhDisablePartial },
+    { E_GL_ARB_separate_shader_objects,               "GL_ARB_separate_shader_objects",              EBhDisable },
+    { E_GL_ARB_compute_shader,                        "GL_ARB_compute_shader",                       EBhDisablePartial },
+    { E_GL_ARB_tessellation_shader,                   "GL_ARB_tessellation_shader",                  EBhDisable },
+    { E_GL_ARB_enhanced_layouts,                      "GL_ARB_enhanced_layouts",                     EBhDisable },
+    { E_GL_ARB_texture_cube_map_array,                "GL_ARB_texture_cube_map_array",               EBhDisable },
+    { E_GL_ARB_shader_texture_lod,                    "GL_ARB_shader_texture_lod",                   EBhDisable },
+    { E_GL_ARB_explicit_attrib_location,              "GL_ARB_explicit_attrib_location",             EBhDisable },
+    { E_GL_ARB_shader_image_load_store,               "GL_ARB_shader_image_load_store",              EBhDisable },
+    { E_GL_ARB_shader_atomic_counters,                "GL_ARB_shader_atomic_counters",               EBhDisable },
+    { E_GL_ARB_derivative_control,                    "GL_ARB_derivative_control",                   EBhDisable },
+    { E_GL_ARB_shader_texture_image_samples,          "GL_ARB_shader_texture_image_samples",         EBhDisable },
+    { E_GL_ARB_viewport_array,                        "GL_ARB_viewport_array",                       EBhDisable },
+//  { E_GL_ARB_cull_distance,                         "GL_ARB_cull_distance",                        EBhDisable },    // present for 4.5, but need extension control over block members
+
+    // AEP
+    { E_GL_ANDROID_extension_pack_es31a,              "GL_ANDROID_extension_pack_es31a",             EBhDisablePartial },
+    { E_GL_KHR_blend_equation_advanced,               "GL_KHR_blend_equation_advanced",              EBhDisablePartial },
+    { E_GL_OES_sample_variables,                      "GL_OES_sample_variables",                     EBhDisablePartial },
+    { E_GL_OES_shader_image_atomic,                   "GL_OES_shader_image_atomic",                  EBhDisablePartial },
+    { E_GL_OES_shader_multisample_interpolation,      "GL_OES_shader_multisample_interpolation",     EBhDisablePartial },
+    { E_GL_OES_texture_storage_multisample_2d_array,  "GL_OES_texture_storage_multisample_2d_array", EBhDisablePartial },
+    { E_GL_EXT_geometry_shader,                       "GL_EXT_geometry_shader",                      EBhDisable },
+    { E_GL_EXT_geometry_point_size,                   "GL_EXT_geometry_point_size",                  EBhDisable },
+    { E_GL_EXT_gpu_shader5,                           "GL_EXT_gpu_shader5",                          EBhDisable },
+    { E_GL_EXT_primitive_bounding_box,                "GL_EXT_primitive_bounding_box",               EBhDisablePartial },
+    { E_GL_EXT_shader_io_blocks,                      "GL_EXT_shader_io_blocks",                     EBhDisable },
+    { E_GL_EXT_tessellation_shader,                   "GL_EXT_tessellation_shader",                  EBhDisable },
+    { E_GL_EXT_tessellation_point_size,               "GL_EXT_tessellation_point_size",              EBhDisable },
+    { E_GL_EXT_texture_buffer,                        "GL_EXT_texture_buffer",                       EBhDisablePartial },
+    { E_GL_EXT_texture_cube_map_array,                "GL_EXT_texture_cube_map_array",               EBhDisablePartial },
+
+    // OES matching AEP
+    { E_GL_OES_geometry_shader,                       "GL_OES_geometry_shader",                      EBhDisable },
+    { E_GL_OES_geometry_point_size,                   "GL_OES_geometry_point_size",                  EBhDisable },
+    { E_GL_OES_gpu_shader5,                           "GL_OES_gpu_shader5",                          EBhDisable },
+    { E_GL_OES_primitive_bounding_box,                "GL_OES_primitive_bounding_box",               EBhDisablePartial },
+    { E_GL_OES_shader_io_blocks,                      "GL_OES_shader_io_blocks",                     EBhDisable },
+    { E_GL_OES_tessellation_shader,                   "GL_OES_tessellation_shader",                  EBhDisable },
+    { E_GL_OES_tessellation_point_size,               "GL_OES_tessellation_point_size",              EBhDisable },
+    { E_GL_OES_texture_buffer,                        "GL_OES_texture_buffer",                       EBhDisablePartial },
+    { E_GL_OES_texture_cube_map_array,                "GL_OES_texture_cube_map_array",               EBhDisablePartial },
+};
+
+static_assert(sizeof(Extensions) / sizeof(Extensions[0]) == NumExtensions, "NumExtensions does not match the extension table");
+
+// A single global usable by all threads, mapping an extension name to its ID.
+// After process-level initialization, this is read only and thread safe.
+std::unordered_map<const char*, int, TCharStringHash, TCharStringEqual>* ExtensionMap = 0;
+
+} // end anonymous namespace
+
 namespace glslang {
 
 //
-// Initialize all extensions, almost always to 'disable', as once their features
-// are incorporated into a core version, their features are supported through allowing that
-// core version, not through a pseudo-enablement of the extension.
+// Build the process-wide name-to-ID map.  Should be called only once per process.
 //
-void TParseContext::initializeExtensionBehavior()
+void TParseContext::fillInExtensionMap()
 {
-    extensionBehavior[E_GL_OES_texture_3D]                   = EBhDisable;
-    extensionBehavior[E_GL_OES_standard_derivatives]         = EBhDisable;
-    extensionBehavior[E_GL_EXT_frag_depth]                   = EBhDisable;
-    extensionBehavior[E_GL_OES_EGL_image_external]           = EBhDisable;
-    extensionBehavior[E_GL_EXT_shader_texture_lod]           = EBhDisable;
-                                                          
-    extensionBehavior[E_GL_ARB_texture_rectangle]            = EBhDisable;
-    extensionBehavior[E_GL_3DL_array_objects]                = EBhDisable;
-    extensionBehavior[E_GL_ARB_shading_language_420pack]     = EBhDisable;
-    extensionBehavior[E_GL_ARB_texture_gather]               = EBhDisable;
-    extensionBehavior[E_GL_ARB_gpu_shader5]                  = EBhDisablePartial;
-    extensionBehavior[E_GL_ARB_separate_shader_objects]      = EBhDisable;
-    extensionBehavior[E_GL_ARB_compute_shader]               = EBhDisablePartial;
-    extensionBehavior[E_GL_ARB_tessellation_shader]          = EBhDisable;
-    extensionBehavior[E_GL_ARB_enhanced_layouts]             = EBhDisable;
-    extensionBehavior[E_GL_ARB_texture_cube_map_array]       = EBhDisable;
-    extensionBehavior[E_GL_ARB_shader_texture_lod]           = EBhDisable;
-    extensionBehavior[E_GL_ARB_explicit_attrib_location]     = EBhDisable;
-    extensionBehavior[E_GL_ARB_shader_image_load_store]      = EBhDisable;
-    extensionBehavior[E_GL_ARB_shader_atomic_counters]       = EBhDisable;
-    extensionBehavior[E_GL_ARB_derivative_control]           = EBhDisable;
-    extensionBehavior[E_GL_ARB_shader_texture_image_samples] = EBhDisable;
-    extensionBehavior[E_GL_ARB_viewport_array]               = EBhDisable;
-//    extensionBehavior[E_GL_ARB_cull_distance]                = EBhDisable;    // present for 4.5, but need extension control over block members
+    if (ExtensionMap != 0)
+        return;
 
-    // AEP
-    extensionBehavior[E_GL_ANDROID_extension_pack_es31a]             = EBhDisablePartial;
-    extensionBehavior[E_GL_KHR_blend_equation_advanced]              = EBhDisablePartial;
-    extensionBehavior[E_GL_OES_sample_variables]                     = EBhDisablePartial;
-    extensionBehavior[E_GL_OES_shader_image_atomic]                  = EBhDisablePartial;
-    extensionBehavior[E_GL_OES_shader_multisample_interpolation]     = EBhDisablePartial;
-    extensionBehavior[E_GL_OES_texture_storage_multisample_2d_array] = EBhDisablePartial;
-    extensionBehavior[E_GL_EXT_geometry_shader]                      = EBhDisable;
-    extensionBehavior[E_GL_EXT_geometry_point_size]                  = EBhDisable;
-    extensionBehavior[E_GL_EXT_gpu_shader5]                          = EBhDisable;
-    extensionBehavior[E_GL_EXT_primitive_bounding_box]               = EBhDisablePartial;
-    extensionBehavior[E_GL_EXT_shader_io_blocks]                     = EBhDisable;
-    extensionBehavior[E_GL_EXT_tessellation_shader]                  = EBhDisable;
-    extensionBehavior[E_GL_EXT_tessellation_point_size]              = EBhDisable;
-    extensionBehavior[E_GL_EXT_texture_buffer]                       = EBhDisablePartial;
-    extensionBehavior[E_GL_EXT_texture_cube_map_array]               = EBhDisablePartial;
+    ExtensionMap = new std::unordered_map<const char*, int, TCharStringHash, TCharStringEqual>;
+    for (int e = 0; e < NumExtensions; ++e) {
+        assert(Extensions[e].id == e && "Extensions[] is out of order with TExtension");
+        (*ExtensionMap)[Extensions[e].name] = e;
+    }
+}
 
-    // OES matching AEP
-    extensionBehavior[E_GL_OES_geometry_shader]          = EBhDisable;
-    extensionBehavior[E_GL_OES_geometry_point_size]      = EBhDisable;
-    extensionBehavior[E_GL_OES_gpu_shader5]              = EBhDisable;
-    extensionBehavior[E_GL_OES_primitive_bounding_box]   = EBhDisablePartial;
-    extensionBehavior[E_GL_OES_shader_io_blocks]         = EBhDisable;
-    extensionBehavior[E_GL_OES_tessellation_shader]      = EBhDisable;
-    extensionBehavior[E_GL_OES_tessellation_point_size]  = EBhDisable;
-    extensionBehavior[E_GL_OES_texture_buffer]           = EBhDisablePartial;
-    extensionBehavior[E_GL_OES_texture_cube_map_array]   = EBhDisablePartial;
+void TParseContext::deleteExtensionMap()
+{
+    delete ExtensionMap;
+    ExtensionMap = 0;
+}
+
+//
+// Return the ID of the named extension, or -1 if it is not one we know about.
+// Only needed for names coming from the shader; internal checks already have IDs.
+//
+int TParseContext::getExtensionId(const char* extension)
+{
+    auto iter = ExtensionMap->find(extension);
+    if (iter == ExtensionMap->end())
+        return -1;
+    else
+        return iter->second;
+}
+
+const char* TParseContext::getExtensionName(TExtension extension)
+{
+    return Extensions[extension].name;
+}
+
+//
+// Initialize all extensions to the behaviors listed in the table above.
+//
+void TParseContext::initializeExtensionBehavior()
+{
+    for (int e = 0; e < NumExtensions; ++e)
+        extensionBehavior[e] = Extensions[e].behavior;
 }
 
 // Get code that is not part of a shared symbol table, is specific to this shader,
@@ -317,7 +384,7 @@ const char* StageName(EShLanguage stage)
 //
 
 // entry point that takes multiple extensions
-void TParseContext::profileRequires(TSourceLoc loc, int profileMask, int minVersion, int numExtensions, const char* const extensions[], const char* featureDesc)
+void TParseContext::profileRequires(TSourceLoc loc, int profileMask, int minVersion, int numExtensions, const TExtension extensions[], const char* featureDesc)
 {
     if (profile & profileMask) {
         bool okay = false;
@@ -326,7 +393,7 @@ void TParseContext::profileRequires(TSourceLoc loc, int profileMask, int minVers
         for (int i = 0; i < numExtensions; ++i) {
             switch (getExtensionBehavior(extensions[i])) {
             case EBhWarn:
-                infoSink.info.message(EPrefixWarning, ("extension " + TString(extensions[i]) + " is being used for " + featureDesc).c_str(), loc);
+                infoSink.info.message(EPrefixWarning, ("extension " + TString(getExtensionName(extensions[i])) + " is being used for " + featureDesc).c_str(), loc);
                 // fall through
             case EBhRequire:
             case EBhEnable:
@@ -342,9 +409,15 @@ void TParseContext::profileRequires(TSourceLoc loc, int profileMask, int minVers
 }
 
 // entry point for the above that takes a single extension
-void TParseContext::profileRequires(TSourceLoc loc, int profileMask, int minVersion, const char* extension, const char* featureDesc)
+void TParseContext::profileRequires(TSourceLoc loc, int profileMask, int minVersion, TExtension extension, const char* featureDesc)
 {
-    profileRequires(loc, profileMask, minVersion, extension ? 1 : 0, &extension, featureDesc);
+    profileRequires(loc, profileMask, minVersion, 1, &extension, featureDesc);
+}
+
+// entry point for the above when no extension adds the feature
+void TParseContext::profileRequires(TSourceLoc loc, int profileMask, int minVersion, const char* featureDesc)
+{
+    profileRequires(loc, profileMask, minVersion, 0, nullptr, featureDesc);
 }
 
 //
@@ -404,7 +477,7 @@ void TParseContext::requireNotRemoved(TSourceLoc loc, int profileMask, int remov
 // Use when there are no profile/version to check, it's just an error if one of the
 // extensions is not present.
 //
-void TParseContext::requireExtensions(TSourceLoc loc, int numExtensions, const char* const extensions[], const char* featureDesc)
+void TParseContext::requireExtensions(TSourceLoc loc, int numExtensions, const TExtension extensions[], const char* featureDesc)
 {
     // First, see if any of the extensions are enabled
     for (int i = 0; i < numExtensions; ++i) {
@@ -422,7 +495,7 @@ void TParseContext::requireExtensions(TSourceLoc loc, int numExtensions, const c
             behavior = EBhWarn;
         }
         if (behavior == EBhWarn) {
-            infoSink.info.message(EPrefixWarning, ("extension " + TString(extensions[i]) + " is being used for " + featureDesc).c_str(), loc);
+            infoSink.info.message(EPrefixWarning, ("extension " + TString(getExtensionName(extensions[i])) + " is being used for " + featureDesc).c_str(), loc);
             warned = true;
         }
     }
@@ -431,25 +504,22 @@ void TParseContext::requireExtensions(TSourceLoc loc, int numExtensions, const c
 
     // If we get this far, give errors explaining what extensions are needed
     if (numExtensions == 1)
-        error(loc, "required extension not requested:", featureDesc, extensions[0]);
+        error(loc, "required extension not requested:", featureDesc, getExtensionName(extensions[0]));
     else {
         error(loc, "required extension not requested:", featureDesc, "Possible extensions include:");
         for (int i = 0; i < numExtensions; ++i)
-            infoSink.info.message(EPrefixNone, extensions[i]);
+            infoSink.info.message(EPrefixNone, getExtensionName(extensions[i]));
     }
 }
 
-TExtensionBehavior TParseContext::getExtensionBehavior(const char* extension)
+// entry point for the above that takes a single extension
+void TParseContext::requireExtensions(TSourceLoc loc, TExtension extension, const char* featureDesc)
 {
-    auto iter = extensionBehavior.find(TString(extension));
-    if (iter == extensionBehavior.end())
-        return EBhMissing;
-    else
-        return iter->second;
+    requireExtensions(loc, 1, &extension, featureDesc);
 }
 
 // Returns true if the given extension is set to enable, require, or warn.
-bool TParseContext::extensionTurnedOn(const char* const extension)
+bool TParseContext::extensionTurnedOn(TExtension extension)
 {
       switch (getExtensionBehavior(extension)) {
       case EBhEnable:
@@ -462,7 +532,7 @@ bool TParseContext::extensionTurnedOn(const char* const extension)
       return false;
 }
 // See if any of the extensions are set to enable, require, or warn.
-bool TParseContext::extensionsTurnedOn(int numExtensions, const char* const extensions[])
+bool TParseContext::extensionsTurnedOn(int numExtensions, const TExtension extensions[])
 {
     for (int i = 0; i < numExtensions; ++i) {
         if (extensionTurnedOn(extensions[i])) return true;
@@ -494,31 +564,34 @@ void TParseContext::updateExtensionBehavior(int line, const char* extension, con
     updateExtensionBehavior(extension, behavior);
 
     // see if need to propagate to implicitly modified things
-    if (strcmp(extension, "GL_ANDROID_extension_pack_es31a") == 0) {
+    switch (getExtensionId(extension)) {
+    case E_GL_ANDROID_extension_pack_es31a:
         // to everything in AEP
-        updateExtensionBehavior(line, "GL_KHR_blend_equation_advanced", behaviorString);
-        updateExtensionBehavior(line, "GL_OES_sample_variables", behaviorString);
-        updateExtensionBehavior(line, "GL_OES_shader_image_atomic", behaviorString);
-        updateExtensionBehavior(line, "GL_OES_shader_multisample_interpolation", behaviorString);
-        updateExtensionBehavior(line, "GL_OES_texture_storage_multisample_2d_array", behaviorString);
-        updateExtensionBehavior(line, "GL_EXT_geometry_shader", behaviorString);
-        updateExtensionBehavior(line, "GL_EXT_gpu_shader5", behaviorString);
-        updateExtensionBehavior(line, "GL_EXT_primitive_bounding_box", behaviorString);
-        updateExtensionBehavior(line, "GL_EXT_shader_io_blocks", behaviorString);
-        updateExtensionBehavior(line, "GL_EXT_tessellation_shader", behaviorString);
-        updateExtensionBehavior(line, "GL_EXT_texture_buffer", behaviorString);
-        updateExtensionBehavior(line, "GL_EXT_texture_cube_map_array", behaviorString);
+        updateExtensionBehavior(E_GL_KHR_blend_equation_advanced, behavior);
+        updateExtensionBehavior(E_GL_OES_sample_variables, behavior);
+        updateExtensionBehavior(E_GL_OES_shader_image_atomic, behavior);
+        updateExtensionBehavior(E_GL_OES_shader_multisample_interpolation, behavior);
+        updateExtensionBehavior(E_GL_OES_texture_storage_multisample_2d_array, behavior);
+        updateExtensionBehavior(E_GL_EXT_geometry_shader, behavior);
+        updateExtensionBehavior(E_GL_EXT_gpu_shader5, behavior);
+        updateExtensionBehavior(E_GL_EXT_primitive_bounding_box, behavior);
+        updateExtensionBehavior(E_GL_EXT_shader_io_blocks, behavior);
+        updateExtensionBehavior(E_GL_EXT_tessellation_shader, behavior);
+        updateExtensionBehavior(E_GL_EXT_texture_buffer, behavior);
+        updateExtensionBehavior(E_GL_EXT_texture_cube_map_array, behavior);
+        break;
+    // geometry and tessellation to io_blocks
+    case E_GL_EXT_geometry_shader:
+    case E_GL_EXT_tessellation_shader:
+        updateExtensionBehavior(E_GL_EXT_shader_io_blocks, behavior);
+        break;
+    case E_GL_OES_geometry_shader:
+    case E_GL_OES_tessellation_shader:
+        updateExtensionBehavior(E_GL_OES_shader_io_blocks, behavior);
+        break;
+    default:
+        break;
     }
-    // geometry to io_blocks
-    else if (strcmp(extension, "GL_EXT_geometry_shader") == 0)
-        updateExtensionBehavior(line, "GL_EXT_shader_io_blocks", behaviorString);
-    else if (strcmp(extension, "GL_OES_geometry_shader") == 0)
-        updateExtensionBehavior(line, "GL_OES_shader_io_blocks", behaviorString);
-    // tessellation to io_blocks
-    else if (strcmp(extension, "GL_EXT_tessellation_shader") == 0)
-        updateExtensionBehavior(line, "GL_EXT_shader_io_blocks", behaviorString);
-    else if (strcmp(extension, "GL_OES_tessellation_shader") == 0)
-        updateExtensionBehavior(line, "GL_OES_shader_io_blocks", behaviorString);
 }
 
 void TParseContext::updateExtensionBehavior(const char* extension, TExtensionBehavior behavior)
@@ -530,13 +603,15 @@ void TParseContext::updateExtensionBehavior(const char* extension, TExtensionBeh
             error(getCurrentLoc(), "extension 'all' cannot have 'require' or 'enable' behavior", "#extension", "");
             return;
         } else {
-            for (auto iter = extensionBehavior.begin(); iter != extensionBehavior.end(); ++iter)
-                iter->second = behavior;
+            for (int e = 0; e < NumExtensions; ++e) {
+                if (extensionBehavior[e] != EBhMissing)
+                    extensionBehavior[e] = behavior;
+            }
         }
     } else {
         // Do the update for this single extension
-        auto iter = extensionBehavior.find(TString(extension));
-        if (iter == extensionBehavior.end()) {
+        int id = getExtensionId(extension);
+        if (id < 0 || extensionBehavior[id] == EBhMissing) {
             switch (behavior) {
             case EBhRequire:
                 error(getCurrentLoc(), "extension not supported:", "#extension", extension);
@@ -551,23 +626,27 @@ void TParseContext::updateExtensionBehavior(const char* extension, TExtensionBeh
             }
 
             return;
-        } else {
-            if (iter->second == EBhDisablePartial)
-                warn(getCurrentLoc(), "extension is only partially supported:", "#extension", extension);
-            if (behavior == EBhEnable || behavior == EBhRequire)
-                intermediate.addRequestedExtension(extension);
-            iter->second = behavior;
-        }
+        } else
+            updateExtensionBehavior(static_cast<TExtension>(id), behavior);
     }
 }
 
+void TParseContext::updateExtensionBehavior(TExtension extension, TExtensionBehavior behavior)
+{
+    if (extensionBehavior[extension] == EBhDisablePartial)
+        warn(getCurrentLoc(), "extension is only partially supported:", "#extension", getExtensionName(extension));
+    if (behavior == EBhEnable || behavior == EBhRequire)
+        intermediate.addRequestedExtension(getExtensionName(extension));
+    extensionBehavior[extension] = behavior;
+}
+
 //
 // Call for any operation needing full GLSL integer data-type support.
 //
 void TParseContext::fullIntegerCheck(TSourceLoc loc, const char* op)
 {
-    profileRequires(loc, ENoProfile, 130, nullptr, op); 
-    profileRequires(loc, EEsProfile, 300, nullptr, op);
+    profileRequires(loc, ENoProfile, 130, op); 
+    profileRequires(loc, EEsProfile, 300, op);
 }
 
 //
@@ -576,8 +655,8 @@ void TParseContext::fullIntegerCheck(TSourceLoc loc, const char* op)
 void TParseContext::doubleCheck(TSourceLoc loc, const char* op)
 {
     requireProfile(loc, ECoreProfile | ECompatibilityProfile, op);
-    profileRequires(loc, ECoreProfile, 400, nullptr, op);
-    profileRequires(loc, ECompatibilityProfile, 400, nullptr, op);
+    profileRequires(loc, ECoreProfile, 400, op);
+    profileRequires(loc, ECompatibilityProfile, 400, op);
 }
 
 } // end namespace glslang
@@ -73,6 +73,7 @@ using namespace glslang;
             bool b;
             double d;
         };
+        int atom;
         glslang::TSymbol* symbol;
     } lex;
     struct {
@@ -684,7 +685,7 @@ declaration
         $$ = $1.intermNode;
     }
     | PRECISION precision_qualifier type_specifier SEMICOLON {
-        parseContext.profileRequires($1.loc, ENoProfile, 130, 0, "precision statement");
+        parseContext.profileRequires($1.loc, ENoProfile, 130, "precision statement");
 
         // lazy setting of the previous scope's defaults, has effect only the first time it is called in a particular scope
         parseContext.symbolTable.setPreviousDefaultPrecisions(&parseContext.defaultPrecision[0]);
@@ -810,7 +811,7 @@ parameter_declarator
     : type_specifier IDENTIFIER {
         if ($1.arraySizes) {
             parseContext.profileRequires($1.loc, ENoProfile, 120, E_GL_3DL_array_objects, "arrayed type");
-            parseContext.profileRequires($1.loc, EEsProfile, 300, 0, "arrayed type");
+            parseContext.profileRequires($1.loc, EEsProfile, 300, "arrayed type");
             parseContext.arraySizeRequiredCheck($1.loc, $1.arraySizes->getOuterSize());
         }
         if ($1.basicType == EbtVoid) {
@@ -825,7 +826,7 @@ parameter_declarator
     | type_specifier IDENTIFIER array_specifier {
         if ($1.arraySizes) {
             parseContext.profileRequires($1.loc, ENoProfile, 120, E_GL_3DL_array_objects, "arrayed type");
-            parseContext.profileRequires($1.loc, EEsProfile, 300, 0, "arrayed type");
+            parseContext.profileRequires($1.loc, EEsProfile, 300, "arrayed type");
             parseContext.arraySizeRequiredCheck($1.loc, $1.arraySizes->getOuterSize());
         }
         parseContext.arrayDimCheck($2.loc, $1.arraySizes, $3.arraySizes);
@@ -954,7 +955,7 @@ fully_specified_type
         parseContext.globalQualifierTypeCheck($1.loc, $1.qualifier, $$);
         if ($1.arraySizes) {
             parseContext.profileRequires($1.loc, ENoProfile, 120, E_GL_3DL_array_objects, "arrayed type");
-            parseContext.profileRequires($1.loc, EEsProfile, 300, 0, "arrayed type");
+            parseContext.profileRequires($1.loc, EEsProfile, 300, "arrayed type");
         }
 
         parseContext.precisionQualifierCheck($$.loc, $$.basicType, $$.qualifier);
@@ -965,7 +966,7 @@ fully_specified_type
 
         if ($2.arraySizes) {
             parseContext.profileRequires($2.loc, ENoProfile, 120, E_GL_3DL_array_objects, "arrayed type");
-            parseContext.profileRequires($2.loc, EEsProfile, 300, 0, "arrayed type");
+            parseContext.profileRequires($2.loc, EEsProfile, 300, "arrayed type");
         }
 
         if ($2.arraySizes && parseContext.arrayQualifierError($2.loc, $1.qualifier))
@@ -988,7 +989,7 @@ fully_specified_type
 invariant_qualifier
     : INVARIANT {
         parseContext.globalCheck($1.loc, "invariant");
-        parseContext.profileRequires($$.loc, ENoProfile, 120, 0, "invariant");
+        parseContext.profileRequires($$.loc, ENoProfile, 120, "invariant");
         $$.init($1.loc);
         $$.qualifier.invariant = true;
     }
@@ -997,22 +998,22 @@ invariant_qualifier
 interpolation_qualifier
     : SMOOTH {
         parseContext.globalCheck($1.loc, "smooth");
-        parseContext.profileRequires($1.loc, ENoProfile, 130, 0, "smooth");
-        parseContext.profileRequires($1.loc, EEsProfile, 300, 0, "smooth");
+        parseContext.profileRequires($1.loc, ENoProfile, 130, "smooth");
+        parseContext.profileRequires($1.loc, EEsProfile, 300, "smooth");
         $$.init($1.loc);
         $$.qualifier.smooth = true;
     }
     | FLAT {
         parseContext.globalCheck($1.loc, "flat");
-        parseContext.profileRequires($1.loc, ENoProfile, 130, 0, "flat");
-        parseContext.profileRequires($1.loc, EEsProfile, 300, 0, "flat");
+        parseContext.profileRequires($1.loc, ENoProfile, 130, "flat");
+        parseContext.profileRequires($1.loc, EEsProfile, 300, "flat");
         $$.init($1.loc);
         $$.qualifier.flat = true;
     }
     | NOPERSPECTIVE {
         parseContext.globalCheck($1.loc, "noperspective");
         parseContext.requireProfile($1.loc, ~EEsProfile, "noperspective");
-        parseContext.profileRequires($1.loc, ENoProfile, 130, 0, "noperspective");
+        parseContext.profileRequires($1.loc, ENoProfile, 130, "noperspective");
         $$.init($1.loc);
         $$.qualifier.nopersp = true;
     }
@@ -1143,8 +1144,8 @@ storage_qualifier
         $$.qualifier.storage = EvqOut;
     }
     | CENTROID {
-        parseContext.profileRequires($1.loc, ENoProfile, 120, 0, "centroid");
-        parseContext.profileRequires($1.loc, EEsProfile, 300, 0, "centroid");
+        parseContext.profileRequires($1.loc, ENoProfile, 120, "centroid");
+        parseContext.profileRequires($1.loc, EEsProfile, 300, "centroid");
         parseContext.globalCheck($1.loc, "centroid");
         $$.init($1.loc);
         $$.qualifier.centroid = true;
@@ -1171,8 +1172,8 @@ storage_qualifier
         $$.qualifier.storage = EvqBuffer;
     }
     | SHARED {
-        parseContext.profileRequires($1.loc, ECoreProfile | ECompatibilityProfile, 430, 0, "shared");
-        parseContext.profileRequires($1.loc, EEsProfile, 310, 0, "shared");
+        parseContext.profileRequires($1.loc, ECoreProfile | ECompatibilityProfile, 430, "shared");
+        parseContext.profileRequires($1.loc, EEsProfile, 310, "shared");
         parseContext.requireStage($1.loc, EShLangCompute, "shared");
         $$.init($1.loc);
         $$.qualifier.storage = EvqShared;
@@ -1897,19 +1898,19 @@ type_specifier_nonarray
 
 precision_qualifier
     : HIGH_PRECISION {
-        parseContext.profileRequires($1.loc, ENoProfile, 130, 0, "highp precision qualifier");
+        parseContext.profileRequires($1.loc, ENoProfile, 130, "highp precision qualifier");
         $$.init($1.loc, parseContext.symbolTable.atGlobalLevel());
         if (parseContext.profile == EEsProfile)
 		    $$.qualifier.precision = EpqHigh;
     }
     | MEDIUM_PRECISION {
-        parseContext.profileRequires($1.loc, ENoProfile, 130, 0, "mediump precision qualifier");
+        parseContext.profileRequires($1.loc, ENoProfile, 130, "mediump precision qualifier");
         $$.init($1.loc, parseContext.symbolTable.atGlobalLevel());
         if (parseContext.profile == EEsProfile)
 	    	$$.qualifier.precision = EpqMedium;
     }
     | LOW_PRECISION {
-        parseContext.profileRequires($1.loc, ENoProfile, 130, 0, "lowp precision qualifier");
+        parseContext.profileRequires($1.loc, ENoProfile, 130, "lowp precision qualifier");
         $$.init($1.loc, parseContext.symbolTable.atGlobalLevel());
         if (parseContext.profile == EEsProfile)
     		$$.qualifier.precision = EpqLow;
@@ -1957,7 +1958,7 @@ struct_declaration
     : type_specifier struct_declarator_list SEMICOLON {
         if ($1.arraySizes) {
             parseContext.profileRequires($1.loc, ENoProfile, 120, E_GL_3DL_array_objects, "arrayed type");
-            parseContext.profileRequires($1.loc, EEsProfile, 300, 0, "arrayed type");
+            parseContext.profileRequires($1.loc, EEsProfile, 300, "arrayed type");
             if (parseContext.profile == EEsProfile)
                 parseContext.arraySizeRequiredCheck($1.loc, $1.arraySizes->getOuterSize());
         }
@@ -1976,7 +1977,7 @@ struct_declaration
         parseContext.globalQualifierFixCheck($1.loc, $1.qualifier);
         if ($2.arraySizes) {
             parseContext.profileRequires($2.loc, ENoProfile, 120, E_GL_3DL_array_objects, "arrayed type");
-            parseContext.profileRequires($2.loc, EEsProfile, 300, 0, "arrayed type");
+            parseContext.profileRequires($2.loc, EEsProfile, 300, "arrayed type");
             if (parseContext.profile == EEsProfile)
                 parseContext.arraySizeRequiredCheck($2.loc, $2.arraySizes->getOuterSize());
         }
@@ -98,7 +98,10 @@ void OutputTreeText(TInfoSink& infoSink, const TIntermNode* node, const int dept
 {
     int i;
 
-    infoSink.debug << node->getLoc().string << ":";
+    if (node->getLoc().name)
+        infoSink.debug << *node->getLoc().name << ":";
+    else
+        infoSink.debug << node->getLoc().string << ":";
     if (node->getLoc().line)
         infoSink.debug << node->getLoc().line;
     else
@@ -125,7 +125,7 @@ class TVariable;
 class TIntermediate {
 public:
     explicit TIntermediate(EShLanguage l, int v = 0, EProfile p = ENoProfile) : language(l), treeRoot(0), profile(p), version(v), 
-        numMains(0), numErrors(0), recursive(false),
+        numIncludeDirectives(0), numMains(0), numErrors(0), recursive(false),
         invocations(0), vertices(0), inputPrimitive(ElgNone), outputPrimitive(ElgNone), pixelCenterInteger(false), originUpperLeft(false),
         vertexSpacing(EvsNone), vertexOrder(EvoNone), pointMode(false), earlyFragmentTests(false), depthLayout(EldNone), xfbMode(false)
     {
@@ -147,6 +147,14 @@ public:
     EShLanguage getStage() const { return language; }
     void addRequestedExtension(const char* extension) { requestedExtensions.insert(extension); }
     const std::set<std::string>& getRequestedExtensions() const { return requestedExtensions; }
+    void addIncludedFile(const std::string& path)
+    {
+        if (std::find(includedFiles.begin(), includedFiles.end(), path) == includedFiles.end())
+            includedFiles.push_back(path);
+    }
+    const std::vector<std::string>& getIncludedFiles() const { return includedFiles; }
+    void addIncludeDirective() { ++numIncludeDirectives; }
+    int getNumIncludeDirectives() const { return numIncludeDirectives; }
 
     void setTreeRoot(TIntermNode* r) { treeRoot = r; }
     TIntermNode* getTreeRoot() const { return treeRoot; }
@@ -313,6 +321,8 @@ protected:
     EProfile profile;
     int version;
     std::set<std::string> requestedExtensions;  // cumulation of all enabled or required extensions; not connected to what subset of the shader used them
+    std::vector<std::string> includedFiles;     // files brought in by #include, in order of first inclusion
+    int numIncludeDirectives;                   // #include directives processed, including ones that failed
     TBuiltInResource resources;
     int numMains;
     int numErrors;
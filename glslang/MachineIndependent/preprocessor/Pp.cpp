@@ -243,17 +243,11 @@ int TPpContext::CPPelse(int matchelse, TPpToken* ppToken)
 {
     int atom;
     int depth = 0;
-    int token = scanToken(ppToken);
+    int token = skipDisabledLines(ppToken, '\n');
 
     while (token != EOF) {
         if (token != '#') {
-            while (token != '\n' && token != EOF)
-                token = scanToken(ppToken);
-            
-            if (token == EOF)
-                return EOF;
-
-            token = scanToken(ppToken);
+            token = skipDisabledLines(ppToken, token);
             continue;
         }
 
@@ -311,6 +305,25 @@ int TPpContext::CPPelse(int matchelse, TPpToken* ppToken)
     return token;
 }
 
+//
+// Skip the rest of the line 'token' is on (nothing, if it's a '\n'), then lines up
+// to one starting with '#', returning that '#', or EOF.  Source text is skipped
+// without being tokenized; only recorded tokens, as from an #include, are read
+// one by one.
+//
+int TPpContext::skipDisabledLines(TPpToken* ppToken, int token)
+{
+    bool lineStart = token == '\n';
+    for (;;) {
+        if (! inputStack.empty() && inputStack.back()->skipToDirective(lineStart))
+            lineStart = true;
+        token = scanToken(ppToken);
+        if (token == EOF || (token == '#' && lineStart))
+            return token;
+        lineStart = token == '\n';
+    }
+}
+
 // Call when there should be no more tokens left on a line.
 int TPpContext::extraTokenCheck(int atom, TPpToken* ppToken, int token)
 {
@@ -784,6 +797,51 @@ int TPpContext::CPPextension(TPpToken* ppToken)
     return token;
 }
 
+// Handle #include
+int TPpContext::CPPinclude(TPpToken* ppToken)
+{
+    // counted before anything can fail, as a failure depends on the file system too
+    parseContext.intermediate.addIncludeDirective();
+
+    TSourceLoc loc = ppToken->loc;
+    int token = scanToken(ppToken);
+    if (token != PpAtomConstString) {
+        parseContext.ppError(loc, "must be followed by a file name in quotes", "#include", "");
+        return token;
+    }
+
+    std::string name = ppToken->name;
+    token = scanToken(ppToken);
+    if (token != '\n' && token != EOF) {
+        parseContext.ppError(ppToken->loc, "extra tokens -- expected newline", "#include", "");
+        return token;
+    }
+
+    if (includer == nullptr) {
+        parseContext.ppError(loc, "not supported without an includer:", "#include", name.c_str());
+        return token;
+    }
+    if (includeDepth >= maxIncludeDepth) {
+        parseContext.ppError(loc, "too deeply nested:", "#include", name.c_str());
+        return token;
+    }
+
+    std::string path;
+    std::string contents;
+    const char* includerPath = includePaths.empty() ? "" : includePaths.back().c_str();
+    if (! includer->include(name.c_str(), includerPath, path, contents)) {
+        parseContext.ppError(loc, "could not find file:", "#include", name.c_str());
+        return token;
+    }
+    parseContext.intermediate.addIncludedFile(path);
+
+    // The rest of the directive's line is consumed, so the file's tokens come next,
+    // starting a new line, even if the #include ended its own source.
+    pushInput(new tIncludeInput(this, TokenizeIncludedFile(path, contents, loc), loc));
+
+    return '\n';
+}
+
 int TPpContext::readCPPline(TPpToken* ppToken)
 {
     int token = scanToken(ppToken);
@@ -849,6 +907,9 @@ int TPpContext::readCPPline(TPpToken* ppToken)
         case PpAtomExtension:
             token = CPPextension(ppToken);
             break;
+        case PpAtomInclude:
+            token = CPPinclude(ppToken);
+            break;
         default:
             parseContext.ppError(ppToken->loc, "invalid directive:", "#", ppToken->name);
             break;
@@ -876,8 +937,8 @@ TPpContext::TokenStream* TPpContext::PrescanMacroArg(TokenStream* a, TPpToken* p
     if (token == tInput::endOfInput)
         return a;
 
-    n = new TokenStream;
-    pushInput(new tMarkerInput(this));
+    n = NewTokenStream();
+    pushInput(markerInputs.get(this));
     pushTokenStreamInput(a);
     while ((token = scanToken(ppToken)) != tMarkerInput::marker) {
         if (token == PpAtomIdentifier && MacroExpand(ppToken->atom, ppToken, false, newLineOkay) != 0)
@@ -885,7 +946,7 @@ TPpContext::TokenStream* TPpContext::PrescanMacroArg(TokenStream* a, TPpToken* p
         RecordToken(n, token, ppToken);
     }
     popInput();
-    delete a;
+    ReleaseTokenStream(a);
 
     return n;
 }
@@ -919,13 +980,29 @@ int TPpContext::tMacroInput::scan(TPpToken* ppToken)
     return token;
 }
 
+void TPpContext::tMacroInput::release()
+{
+    for (size_t i = 0; i < args.size(); ++i)
+        pp->ReleaseTokenStream(args[i]);
+    args.clear();
+    mac = 0;
+    done = false;
+    pp->macroInputs.put(this);
+}
+
+void TPpContext::tMarkerInput::release()
+{
+    done = false;
+    pp->markerInputs.put(this);
+}
+
 // return a zero, for scanning a macro that was never defined
 int TPpContext::tZeroInput::scan(TPpToken* ppToken)
 {
     if (done)
         return endOfInput;
 
-    strcpy(ppToken->name, "0");
+    ppToken->name = "0";
     ppToken->ival = 0;
     ppToken->space = false;
     done = true;
@@ -933,6 +1010,12 @@ int TPpContext::tZeroInput::scan(TPpToken* ppToken)
     return PpAtomConstInt;
 }
 
+void TPpContext::tZeroInput::release()
+{
+    done = false;
+    pp->zeroInputs.put(this);
+}
+
 //
 // Check an identifier (atom) to see if it is a macro that should be expanded.
 // If it is, and defined, push a tInput that will produce the appropriate expansion
@@ -943,23 +1026,25 @@ int TPpContext::tZeroInput::scan(TPpToken* ppToken)
 //
 int TPpContext::MacroExpand(int atom, TPpToken* ppToken, bool expandUndef, bool newLineOkay)
 {
+    char spelling[16];
+
     ppToken->space = false;
     switch (atom) {
     case PpAtomLineMacro:
-        ppToken->ival = parseContext.getCurrentLoc().line;
-        sprintf(ppToken->name, "%d", ppToken->ival);
+        ppToken->ival = getCurrentLoc().line;
+        ppToken->name = SaveSpelling(spelling, sprintf(spelling, "%d", ppToken->ival));
         UngetToken(PpAtomConstInt, ppToken);
         return 1;
 
     case PpAtomFileMacro:
-        ppToken->ival = parseContext.getCurrentLoc().string;
-        sprintf(ppToken->name, "%d", ppToken->ival);
+        ppToken->ival = getCurrentLoc().string;
+        ppToken->name = SaveSpelling(spelling, sprintf(spelling, "%d", ppToken->ival));
         UngetToken(PpAtomConstInt, ppToken);
         return 1;
 
     case PpAtomVersionMacro:
         ppToken->ival = parseContext.version;
-        sprintf(ppToken->name, "%d", ppToken->ival);
+        ppToken->name = SaveSpelling(spelling, sprintf(spelling, "%d", ppToken->ival));
         UngetToken(PpAtomConstInt, ppToken);
         return 1;
 
@@ -981,11 +1066,11 @@ int TPpContext::MacroExpand(int atom, TPpToken* ppToken, bool expandUndef, bool
 
     // 0 is the value of an undefined macro
     if ((! sym || sym->mac.undef) && expandUndef) {
-        pushInput(new tZeroInput(this));
+        pushInput(zeroInputs.get(this));
         return -1;
     }
 
-    tMacroInput *in = new tMacroInput(this);
+    tMacroInput *in = macroInputs.get(this);
 
     TSourceLoc loc = ppToken->loc;  // in case we go to the next line before discovering the error
     in->mac = &sym->mac;
@@ -1000,12 +1085,12 @@ int TPpContext::MacroExpand(int atom, TPpToken* ppToken, bool expandUndef, bool
             UngetToken(token, ppToken);
             ppToken->atom = atom;
 
-            delete in;
+            in->release();
             return 0;
         }
         in->args.resize(in->mac->argc);
         for (int i = 0; i < in->mac->argc; i++)
-            in->args[i] = new TokenStream;
+            in->args[i] = NewTokenStream();
         int arg = 0;
         bool tokenRecorded = false;
         do {
@@ -1014,20 +1099,20 @@ int TPpContext::MacroExpand(int atom, TPpToken* ppToken, bool expandUndef, bool
                 token = scanToken(ppToken);
                 if (token == EOF) {
                     parseContext.ppError(loc, "EOF in macro", "macro expansion", GetAtomString(atom));
-                    delete in;
+                    in->release();
                     return 0;
                 }
                 if (token == '\n') {
                     if (! newLineOkay) {
                         parseContext.ppError(loc, "end of line in macro substitution:", "macro expansion", GetAtomString(atom));
-                        delete in;
+                        in->release();
                         return 0;
                     }
                     continue;
                 }
                 if (token == '#') {
                     parseContext.ppError(ppToken->loc, "unexpected '#'", "macro expansion", GetAtomString(atom));
-                    delete in;
+                    in->release();
                     return 0;
                 }
                 if (in->mac->argc == 0 && token != ')')
@@ -1064,7 +1149,7 @@ int TPpContext::MacroExpand(int atom, TPpToken* ppToken, bool expandUndef, bool
 
             if (token == EOF) {
                 parseContext.ppError(loc, "EOF in macro", "macro expansion", GetAtomString(atom));
-                delete in;
+                in->release();
                 return 0;
             }
             parseContext.ppError(loc, "Too many args in macro", "macro expansion", GetAtomString(atom));
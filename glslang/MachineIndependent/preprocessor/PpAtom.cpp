@@ -86,6 +86,9 @@ NVIDIA HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "PpContext.h"
 #include "PpTokens.h"
@@ -110,6 +113,7 @@ const struct {
     { PpAtomLine,           "line" },
     { PpAtomPragma,         "pragma" },
     { PpAtomError,          "error" },
+    { PpAtomInclude,        "include" },
 
     { PpAtomVersion,        "version" },
     { PpAtomCore,           "core" },
@@ -122,15 +126,132 @@ const struct {
     { PpAtomVersionMacro,    "__VERSION__" },
 };
 
+// A single global usable by all threads, holding the atoms every compile
+// starts with:  the fixed preprocessor tokens above, the scanner's keywords,
+// and the names the built-ins declare.  After process-level initialization,
+// this is read only and thread safe.  The shared symbol table levels are
+// keyed by these atoms, so compiles look up built-ins by the atoms their
+// identifiers already have.
+std::unordered_map<const char*, int, TCharStringHash, TCharStringEqual>* SharedAtomMap = 0;
+std::vector<const char*>* SharedStringMap = 0;
+std::vector<char*>* SharedNameCopies = 0;   // backing store for AddSharedName()
+
+// backing store for the single-character atoms
+const char SingleCharTokens[] = "~!%^&*()-+=|,.<>/?;:[]{}#";
+char SingleCharStrings[sizeof(SingleCharTokens)][2];
+
 } // end anonymous namespace
 
 namespace glslang {
 
+//
+// Build the process-wide atom table.  Should be called only once per process.
+//
+void TPpContext::InitSharedAtomTable()
+{
+    if (SharedAtomMap != 0)
+        return;
+
+    SharedAtomMap = new std::unordered_map<const char*, int, TCharStringHash, TCharStringEqual>;
+    SharedStringMap = new std::vector<const char*>(PpAtomLast, 0);
+    SharedNameCopies = new std::vector<char*>;
+
+    // Add single character tokens to the atom table:
+    for (int ii = 0; SingleCharTokens[ii]; ++ii) {
+        SingleCharStrings[ii][0] = SingleCharTokens[ii];
+        SingleCharStrings[ii][1] = '\0';
+        (*SharedAtomMap)[SingleCharStrings[ii]] = SingleCharTokens[ii];
+        (*SharedStringMap)[SingleCharTokens[ii]] = SingleCharStrings[ii];
+    }
+
+    // Add multiple character scanner tokens :
+    for (int ii = 0; ii < sizeof(tokens)/sizeof(tokens[0]); ii++) {
+        (*SharedAtomMap)[tokens[ii].str] = tokens[ii].val;
+        (*SharedStringMap)[tokens[ii].val] = tokens[ii].str;
+    }
+}
+
+//
+// Add a string to the process-wide atom table, returning its atom.  Only for
+// use during process-level initialization, after InitSharedAtomTable().
+//
+int TPpContext::AddSharedAtom(const char* s)
+{
+    auto it = SharedAtomMap->find(s);
+    if (it != SharedAtomMap->end())
+        return it->second;
+
+    int atom = (int)SharedStringMap->size();
+    (*SharedAtomMap)[s] = atom;
+    SharedStringMap->push_back(s);
+
+    return atom;
+}
+
+//
+// Same, but for a string that need not outlive the call, and need not be
+// null terminated.
+//
+int TPpContext::AddSharedName(const char* s, size_t length)
+{
+    std::string name(s, length);
+    int atom = LookUpSharedAtom(name.c_str());
+    if (atom != 0)
+        return atom;
+
+    char* copy = new char[length + 1];
+    memcpy(copy, name.c_str(), length + 1);
+    SharedNameCopies->push_back(copy);
+
+    return AddSharedAtom(copy);
+}
+
+int TPpContext::LookUpSharedAtom(const char* s)
+{
+    auto it = SharedAtomMap->find(s);
+
+    return it == SharedAtomMap->end() ? 0 : it->second;
+}
+
+bool TPpContext::IsSharedAtom(int atom)
+{
+    return atom > 0 && (size_t)atom < SharedStringMap->size();
+}
+
+int TPpContext::GetSharedAtomCount()
+{
+    return (int)SharedStringMap->size();
+}
+
+// Returns 0 for the unused atoms below PpAtomLast.
+const char* TPpContext::GetSharedAtomString(int atom)
+{
+    return (*SharedStringMap)[atom];
+}
+
+void TPpContext::DeleteSharedAtomTable()
+{
+    delete SharedAtomMap;
+    SharedAtomMap = 0;
+    delete SharedStringMap;
+    SharedStringMap = 0;
+    if (SharedNameCopies) {
+        for (size_t n = 0; n < SharedNameCopies->size(); ++n)
+            delete [] (*SharedNameCopies)[n];
+    }
+    delete SharedNameCopies;
+    SharedNameCopies = 0;
+}
+
 //
 // Map a new or existing string to an atom, inventing a new atom if necessary.
 //
 int TPpContext::LookUpAddString(const char* s)
 {
+    auto shared = SharedAtomMap->find(s);
+    if (shared != SharedAtomMap->end())
+        return shared->second;
+
     auto it = atomMap.find(s);
     if (it == atomMap.end()) {
         AddAtomFixed(s, nextAtom);
@@ -139,6 +260,17 @@ int TPpContext::LookUpAddString(const char* s)
         return it->second;
 }
 
+int TPpContext::LookUpString(const char* s) const
+{
+    auto shared = SharedAtomMap->find(s);
+    if (shared != SharedAtomMap->end())
+        return shared->second;
+
+    auto it = atomMap.find(s);
+
+    return it == atomMap.end() ? 0 : it->second;
+}
+
 //
 // Map an already created atom to its string.
 //
@@ -148,6 +280,12 @@ const char* TPpContext::GetAtomString(int atom)
         return "<null atom>";
     if (atom < 0)
         return "<EOF>";
+    if ((size_t)atom < SharedStringMap->size()) {
+        if ((*SharedStringMap)[atom] == 0)
+            return "<invalid atom>";
+        else
+            return (*SharedStringMap)[atom];
+    }
     if ((size_t)atom < stringMap.size()) {
         if (stringMap[atom] == 0)
             return "<invalid atom>";
@@ -170,26 +308,12 @@ void TPpContext::AddAtomFixed(const char* s, int atom)
 }
 
 //
-// Initialize the atom table.
+// Initialize the atom table.  Everything up through the scanner's keywords is
+// already in the shared table, so this context only numbers what follows.
 //
 void TPpContext::InitAtomTable()
 {
-    // Add single character tokens to the atom table:
-    const char* s = "~!%^&*()-+=|,.<>/?;:[]{}#";
-    char t[2];
-
-    t[1] = '\0';
-    while (*s) {
-        t[0] = *s;
-        AddAtomFixed(t, s[0]);
-        s++;
-    }
-
-    // Add multiple character scanner tokens :
-    for (int ii = 0; ii < sizeof(tokens)/sizeof(tokens[0]); ii++)
-        AddAtomFixed(tokens[ii].str, tokens[ii].val);
-
-    nextAtom = PpAtomLast;
+    nextAtom = (int)SharedStringMap->size();
 }
 
 } // end namespace glslang
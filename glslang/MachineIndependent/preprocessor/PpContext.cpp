@@ -83,8 +83,8 @@ NVIDIA HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace glslang {
 
-TPpContext::TPpContext(TParseContext& pc) : 
-    preamble(0), strings(0), parseContext(pc), inComment(false)
+TPpContext::TPpContext(TParseContext& pc, TShader::Includer* inc) : 
+    preamble(0), strings(0), parseContext(pc), includer(inc), includeDepth(0), inComment(false)
 {
     InitAtomTable();
     InitScanner();
@@ -105,6 +105,10 @@ TPpContext::~TPpContext()
     // free up the inputStack
     while (! inputStack.empty())
         popInput();
+
+    // the free lists of inputs delete themselves, but not these
+    for (size_t i = 0; i < freeTokenStreams.size(); ++i)
+        delete freeTokenStreams[i];
 }
 
 void TPpContext::setInput(TInputScanner& input, bool versionWillBeError)
@@ -78,6 +78,7 @@ NVIDIA HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef PPCONTEXT_H
 #define PPCONTEXT_H
 
+#include <memory>
 #include <unordered_map>
 
 #include "../ParseHelper.h"
@@ -88,10 +89,9 @@ namespace glslang {
 
 class TPpToken {
 public:
-    TPpToken() : token(0), space(false), ival(0), dval(0.0), atom(0)
+    TPpToken() : token(0), space(false), ival(0), dval(0.0), atom(0), name("")
     {
         loc.init(); 
-        name[0] = 0;
     }
 
     bool operator==(const TPpToken& right)
@@ -110,23 +110,52 @@ public:
     int    ival;
     double dval;
     int    atom;
-    char   name[maxTokenLength+1];
+    const char* name;  // spelling of an identifier, number, or string; not owned, and valid for the whole compile
 };
 
 class TInputScanner;
+struct TIncludedFile;
 
 // This class is the result of turning a huge pile of C code communicating through globals
 // into a class.  This was done to allowing instancing to attain thread safety.
 // Don't expect too much in terms of OO design.
 class TPpContext {
 public:
-    TPpContext(TParseContext&);
+    TPpContext(TParseContext&, TShader::Includer* = nullptr);
     virtual ~TPpContext();
 
     void setPreamble(const char* preamble, size_t length);
 
     const char* tokenize(TPpToken* ppToken);
 
+    // For output that keeps to the lines of the shader's strings:  where the
+    // outermost #include of the file a token came from is, if it came from one.
+    const TSourceLoc& getIncludeDirectiveLoc() const { return includeDirectiveLoc; }
+
+    // Process-wide atom table, built by ShInitialize() and read only after that.
+    // AddSharedAtom() keeps the pointer it is given, so pass a string literal;
+    // AddSharedName() keeps a copy.  LookUpSharedAtom() gives 0 for a string
+    // not in the table.
+    static void InitSharedAtomTable();
+    static int AddSharedAtom(const char* s);
+    static int AddSharedName(const char* s, size_t length);
+    static int LookUpSharedAtom(const char* s);
+    static bool IsSharedAtom(int atom);
+    static int GetSharedAtomCount();
+    static const char* GetSharedAtomString(int atom);
+    static void DeleteSharedAtomTable();
+
+    // This context's atom for a string:  the shared one, else one numbered
+    // above the shared ones for this context alone.  LookUpString() gives 0
+    // instead of adding a new one.
+    int LookUpAddString(const char* s);
+    int LookUpString(const char* s) const;
+
+    // Process-wide cache of the tokens of files brought in by #include,
+    // created by ShInitialize() and safe to use from any thread after that.
+    static void InitIncludeCache();
+    static void DeleteIncludeCache();
+
     class tInput {
     public:
         tInput(TPpContext* p) : done(false), pp(p) { }
@@ -136,6 +165,16 @@ public:
         virtual int getch() = 0;
         virtual void ungetch() = 0;
 
+        // Called once the input is popped.  The kinds of input made for every
+        // macro expansion or ungot token go back to a free list instead.
+        virtual void release() { delete this; }
+
+        // For the disabled part of an #if: move past the rest of the current
+        // line (unless at a line start) and any following lines, up to the
+        // '#' of the next line that starts with one.  Returns false if this
+        // input can't skip without tokenizing, having moved nowhere.
+        virtual bool skipToDirective(bool /*lineStart*/) { return false; }
+
         static const int endOfInput = -2;
 
     protected:
@@ -143,6 +182,28 @@ public:
         TPpContext* pp;
     };
 
+    // Released inputs of one kind, waiting to be reused by this context.
+    template<class T> class tInputFreeList {
+    public:
+        ~tInputFreeList()
+        {
+            for (size_t i = 0; i < inputs.size(); ++i)
+                delete inputs[i];
+        }
+        T* get(TPpContext* pp)
+        {
+            if (inputs.empty())
+                return new T(pp);
+            T* in = inputs.back();
+            inputs.pop_back();
+
+            return in;
+        }
+        void put(T* in) { inputs.push_back(in); }
+    protected:
+        std::vector<T*> inputs;
+    };
+
     void setInput(TInputScanner& input, bool versionWillBeError);
 
     void pushInput(tInput* in)
@@ -151,13 +212,30 @@ public:
     }
     void popInput()
     {
-        delete inputStack.back();
+        inputStack.back()->release();
         inputStack.pop_back();
     }
 
+    // A recorded stream of tokens, e.g., a macro body or argument.  Tokens are
+    // kept already decoded, so playing them back needs no re-atomizing of
+    // identifiers or re-parsing of numbers.  Identifiers are spelled by their
+    // atom; numbers and strings keep their value and spelling off to the side,
+    // so the common token stays small.
     struct TokenStream {
+        struct Token {
+            int token;
+            int value;   // atom for an identifier, index into 'literals' for a number or string
+            bool space;
+        };
+        struct Literal {
+            double dval;
+            int ival;
+            const char* name;   // the token's spelling, which outlives the stream
+        };
+
         TokenStream() : current(0) { }
-        TVector<unsigned char> data;
+        TVector<Token> data;
+        TVector<Literal> literals;
         size_t current;
     };
 
@@ -242,7 +320,7 @@ protected:
 
     class tMacroInput : public tInput {
     public:
-        tMacroInput(TPpContext* pp) : tInput(pp) { }
+        tMacroInput(TPpContext* pp) : tInput(pp), mac(0) { }
         virtual ~tMacroInput()
         {
             for (size_t i = 0; i < args.size(); ++i)
@@ -252,6 +330,7 @@ protected:
         virtual int scan(TPpToken*);
         virtual int getch() { assert(0); return endOfInput; }
         virtual void ungetch() { assert(0); }
+        virtual void release();
         MacroSymbol *mac;
         TVector<TokenStream*> args;
     };
@@ -269,6 +348,7 @@ protected:
         }
         virtual int getch() { assert(0); return endOfInput; }
         virtual void ungetch() { assert(0); }
+        virtual void release();
         static const int marker = -3;
     };
 
@@ -278,12 +358,53 @@ protected:
         virtual int scan(TPpToken*);
         virtual int getch() { assert(0); return endOfInput; }
         virtual void ungetch() { assert(0); }
+        virtual void release();
     };
 
+    tInputFreeList<tMacroInput> macroInputs;
+    tInputFreeList<tMarkerInput> markerInputs;
+    tInputFreeList<tZeroInput> zeroInputs;
+
     std::vector<tInput*> inputStack;
     bool errorOnVersion;
     bool versionSeen;
 
+    // Replays the cached tokens of an included file.  Identifiers are mapped to
+    // this context's atoms once per inclusion, not once per token.  The file's
+    // tokens are located by its path and their line in it, within the string of
+    // the outermost #include.
+    class tIncludeInput : public tInput {
+    public:
+        tIncludeInput(TPpContext* pp, std::shared_ptr<const TIncludedFile> file, const TSourceLoc& loc);
+        virtual ~tIncludeInput()
+        {
+            --pp->includeDepth;
+            pp->includeLoc = includerLoc;
+            pp->includePaths.pop_back();
+        }
+        virtual int scan(TPpToken*);
+        virtual int getch() { assert(0); return endOfInput; }
+        virtual void ungetch() { assert(0); }
+    protected:
+        const TIncludedFile* file;
+        TVector<int> atoms;     // this context's atom for each of the file's identifiers
+        size_t current;
+        TSourceLoc loc;         // of the token last replayed
+        TSourceLoc includerLoc; // to go back to when done
+    };
+
+    // Location for tokens being produced, including replayed macro tokens;
+    // inside an included file, this is the last token replayed from it.
+    const TSourceLoc& getCurrentLoc() const { return includeDepth > 0 ? includeLoc : parseContext.getCurrentLoc(); }
+
+    TShader::Includer* includer;
+    static const int maxIncludeDepth = 64;
+    int includeDepth;           // current nesting of #include
+    TSourceLoc includeLoc;      // the last token replayed from an included file, while includeDepth > 0
+    TSourceLoc includeDirectiveLoc; // the outermost #include, while includeDepth > 0
+    std::vector<std::string> includePaths;  // of the files being replayed, innermost last
+    std::vector<std::shared_ptr<const TIncludedFile> > includedFiles;  // held for the whole compile, as tokens point into them
+
     //
     // from Pp.cpp
     //
@@ -293,6 +414,7 @@ protected:
     int CPPdefine(TPpToken * ppToken);
     int CPPundef(TPpToken * ppToken);
     int CPPelse(int matchelse, TPpToken * ppToken);
+    int skipDisabledLines(TPpToken* ppToken, int token);
     int extraTokenCheck(int atom, TPpToken* ppToken, int token);
     int eval(int token, int precedence, bool shortCircuit, int& res, bool& err, TPpToken * ppToken);
     int evalToToken(int token, bool shortCircuit, int& res, bool& err, TPpToken * ppToken);
@@ -303,6 +425,7 @@ protected:
     int CPPpragma(TPpToken * ppToken);
     int CPPversion(TPpToken * ppToken);
     int CPPextension(TPpToken * ppToken);
+    int CPPinclude(TPpToken * ppToken);
     int readCPPline(TPpToken * ppToken);
     TokenStream* PrescanMacroArg(TokenStream *a, TPpToken * ppToken, bool newLineOkay);
     int MacroExpand(int atom, TPpToken* ppToken, bool expandUndef, bool newLineOkay);
@@ -317,36 +440,45 @@ protected:
     //
     // From PpTokens.cpp
     //
-    void lAddByte(TokenStream *fTok, unsigned char fVal);
-    int lReadByte(TokenStream *pTok);
-    void lUnreadByte(TokenStream *pTok);
     void RecordToken(TokenStream* pTok, int token, TPpToken* ppToken);
     void RewindTokenStream(TokenStream *pTok);
     int ReadToken(TokenStream* pTok, TPpToken* ppToken);
     void pushTokenStreamInput(TokenStream *ts);
+    TokenStream* NewTokenStream();
+    void ReleaseTokenStream(TokenStream* pTok);
+    std::string IncludeCacheKey(const std::string& path);
+    std::shared_ptr<const TIncludedFile> TokenizeIncludedFile(const std::string& path, const std::string& contents, const TSourceLoc& loc);
     void UngetToken(int token, TPpToken* ppToken);
     
     class tTokenInput : public tInput {
     public:
-        tTokenInput(TPpContext* pp, TokenStream* t) : tInput(pp), tokens(t) { }
+        tTokenInput(TPpContext* pp) : tInput(pp), tokens(0) { }
+        void reset(TokenStream* t) { tokens = t; }
         virtual int scan(TPpToken *);
         virtual int getch() { assert(0); return endOfInput; }
         virtual void ungetch() { assert(0); }
+        virtual void release();
     protected:
         TokenStream *tokens;
     };
 
     class tUngotTokenInput : public tInput {
     public:
-        tUngotTokenInput(TPpContext* pp, int t, TPpToken* p) : tInput(pp), token(t), lval(*p) { }
+        tUngotTokenInput(TPpContext* pp) : tInput(pp), token(0) { }
+        void reset(int t, const TPpToken* p) { token = t; lval = *p; }
         virtual int scan(TPpToken *);
         virtual int getch() { assert(0); return endOfInput; }
         virtual void ungetch() { assert(0); }
+        virtual void release();
     protected:
         int token;
         TPpToken lval;
     };
 
+    tInputFreeList<tTokenInput> tokenInputs;
+    tInputFreeList<tUngotTokenInput> ungotTokenInputs;
+    std::vector<TokenStream*> freeTokenStreams;     // macro argument streams, emptied for reuse
+
     //
     // From PpScanner.cpp
     //
@@ -354,6 +486,7 @@ protected:
     public:
         tStringInput(TPpContext* pp, TInputScanner& i) : tInput(pp), input(&i) { }
         virtual int scan(TPpToken*);
+        virtual bool skipToDirective(bool lineStart);
 
         // Scanner used to get source stream characters.
         //  - Escaped newlines are handled here, invisibly to the caller.
@@ -366,7 +499,7 @@ protected:
                 // Move past escaped newlines, as many as sequentially exist
                 do {
                     if (input->peek() == '\r' || input->peek() == '\n') {
-                        bool allowed = pp->parseContext.lineContinuationCheck(input->getSourceLoc(), pp->inComment);
+                        bool allowed = pp->parseContext.lineContinuationCheck(pp->getCurrentLoc(), pp->inComment);
                         if (! allowed && pp->inComment)
                             return '\\';
 
@@ -423,6 +556,9 @@ protected:
         }
 
     protected:
+        int skipRestOfLine(int ch);
+        int skipBlockComment();
+
         TInputScanner* input;
     };
 
@@ -430,12 +566,18 @@ protected:
     int ScanFromString(char* s);
     void missingEndifCheck();
     int lFloatConst(int len, int ch, TPpToken* ppToken);
+    const char* SaveSpelling(const char* text, int length);
 
     bool inComment;
+    char tokenText[TPpToken::maxTokenLength + 1];  // where the scanner builds up a token's spelling
 
     //
     // From PpAtom.cpp
     //
+    // Atoms shared by all contexts come from the process-wide table; this
+    // context's map only holds the names first seen in this compile, numbered
+    // above the shared ones.
+    //
     typedef TUnorderedMap<TString, int> TAtomMap;
     typedef TVector<const TString*> TStringMap;
     TAtomMap atomMap;
@@ -443,7 +585,6 @@ protected:
     int nextAtom;
     void InitAtomTable();
     void AddAtomFixed(const char* s, int atom);
-    int LookUpAddString(const char* s);
     const char* GetAtomString(int atom);
 
     //
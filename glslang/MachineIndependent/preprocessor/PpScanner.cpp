@@ -103,6 +103,20 @@ int TPpContext::InitScanner()
     return 1;
 }
 
+//
+// Keep the spelling of a scanned number or string for the rest of the compile,
+// so tokens can point to it instead of carrying a copy.  It is pool memory,
+// freed with everything else when the compile is done.
+//
+const char* TPpContext::SaveSpelling(const char* text, int length)
+{
+    char* spelling = reinterpret_cast<char*>(GetThreadPoolAllocator().allocate(length + 1));
+    memcpy(spelling, text, length);
+    spelling[length] = '\0';
+
+    return spelling;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////// Floating point constants: /////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////
@@ -123,7 +137,7 @@ int TPpContext::lFloatConst(int len, int ch, TPpToken* ppToken)
     declen = 0;
 
     str_len=len;
-    char* str = ppToken->name;
+    char* str = tokenText;
     if (ch == '.') {
         HasDecimalOrExponent = true;
         str[len++] = (char)ch;
@@ -182,7 +196,7 @@ int TPpContext::lFloatConst(int len, int ch, TPpToken* ppToken)
 
     if (len == 0) {
         ppToken->dval = 0.0;
-        strcpy(str, "0.0");
+        ppToken->name = "0.0";
     } else {
         if (ch == 'l' || ch == 'L') {
             parseContext.doubleCheck(ppToken->loc, "double floating-point suffix");
@@ -203,9 +217,9 @@ int TPpContext::lFloatConst(int len, int ch, TPpToken* ppToken)
                 }
             }
         } else if (ch == 'f' || ch == 'F') {
-            parseContext.profileRequires(ppToken->loc,  EEsProfile, 300, nullptr, "floating-point suffix");
+            parseContext.profileRequires(ppToken->loc,  EEsProfile, 300, "floating-point suffix");
             if (! parseContext.relaxedErrors())
-                parseContext.profileRequires(ppToken->loc, ~EEsProfile, 120, nullptr, "floating-point suffix");
+                parseContext.profileRequires(ppToken->loc, ~EEsProfile, 120, "floating-point suffix");
             if (! HasDecimalOrExponent)
                 parseContext.ppError(ppToken->loc, "float literal needs a decimal point or exponent", "", "");
             if (len < TPpToken::maxTokenLength)
@@ -220,6 +234,7 @@ int TPpContext::lFloatConst(int len, int ch, TPpToken* ppToken)
         str[len]='\0';
 
         ppToken->dval = strtod(str, nullptr);
+        ppToken->name = SaveSpelling(str, len);
     }
 
     if (isDouble)
@@ -233,7 +248,7 @@ int TPpContext::lFloatConst(int len, int ch, TPpToken* ppToken)
 //
 int TPpContext::tStringInput::scan(TPpToken* ppToken)
 {
-    char* tokenText = ppToken->name;
+    char* tokenText = pp->tokenText;
     int AlreadyComplained = 0;
     int len = 0;
     int ch = 0;
@@ -249,7 +264,7 @@ int TPpContext::tStringInput::scan(TPpToken* ppToken)
             ch = pp->getChar();
         }
 
-        ppToken->loc = pp->parseContext.getCurrentLoc();
+        ppToken->loc = pp->getCurrentLoc();
         len = 0;
         switch (ch) {
         default:
@@ -294,15 +309,16 @@ int TPpContext::tStringInput::scan(TPpToken* ppToken)
             tokenText[len] = '\0';
             pp->ungetChar();
             ppToken->atom = pp->LookUpAddString(tokenText);
+            ppToken->name = pp->GetAtomString(ppToken->atom);
             return PpAtomIdentifier;
         case '0':
-            ppToken->name[len++] = (char)ch;
+            tokenText[len++] = (char)ch;
             ch = pp->getChar();
             if (ch == 'x' || ch == 'X') {
                 // must be hexidecimal
 
                 bool isUnsigned = false;
-                ppToken->name[len++] = (char)ch;
+                tokenText[len++] = (char)ch;
                 ch = pp->getChar();
                 if ((ch >= '0' && ch <= '9') ||
                     (ch >= 'A' && ch <= 'F') ||
@@ -311,7 +327,7 @@ int TPpContext::tStringInput::scan(TPpToken* ppToken)
                     ival = 0;
                     do {
                         if (ival <= 0x0fffffff) {
-                            ppToken->name[len++] = (char)ch;
+                            tokenText[len++] = (char)ch;
                             if (ch >= '0' && ch <= '9') {
                                 ii = ch - '0';
                             } else if (ch >= 'A' && ch <= 'F') {
@@ -337,11 +353,12 @@ int TPpContext::tStringInput::scan(TPpToken* ppToken)
                 }
                 if (ch == 'u' || ch == 'U') {
                     if (len < TPpToken::maxTokenLength)
-                        ppToken->name[len++] = (char)ch;
+                        tokenText[len++] = (char)ch;
                     isUnsigned = true;
                 } else
                     pp->ungetChar();
-                ppToken->name[len] = '\0';
+                tokenText[len] = '\0';
+                ppToken->name = pp->SaveSpelling(tokenText, len);
                 ppToken->ival = (int)ival;
 
                 if (isUnsigned)
@@ -359,7 +376,7 @@ int TPpContext::tStringInput::scan(TPpToken* ppToken)
                 // see how much octal-like stuff we can read
                 while (ch >= '0' && ch <= '7') {
                     if (len < TPpToken::maxTokenLength)
-                        ppToken->name[len++] = (char)ch;
+                        tokenText[len++] = (char)ch;
                     else if (! AlreadyComplained) {
                         pp->parseContext.ppError(ppToken->loc, "numeric literal too long", "", "");
                         AlreadyComplained = 1;
@@ -377,7 +394,7 @@ int TPpContext::tStringInput::scan(TPpToken* ppToken)
                     nonOctal = true;
                     do {
                         if (len < TPpToken::maxTokenLength)
-                            ppToken->name[len++] = (char)ch;
+                            tokenText[len++] = (char)ch;
                         else if (! AlreadyComplained) {
                             pp->parseContext.ppError(ppToken->loc, "numeric literal too long", "", "");
                             AlreadyComplained = 1;
@@ -394,11 +411,12 @@ int TPpContext::tStringInput::scan(TPpToken* ppToken)
 
                 if (ch == 'u' || ch == 'U') {
                     if (len < TPpToken::maxTokenLength)
-                        ppToken->name[len++] = (char)ch;
+                        tokenText[len++] = (char)ch;
                     isUnsigned = true;
                 } else
                     pp->ungetChar();
-                ppToken->name[len] = '\0';
+                tokenText[len] = '\0';
+                ppToken->name = pp->SaveSpelling(tokenText, len);
 
                 if (octalOverflow)
                     pp->parseContext.ppError(ppToken->loc, "octal literal too big", "", "");
@@ -417,7 +435,7 @@ int TPpContext::tStringInput::scan(TPpToken* ppToken)
 
             do {
                 if (len < TPpToken::maxTokenLength)
-                    ppToken->name[len++] = (char)ch;
+                    tokenText[len++] = (char)ch;
                 else if (! AlreadyComplained) {
                     pp->parseContext.ppError(ppToken->loc, "numeric literal too long", "", "");
                     AlreadyComplained = 1;
@@ -432,17 +450,18 @@ int TPpContext::tStringInput::scan(TPpToken* ppToken)
                 bool uint = false;
                 if (ch == 'u' || ch == 'U') {
                     if (len < TPpToken::maxTokenLength)
-                        ppToken->name[len++] = (char)ch;
+                        tokenText[len++] = (char)ch;
                     uint = true;
                 } else
                     pp->ungetChar();
 
-                ppToken->name[len] = '\0';
+                tokenText[len] = '\0';
+                ppToken->name = pp->SaveSpelling(tokenText, len);
                 ival = 0;
                 const unsigned oneTenthMaxInt  = 0xFFFFFFFFu / 10;
                 const unsigned remainderMaxInt = 0xFFFFFFFFu - 10 * oneTenthMaxInt;
                 for (int i = 0; i < numericLen; i++) {
-                    ch = ppToken->name[i] - '0';
+                    ch = tokenText[i] - '0';
                     if ((ival > oneTenthMaxInt) || (ival == oneTenthMaxInt && ch > remainderMaxInt)) {
                         pp->parseContext.ppError(ppToken->loc, "numeric literal too big", "", "");
                         ival = 0xFFFFFFFFu;
@@ -635,6 +654,7 @@ int TPpContext::tStringInput::scan(TPpToken* ppToken)
                     break;
             };
             tokenText[len] = '\0';
+            ppToken->name = pp->SaveSpelling(tokenText, len);
             if (ch != '"') {
                 pp->ungetChar();
                 pp->parseContext.ppError(ppToken->loc, "end of line in string", "string", "");
@@ -646,6 +666,143 @@ int TPpContext::tStringInput::scan(TPpToken* ppToken)
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////// Skipping the disabled part of an #if ///////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+//
+// Text in the disabled part of an #if only has to be looked at for where lines
+// start, for comments and strings that could hide a line's end or a '#', and for
+// the '#' starting a directive.  The rest is passed over in bulk, without being
+// tokenized.
+//
+
+namespace {
+
+// The characters bulk skipping has to stop at: line ends and escapes, and the
+// starts and ends of comments and strings.
+struct TSkipStops {
+    TSkipStops()
+    {
+        memset(stop, 0, sizeof(stop));
+        stop[(unsigned char)'\n'] = true;
+        stop[(unsigned char)'\r'] = true;
+        stop[(unsigned char)'\\'] = true;
+        stop[(unsigned char)'/'] = true;
+        stop[(unsigned char)'*'] = true;
+        stop[(unsigned char)'"'] = true;
+    }
+
+    bool stop[256];
+} SkipStops;
+
+} // end anonymous namespace
+
+bool TPpContext::tStringInput::skipToDirective(bool lineStart)
+{
+    int ch = lineStart ? '\n' : skipRestOfLine(getch());
+
+    while (ch != EOF) {
+        // at the start of a line; white space and block comments don't count
+        ch = getch();
+        for (;;) {
+            while (ch == ' ' || ch == '\t')
+                ch = getch();
+            if (ch != '/')
+                break;
+            ch = getch();
+            if (ch != '*') {
+                if (ch != EOF)
+                    ungetch();
+                ch = '/';
+                break;
+            }
+            ch = skipBlockComment();
+        }
+
+        if (ch == '#') {
+            ungetch();
+            break;
+        }
+        if (ch != '\n')
+            ch = skipRestOfLine(ch);
+    }
+
+    return true;
+}
+
+//
+// Move past the rest of the line 'ch' is on, returning the '\n' ending it, or EOF.
+//
+int TPpContext::tStringInput::skipRestOfLine(int ch)
+{
+    for (;;) {
+        switch (ch) {
+        case '\n':
+        case EOF:
+            return ch;
+
+        case '"':
+            // strings don't hold comments, and end with the line
+            do {
+                input->skipTo(SkipStops.stop);
+                ch = getch();
+            } while (ch != '"' && ch != '\n' && ch != EOF);
+            if (ch != '"')
+                continue;
+            break;
+
+        case '/':
+            ch = getch();
+            if (ch == '/') {
+                pp->inComment = true;
+                do {
+                    input->skipTo(SkipStops.stop);
+                    ch = getch();
+                } while (ch != '\n' && ch != EOF);
+                pp->inComment = false;
+                continue;
+            } else if (ch == '*') {
+                ch = skipBlockComment();
+                continue;
+            }
+            // look at 'ch' again
+            continue;
+
+        default:
+            break;
+        }
+
+        input->skipTo(SkipStops.stop);
+        ch = getch();
+    }
+}
+
+//
+// Move past a block comment whose "/*" has been read, returning the character
+// after it, or EOF.
+//
+int TPpContext::tStringInput::skipBlockComment()
+{
+    TSourceLoc loc = pp->getCurrentLoc();
+    int ch = getch();
+    for (;;) {
+        while (ch != '*' && ch != EOF) {
+            input->skipTo(SkipStops.stop);
+            ch = getch();
+        }
+        if (ch == EOF)
+            break;
+        ch = getch();
+        if (ch == '/')
+            return getch();
+    }
+
+    pp->parseContext.ppError(loc, "EOF in comment", "comment", "");
+
+    return EOF;
+}
+
 //
 // The main functional entry-point into the preprocessor, which will
 // scan the source strings to figure out and return the next processing token.
@@ -90,69 +90,146 @@ NVIDIA HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
+#include <deque>
+#include <mutex>
 
 #include "PpContext.h"
 #include "PpTokens.h"
 
 namespace glslang {
 
-void TPpContext::lAddByte(TokenStream *fTok, unsigned char fVal)
-{
-    fTok->data.push_back(fVal);
-}
+//
+// The tokens of a file brought in by #include, recorded once and then only
+// read, by any number of compiles on any number of threads.  Laid out like a
+// TokenStream, except identifiers can't be recorded as atoms, which belong to
+// one compile; they index 'identifiers' instead.  Spellings are kept here too,
+// as the ones scanned are only good for the compile that scanned them.
+//
+struct TIncludedFile {
+    struct Literal {
+        double dval;
+        int ival;
+        int name;               // offset of the spelling in 'names'
+    };
+    struct Position {
+        int line;
+        int column;
+    };
 
-/*
-* Get the next byte from a stream.
-*/
-int TPpContext::lReadByte(TokenStream *pTok)
+    std::string path;           // as given by the includer
+    unsigned long long hash;    // of the contents the tokens came from
+    size_t length;
+    std::vector<TPpContext::TokenStream::Token> tokens;
+    std::vector<Position> positions;    // where in the file each token is
+    std::vector<Literal> literals;
+    std::vector<int> identifiers;   // offset of each distinct identifier's spelling in 'names'
+    std::vector<char> names;
+
+    size_t getSize() const
+    {
+        return sizeof(*this) + path.size() + tokens.size() * sizeof(tokens[0]) + positions.size() * sizeof(positions[0]) +
+               literals.size() * sizeof(literals[0]) + identifiers.size() * sizeof(identifiers[0]) + names.size();
+    }
+};
+
+} // end namespace glslang
+
+namespace {
+
+using namespace glslang;
+
+// A single global usable by all threads, holding the most recent tokens seen
+// for each included path and scanning state (see IncludeCacheKey()).  Entries
+// are replaced, not edited, when a file's contents change; inputs still
+// replaying an old entry keep it alive.  So a long-running process doesn't
+// grow without bound, the oldest entries are dropped once the total size of
+// the entries passes maxSize.
+struct TIncludeCache {
+    TIncludeCache() : size(0) { }
+
+    void store(const std::string& key, const std::shared_ptr<const TIncludedFile>& file)
+    {
+        std::shared_ptr<const TIncludedFile>& entry = files[key];
+        if (entry)
+            size -= entry->getSize();
+        else
+            order.push_back(key);
+        entry = file;
+        size += file->getSize();
+
+        while (size > maxSize && order.size() > 1) {
+            auto oldest = files.find(order.front());
+            size -= oldest->second->getSize();
+            files.erase(oldest);
+            order.pop_front();
+        }
+    }
+
+    static const size_t maxSize = 64 * 1024 * 1024;
+    std::mutex lock;
+    std::unordered_map<std::string, std::shared_ptr<const TIncludedFile> > files;
+    std::deque<std::string> order;  // keys of 'files', oldest first
+    size_t size;                    // sum of the sizes of 'files'
+};
+TIncludeCache* IncludeCache = 0;
+
+unsigned long long HashContents(const std::string& contents)
 {
-    if (pTok->current < pTok->data.size())
-        return pTok->data[pTok->current++];
-    else
-        return tInput::endOfInput;
+    unsigned long long hash = 14695981039346656037ULL;
+    for (size_t c = 0; c < contents.size(); ++c) {
+        hash ^= (unsigned char)contents[c];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
 }
 
-void TPpContext::lUnreadByte(TokenStream *pTok)
+//
+// Fill in the value of a recorded number or string.
+//
+template<class Literal>
+void RecordLiteralValue(const TPpContext::TokenStream::Token& recorded, Literal& literal, const TPpToken* ppToken)
 {
-    if (pTok->current > 0)
-        --pTok->current;
+    literal.ival = recorded.token == PpAtomConstInt || recorded.token == PpAtomConstUint ? ppToken->ival : 0;
+    literal.dval = recorded.token == PpAtomConstFloat || recorded.token == PpAtomConstDouble ? ppToken->dval : 0.0;
 }
 
+} // end anonymous namespace
+
+namespace glslang {
+
 /*
 * Add a token to the end of a list for later playback.
 */
 void TPpContext::RecordToken(TokenStream *pTok, int token, TPpToken* ppToken)
 {
-    const char* s;
-    char* str = NULL;
-
-    if (token > PpAtomMaxSingle)
-        lAddByte(pTok, (unsigned char)((token & 0x7f) + 0x80));
-    else
-        lAddByte(pTok, (unsigned char)(token & 0x7f));
+    TokenStream::Token recorded;
+    recorded.token = token;
+    recorded.value = 0;
+    recorded.space = ppToken->space;
 
     switch (token) {
     case PpAtomIdentifier:
-    case PpAtomConstString:
-        s = ppToken->name;
-        while (*s)
-            lAddByte(pTok, (unsigned char) *s++);
-        lAddByte(pTok, 0);
+        recorded.value = ppToken->atom;
         break;
+    case PpAtomConstString:
     case PpAtomConstInt:
     case PpAtomConstUint:
     case PpAtomConstFloat:
     case PpAtomConstDouble:
-        str = ppToken->name;
-        while (*str) {
-            lAddByte(pTok, (unsigned char) *str);
-            str++;
-        }
-        lAddByte(pTok, 0);
+    {
+        TokenStream::Literal literal;
+        RecordLiteralValue(recorded, literal, ppToken);
+        literal.name = ppToken->name;
+        recorded.value = (int)pTok->literals.size();
+        pTok->literals.push_back(literal);
         break;
+    }
     default:
         break;
     }
+
+    pTok->data.push_back(recorded);
 }
 
 /*
@@ -168,71 +245,46 @@ void TPpContext::RewindTokenStream(TokenStream *pTok)
 */
 int TPpContext::ReadToken(TokenStream *pTok, TPpToken *ppToken)
 {
-    char* tokenText = ppToken->name;
-    int ltoken, len;
-    int ch;
-
-    ltoken = lReadByte(pTok);
-    ppToken->loc = parseContext.getCurrentLoc();
-    if (ltoken > 127)
-        ltoken += 128;
-    switch (ltoken) {
-    case '#':        
-        if (lReadByte(pTok) == '#') {
+    ppToken->loc = getCurrentLoc();
+    if (pTok->current >= pTok->data.size())
+        return tInput::endOfInput;
+
+    const TokenStream::Token& recorded = pTok->data[pTok->current++];
+    ppToken->space = recorded.space;
+
+    switch (recorded.token) {
+    case '#':
+        if (pTok->current < pTok->data.size() && pTok->data[pTok->current].token == '#') {
+            ++pTok->current;
             parseContext.requireProfile(ppToken->loc, ~EEsProfile, "token pasting (##)");
-            parseContext.profileRequires(ppToken->loc, ~EEsProfile, 130, 0, "token pasting (##)");
+            parseContext.profileRequires(ppToken->loc, ~EEsProfile, 130, "token pasting (##)");
             parseContext.error(ppToken->loc, "token pasting not implemented (internal error)", "##", "");
             //return PpAtomPaste;
             return ReadToken(pTok, ppToken);
-        } else
-            lUnreadByte(pTok);
+        }
         break;
-    case PpAtomConstString:
     case PpAtomIdentifier:
+        ppToken->atom = recorded.value;
+        ppToken->name = GetAtomString(recorded.value);
+        break;
+    case PpAtomConstString:
+        ppToken->name = pTok->literals[recorded.value].name;
+        break;
     case PpAtomConstFloat:
     case PpAtomConstDouble:
+        ppToken->name = pTok->literals[recorded.value].name;
+        ppToken->dval = pTok->literals[recorded.value].dval;
+        break;
     case PpAtomConstInt:
     case PpAtomConstUint:
-        len = 0;
-        ch = lReadByte(pTok);
-        while (ch != 0) {
-            if (len < TPpToken::maxTokenLength) {
-                tokenText[len] = (char)ch;
-                len++;
-                ch = lReadByte(pTok);
-            } else {
-                parseContext.error(ppToken->loc, "token too long", "", "");
-                break;
-            }
-        }
-        tokenText[len] = 0;
-
-        switch (ltoken) {
-        case PpAtomIdentifier:
-            ppToken->atom = LookUpAddString(tokenText);
-            break;
-        case PpAtomConstString:
-            break;
-        case PpAtomConstFloat:
-        case PpAtomConstDouble:
-            strcpy(ppToken->name, tokenText);
-            ppToken->dval = atof(ppToken->name);
-            break;
-        case PpAtomConstInt:
-        case PpAtomConstUint:
-            strcpy(ppToken->name, tokenText);
-            if (len > 0 && tokenText[0] == '0') {
-                if (len > 1 && (tokenText[1] == 'x' || tokenText[1] == 'X'))
-                    ppToken->ival = strtol(ppToken->name, 0, 16);
-                else
-                    ppToken->ival = strtol(ppToken->name, 0, 8);
-            } else
-                ppToken->ival = atoi(ppToken->name);
-            break;
-        }
+        ppToken->name = pTok->literals[recorded.value].name;
+        ppToken->ival = pTok->literals[recorded.value].ival;
+        break;
+    default:
+        break;
     }
 
-    return ltoken;
+    return recorded.token;
 }
 
 int TPpContext::tTokenInput::scan(TPpToken* ppToken)
@@ -240,12 +292,46 @@ int TPpContext::tTokenInput::scan(TPpToken* ppToken)
     return pp->ReadToken(tokens, ppToken);
 }
 
+void TPpContext::tTokenInput::release()
+{
+    done = false;
+    pp->tokenInputs.put(this);
+}
+
 void TPpContext::pushTokenStreamInput(TokenStream* ts)
 {
-    pushInput(new tTokenInput(this, ts));
+    tTokenInput* in = tokenInputs.get(this);
+    in->reset(ts);
+    pushInput(in);
     RewindTokenStream(ts);
 }
 
+/*
+* Get an empty token stream, for a macro argument, reusing a released one if there is one.
+*/
+TPpContext::TokenStream* TPpContext::NewTokenStream()
+{
+    if (freeTokenStreams.empty())
+        return new TokenStream;
+
+    TokenStream* pTok = freeTokenStreams.back();
+    freeTokenStreams.pop_back();
+
+    return pTok;
+}
+
+/*
+* Give back a stream from NewTokenStream(), keeping its buffers for the next one.
+* Recorded spellings live elsewhere, so tokens already read from it stay good.
+*/
+void TPpContext::ReleaseTokenStream(TokenStream* pTok)
+{
+    pTok->data.clear();
+    pTok->literals.clear();
+    pTok->current = 0;
+    freeTokenStreams.push_back(pTok);
+}
+
 int TPpContext::tUngotTokenInput::scan(TPpToken* ppToken)
 {
     if (done)
@@ -258,9 +344,203 @@ int TPpContext::tUngotTokenInput::scan(TPpToken* ppToken)
     return ret;
 }
 
+void TPpContext::tUngotTokenInput::release()
+{
+    done = false;
+    pp->ungotTokenInputs.put(this);
+}
+
 void TPpContext::UngetToken(int token, TPpToken* ppToken)
 {
-    pushInput(new tUngotTokenInput(this, token, ppToken));
+    tUngotTokenInput* in = ungotTokenInputs.get(this);
+    in->reset(token, ppToken);
+    pushInput(in);
+}
+
+//
+// Build the process-wide cache of included files.  Should be called only once per process.
+//
+void TPpContext::InitIncludeCache()
+{
+    if (IncludeCache == 0)
+        IncludeCache = new TIncludeCache;
+}
+
+void TPpContext::DeleteIncludeCache()
+{
+    delete IncludeCache;
+    IncludeCache = 0;
+}
+
+//
+// Name cached tokens by what they depend on besides the contents.  The scan
+// checks number suffixes and line continuations against the includer's version,
+// profile, and 420pack behavior, and which of those report, and whether a line
+// continuation ends a comment, depends on the message options.
+//
+std::string TPpContext::IncludeCacheKey(const std::string& path)
+{
+    char state[80];
+    snprintf(state, sizeof(state), "\n%d %d %d %d %d", parseContext.version, (int)parseContext.profile,
+             parseContext.getExtensionBehavior(E_GL_ARB_shading_language_420pack),
+             parseContext.relaxedErrors(), parseContext.suppressWarnings());
+
+    return path + state;
+}
+
+//
+// Return the tokens of an included file, from the cache if the file's contents
+// and the scanning state are the same as when it was cached, otherwise by
+// scanning the contents now.  Diagnostics from the scan are located in the
+// file, by its path and line, within the string of 'loc', the #include.
+//
+std::shared_ptr<const TIncludedFile> TPpContext::TokenizeIncludedFile(const std::string& path, const std::string& contents,
+                                                                      const TSourceLoc& loc)
+{
+    unsigned long long hash = HashContents(contents);
+    std::string key = IncludeCacheKey(path);
+    {
+        std::lock_guard<std::mutex> guard(IncludeCache->lock);
+        auto it = IncludeCache->files.find(key);
+        if (it != IncludeCache->files.end() && it->second->hash == hash && it->second->length == contents.size())
+            return it->second;
+    }
+
+    std::shared_ptr<TIncludedFile> file = std::make_shared<TIncludedFile>();
+    file->path = path;
+    file->hash = hash;
+    file->length = contents.size();
+
+    // Scan the raw tokens, without acting on directives or expanding macros;
+    // that is done each time the tokens are replayed.  The marker input stops
+    // the scan at the end of the file rather than continuing into the includer.
+    // The trailing new line ends a last line that lacks one, so a directive there
+    // ends within the file.
+    const char* sources[] = { contents.c_str(), "\n" };
+    size_t lengths[] = { contents.size(), 1 };
+    TInputScanner input(2, sources, lengths, -loc.string, 1);
+    input.setName(NewPoolTString(path.c_str()));
+    size_t diagnostics = parseContext.infoSink.info.size();
+
+    // Make the file's scanner the current one, so locations come from it, not
+    // from the source or included file being replayed.
+    TInputScanner* includerScanner = parseContext.getScanner();
+    int replayDepth = includeDepth;
+    parseContext.setScanner(&input);
+    includeDepth = 0;
+    pushInput(markerInputs.get(this));
+    pushInput(new tStringInput(this, input));
+
+    std::unordered_map<int, int> identifierIndex;
+    TPpToken ppToken;
+    int token;
+    while ((token = scanToken(&ppToken)) != tMarkerInput::marker) {
+        TokenStream::Token recorded;
+        recorded.token = token;
+        recorded.value = 0;
+        recorded.space = ppToken.space;
+
+        switch (token) {
+        case PpAtomIdentifier:
+        {
+            auto it = identifierIndex.find(ppToken.atom);
+            if (it == identifierIndex.end()) {
+                recorded.value = (int)file->identifiers.size();
+                identifierIndex[ppToken.atom] = recorded.value;
+                file->identifiers.push_back((int)file->names.size());
+                const char* spelling = GetAtomString(ppToken.atom);
+                file->names.insert(file->names.end(), spelling, spelling + strlen(spelling) + 1);
+            } else
+                recorded.value = it->second;
+            break;
+        }
+        case PpAtomConstString:
+        case PpAtomConstInt:
+        case PpAtomConstUint:
+        case PpAtomConstFloat:
+        case PpAtomConstDouble:
+        {
+            TIncludedFile::Literal literal;
+            RecordLiteralValue(recorded, literal, &ppToken);
+            literal.name = (int)file->names.size();
+            file->names.insert(file->names.end(), ppToken.name, ppToken.name + strlen(ppToken.name) + 1);
+            recorded.value = (int)file->literals.size();
+            file->literals.push_back(literal);
+            break;
+        }
+        default:
+            break;
+        }
+
+        file->tokens.push_back(recorded);
+        TIncludedFile::Position position = { ppToken.loc.line, ppToken.loc.column };
+        file->positions.push_back(position);
+    }
+    popInput();
+    includeDepth = replayDepth;
+    parseContext.setScanner(includerScanner);
+
+    // Only share tokens that scanned cleanly, so that every compile including
+    // the file sees the same diagnostics.
+    if (parseContext.infoSink.info.size() == diagnostics) {
+        std::lock_guard<std::mutex> guard(IncludeCache->lock);
+        IncludeCache->store(key, file);
+    }
+
+    return file;
+}
+
+TPpContext::tIncludeInput::tIncludeInput(TPpContext* pp, std::shared_ptr<const TIncludedFile> f, const TSourceLoc& l) :
+    tInput(pp), file(f.get()), current(0), includerLoc(pp->getCurrentLoc())
+{
+    pp->includedFiles.push_back(f);
+    pp->includePaths.push_back(file->path);
+    loc.init();
+    loc.string = l.string;
+    loc.name = NewPoolTString(file->path.c_str());
+    if (pp->includeDepth++ == 0)
+        pp->includeDirectiveLoc = l;
+    pp->includeLoc = l;
+    atoms.resize(file->identifiers.size());
+    for (size_t i = 0; i < atoms.size(); ++i)
+        atoms[i] = pp->LookUpAddString(&file->names[file->identifiers[i]]);
+}
+
+int TPpContext::tIncludeInput::scan(TPpToken* ppToken)
+{
+    if (current >= file->tokens.size())
+        return endOfInput;
+
+    loc.line = file->positions[current].line;
+    loc.column = file->positions[current].column;
+    pp->includeLoc = loc;
+    const TokenStream::Token& recorded = file->tokens[current++];
+    ppToken->loc = loc;
+    ppToken->space = recorded.space;
+
+    switch (recorded.token) {
+    case PpAtomIdentifier:
+        ppToken->atom = atoms[recorded.value];
+        ppToken->name = pp->GetAtomString(ppToken->atom);
+        break;
+    case PpAtomConstString:
+        ppToken->name = &file->names[file->literals[recorded.value].name];
+        break;
+    case PpAtomConstFloat:
+    case PpAtomConstDouble:
+        ppToken->name = &file->names[file->literals[recorded.value].name];
+        ppToken->dval = file->literals[recorded.value].dval;
+        break;
+    case PpAtomConstInt:
+    case PpAtomConstUint:
+        ppToken->name = &file->names[file->literals[recorded.value].name];
+        ppToken->ival = file->literals[recorded.value].ival;
+        break;
+    default:
+        break;
+    }
+
+    return recorded.token;
 }
 
 } // end namespace glslang
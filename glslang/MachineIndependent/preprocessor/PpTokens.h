@@ -142,6 +142,7 @@ enum EFixedAtoms {
     PpAtomLine,
     PpAtomPragma,
     PpAtomError,
+    PpAtomInclude,
 
     // #version ...
     PpAtomVersion,
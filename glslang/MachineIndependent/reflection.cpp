@@ -708,15 +708,23 @@ bool TReflection::addStage(EShLanguage, const TIntermediate& intermediate)
 
 void TReflection::dump()
 {
-    printf("Uniform reflection:\n");
+    std::string text;
+    dump(text);
+    fputs(text.c_str(), stdout);
+}
+
+// Append the text printed by dump().
+void TReflection::dump(std::string& text)
+{
+    text.append("Uniform reflection:\n");
     for (size_t i = 0; i < indexToUniform.size(); ++i)
-        indexToUniform[i].dump();
-    printf("\n");
+        indexToUniform[i].dump(text);
+    text.append("\n");
 
-    printf("Uniform block reflection:\n");
+    text.append("Uniform block reflection:\n");
     for (size_t i = 0; i < indexToUniformBlock.size(); ++i)
-        indexToUniformBlock[i].dump();
-    printf("\n");
+        indexToUniformBlock[i].dump(text);
+    text.append("\n");
 
     //printf("Live names\n");
     //for (TNameToIndex::const_iterator it = nameToIndex.begin(); it != nameToIndex.end(); ++it)
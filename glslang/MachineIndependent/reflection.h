@@ -40,6 +40,8 @@
 
 #include <list>
 #include <set>
+#include <string>
+#include <stdio.h>
 
 //
 // A reflection database and its interface, consistent with the OpenGL API reflection queries.
@@ -56,7 +58,13 @@ class TObjectReflection {
 public:
     TObjectReflection(const TString& pName, int pOffset, int pGLDefineType, int pSize, int pIndex) : 
         name(pName), offset(pOffset), glDefineType(pGLDefineType), size(pSize), index(pIndex) { }
-    void dump() const { printf("%s: offset %d, type %x, size %d, index %d\n", name.c_str(), offset, glDefineType, size, index); }
+    void dump(std::string& text) const
+    {
+        char fields[100];
+        snprintf(fields, sizeof(fields), ": offset %d, type %x, size %d, index %d\n", offset, glDefineType, size, index);
+        text.append(name.c_str());
+        text.append(fields);
+    }
     TString name;
     int offset;
     int glDefineType;
@@ -104,6 +112,7 @@ public:
     }
 
     void dump();
+    void dump(std::string& text);
 
 protected:
     friend class glslang::TLiveTraverser;
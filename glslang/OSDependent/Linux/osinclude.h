@@ -43,6 +43,7 @@
 #include <semaphore.h>
 #include <assert.h>
 #include <errno.h>
+#include <string>
 
 #define _vsnprintf vsnprintf
 
@@ -75,11 +76,19 @@ void GetGlobalLock();
 void ReleaseGlobalLock();
 
 typedef unsigned int (*TThreadEntrypoint)(void*);
-void* OS_CreateThread(TThreadEntrypoint);
+void* OS_CreateThread(TThreadEntrypoint, void* args = 0);
 void OS_WaitForAllThreads(void* threads, int numThreads);
 
 void OS_Sleep(int milliseconds);
 
+// Map a whole file read-only into memory, returning 0 on failure or else a
+// handle keeping 'data' valid until given to OS_UnmapFile().
+void* OS_MapFile(const char* fileName, const char*& data, size_t& size);
+void OS_UnmapFile(void* mapping);
+
+// Path of the running executable, or "" if it can't be found.
+std::string OS_GetExecutablePath();
+
 void OS_DumpMemoryCounters();
 
 } // end namespace glslang
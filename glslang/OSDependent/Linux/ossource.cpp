@@ -38,6 +38,11 @@
 #include "osinclude.h"
 #include "../../../OGLCompilersDLL/InitializeDll.h"
 
+#include <time.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 namespace glslang {
 
 //
@@ -137,22 +142,116 @@ bool OS_FreeTLSIndex(OS_TLSIndex nIndex)
 		return false;
 }
 
-// TODO: non-windows: if we need these on linux, flesh them out
-void InitGlobalLock() { }
-void GetGlobalLock() { }
-void ReleaseGlobalLock() { }
+//
+// Process-wide lock.  Recursive, to match the semantics of the Windows
+// mutex, since InitProcess() can be entered while the lock is held.
+//
+pthread_mutex_t GlobalLock;
+
+void InitGlobalLock()
+{
+	pthread_mutexattr_t mutexattr;
+	pthread_mutexattr_init(&mutexattr);
+	pthread_mutexattr_settype(&mutexattr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&GlobalLock, &mutexattr);
+	pthread_mutexattr_destroy(&mutexattr);
+}
+
+void GetGlobalLock()
+{
+	pthread_mutex_lock(&GlobalLock);
+}
+
+void ReleaseGlobalLock()
+{
+	pthread_mutex_unlock(&GlobalLock);
+}
 
-void* OS_CreateThread(TThreadEntrypoint entry)
+//
+// pthread entry points take and return void*, while TThreadEntrypoint returns
+// unsigned int, so thread creation goes through this trampoline.
+//
+struct TThreadStartLinux {
+	TThreadEntrypoint entry;
+	void* args;
+};
+
+static void* ThreadEntryLinux(void* start)
 {
-    return 0;
+	TThreadStartLinux threadStart = *(TThreadStartLinux*)start;
+	delete (TThreadStartLinux*)start;
+
+	return (void*)(size_t)threadStart.entry(threadStart.args);
+}
+
+void* OS_CreateThread(TThreadEntrypoint entry, void* args)
+{
+	TThreadStartLinux* start = new TThreadStartLinux;
+	start->entry = entry;
+	start->args = args;
+
+	pthread_t thread;
+	if (pthread_create(&thread, 0, ThreadEntryLinux, start) != 0) {
+		delete start;
+		return 0;
+	}
+
+	return (void*)thread;
 }
 
 void OS_WaitForAllThreads(void* threads, int numThreads)
 {
+	for (int t = 0; t < numThreads; ++t)
+		pthread_join((pthread_t)((void**)threads)[t], 0);
 }
 
 void OS_Sleep(int milliseconds)
 {
+	timespec duration;
+	duration.tv_sec = milliseconds / 1000;
+	duration.tv_nsec = (milliseconds % 1000) * 1000000;
+	nanosleep(&duration, 0);
+}
+
+struct TFileMappingLinux {
+	void* address;
+	size_t size;
+};
+
+void* OS_MapFile(const char* fileName, const char*& data, size_t& size)
+{
+	FILE* file = fopen(fileName, "rb");
+	if (! file)
+		return 0;
+
+	struct stat status;
+	void* address = MAP_FAILED;
+	if (fstat(fileno(file), &status) == 0 && status.st_size > 0)
+		address = mmap(0, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+	fclose(file);
+	if (address == MAP_FAILED)
+		return 0;
+
+	TFileMappingLinux* mapping = new TFileMappingLinux;
+	mapping->address = address;
+	mapping->size = (size_t)status.st_size;
+	data = static_cast<const char*>(address);
+	size = mapping->size;
+
+	return mapping;
+}
+
+void OS_UnmapFile(void* mapping)
+{
+	TFileMappingLinux* fileMapping = static_cast<TFileMappingLinux*>(mapping);
+	munmap(fileMapping->address, fileMapping->size);
+	delete fileMapping;
+}
+
+// The kernel's link to the executable can be opened like the file itself.
+std::string OS_GetExecutablePath()
+{
+	return "/proc/self/exe";
 }
 
 void OS_DumpMemoryCounters()
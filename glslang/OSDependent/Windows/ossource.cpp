@@ -116,9 +116,9 @@ void ReleaseGlobalLock()
     ReleaseMutex(GlobalLock);
 }
 
-void* OS_CreateThread(TThreadEntrypoint entry)
+void* OS_CreateThread(TThreadEntrypoint entry, void* args)
 {
-    return (void*)_beginthreadex(0, 0, entry, 0, 0, 0);
+    return (void*)_beginthreadex(0, 0, entry, args, 0, 0);
     //return CreateThread(0, 0, entry, 0, 0, 0);
 }
 
@@ -132,6 +132,47 @@ void OS_Sleep(int milliseconds)
     Sleep(milliseconds);
 }
 
+void* OS_MapFile(const char* fileName, const char*& data, size_t& size)
+{
+    HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if (file == INVALID_HANDLE_VALUE)
+        return 0;
+
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = 0;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+        mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+    CloseHandle(file);
+    if (mapping == 0)
+        return 0;
+
+    // the view keeps the mapping alive
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (view == 0)
+        return 0;
+
+    data = static_cast<const char*>(view);
+    size = (size_t)fileSize.QuadPart;
+
+    return const_cast<void*>(view);
+}
+
+void OS_UnmapFile(void* mapping)
+{
+    UnmapViewOfFile(mapping);
+}
+
+std::string OS_GetExecutablePath()
+{
+    char path[MAX_PATH];
+    DWORD length = GetModuleFileNameA(0, path, MAX_PATH);
+    if (length == 0 || length == MAX_PATH)
+        return std::string();
+
+    return std::string(path, length);
+}
+
 void OS_DumpMemoryCounters()
 {
 #ifdef DUMP_COUNTERS
@@ -249,6 +249,7 @@ SH_IMPORT_EXPORT int ShGetUniformLocation(const ShHandle uniformMap, const char*
 
 #include <list>
 #include <string>
+#include <vector>
 
 class TCompiler;
 class TInfoSink;
@@ -268,11 +269,41 @@ bool InitializeProcess();
 // Call once per process to tear down everything
 void FinalizeProcess();
 
+// Optionally call after InitializeProcess() to set up the built-in symbol tables
+// for all stages of the given versions and profiles now, using up to 'numThreads'
+// threads, instead of during the first compile to use each stage.  ENoProfile means the
+// profile a shader with only "#version <version>" would get.  Returns false if
+// any version/profile is not a supported combination (the rest are still done).
+bool WarmBuiltins(const int* versions, const EProfile* profiles, int count, int numThreads);
+
+// Optionally call after InitializeProcess() to write a snapshot of the built-in
+// symbol tables for the given versions and profiles (as for WarmBuiltins()) to
+// the file 'fileName'.  Returns false if any version/profile is not supported
+// or the file can't be written.
+bool SaveBuiltins(const char* fileName, const int* versions, const EProfile* profiles, int count);
+
+// Optionally call before compiling anything to map a file written by SaveBuiltins(),
+// from this same build of glslang, so the built-in symbol tables it holds are read
+// from it rather than generated and parsed.  Stays in effect until FinalizeProcess().
+// Returns false, leaving built-ins to be parsed, if the file can't be used.
+bool LoadBuiltins(const char* fileName);
+
+// As above, but for a snapshot already in memory.  The memory has to stay valid
+// and unchanged until FinalizeProcess().
+bool LoadBuiltins(const void* image, size_t size);
+
+// A build can compile a snapshot of the built-ins of all versions into the
+// library, which InitializeProcess() loads if no other snapshot is loaded.
+// Optionally call before compiling anything to stop using any snapshot, that
+// one included, so the built-ins get generated and parsed.
+void UnloadBuiltins();
+
 // Make one TShader per shader that you will link into a program.  Then provide
 // the shader through setStrings() or setStringsWithLengths(), then call parse(),
 // then query the info logs.
 // Optionally use setPreamble() to set a special shader string that will be
 // processed before all others but won't affect the validity of #version.
+// Optionally use setIncluder() to allow #include; see TShader::Includer.
 //
 // N.B.: Does not yet support having the same TShader instance being linked into
 // multiple programs.
@@ -286,6 +317,27 @@ public:
     void setStrings(const char* const* s, int n);
     void setStringsWithLengths(const char* const* s, const int* l, int n);
     void setPreamble(const char* s) { preamble = s; }
+
+    // Resolves the file named by '#include "name"'.  Without one, #include is an error.
+    //
+    // Each file is tokenized only once per process and the tokens replayed on later
+    // includes, in any compile on any thread, as long as the includer keeps returning
+    // the same path and contents.  Diagnostics for an included file's tokens are
+    // reported at the location of its #include, as they are for macro expansions.
+    class Includer {
+    public:
+        virtual ~Includer() { }
+
+        // On success, set 'path' to a name that always identifies this same file,
+        // set 'contents' to its text, and return true.  Return false if there is
+        // no such file.  'includerPath' is the 'path' given for the file containing
+        // the #include, or "" if it is in the shader's own strings, so that names
+        // can be resolved relative to it.  Must be safe to call concurrently if
+        // shaders sharing this includer are parsed concurrently.
+        virtual bool include(const char* name, const char* includerPath, std::string& path, std::string& contents) = 0;
+    };
+    void setIncluder(Includer* i) { includer = i; }
+
     bool parse(const TBuiltInResource*, int defaultVersion, EProfile defaultProfile, bool forceDefaultVersionAndProfile, bool forwardCompatible, EShMessages);
     // Equivalent to parse() without a default profile and without forcing defaults.
     // Provided for backwards compatibility.
@@ -298,6 +350,15 @@ public:
     const char* getInfoLog();
     const char* getInfoDebugLog();
 
+    // After parse() or preprocess(), the paths of the files brought in through
+    // #include, in order of first inclusion, e.g., for a build system's dependencies.
+    const std::vector<std::string>& getIncludedFiles() const;
+
+    // After parse() or preprocess(), how many #include directives were processed,
+    // whether or not they found their file.  When nonzero, the results depend on
+    // more than the shader's own strings.
+    int getNumIncludeDirectives() const;
+
     EShLanguage getStage() const { return stage; }
 
 protected:
@@ -316,6 +377,7 @@ protected:
     const int* lengths;
     const char* preamble;
     int numStrings;
+    Includer* includer;
 
     friend class TProgram;
 
@@ -329,6 +391,9 @@ class TReflection;
 // the shaders that are to be linked together.  After calling shader.parse()
 // for all shaders, call link().
 //
+// Alternatively, add all the shaders unparsed and call parseShaders(), which
+// parses them all concurrently, each on its own thread, and then call link().
+//
 // N.B.: Destruct a linked program *before* destructing the shaders linked into it.
 //
 class TProgram {
@@ -337,6 +402,10 @@ public:
     virtual ~TProgram();
     void addShader(TShader* shader) { stages[shader->stage].push_back(shader); }
 
+    // Parse all added shaders concurrently, as if calling parse() on each of them;
+    // returns false if any failed, with the details in each shader's info log
+    bool parseShaders(const TBuiltInResource*, int defaultVersion, EProfile defaultProfile, bool forceDefaultVersionAndProfile, bool forwardCompatible, EShMessages);
+
     // Link Validation interface
     bool link(EShMessages);
     const char* getInfoLog();
@@ -357,6 +426,7 @@ public:
     int getUniformBufferOffset(int index);           // can be used for glGetActiveUniformsiv(GL_UNIFORM_OFFSET)
     int getUniformArraySize(int index);              // can be used for glGetActiveUniformsiv(GL_UNIFORM_SIZE)
     void dumpReflection();
+    void dumpReflection(std::string& text);          // appends what dumpReflection() prints, e.g., for caching it
 
 protected:
     bool linkStage(EShLanguage, EShMessages);